@@ -0,0 +1,55 @@
+#include "BenchGame.h"
+
+#include <Registry/VoxelObjectRegistry.h>
+
+#include "World/RegisterVoxels.h"
+
+void BenchGame::OnInitialize() { }
+
+void BenchGame::OnShutdown() { }
+
+void BenchGame::Update(float deltaTime) { }
+
+void BenchGame::FixedUpdate(float fixedDeltaTime) { }
+
+void BenchGame::VoxelUpdate(float deltaTime) { }
+
+void BenchGame::Render(glm::mat4 voxelProjection, glm::mat4 viewProjection) { }
+
+void BenchGame::RegisterVoxels()
+{
+    Registry::RegisterGameVoxels();
+}
+
+void BenchGame::RegisterVoxelObjects()
+{
+    using namespace Registry;
+
+    VoxelObjectRegistry::RegisterVoxelObject(
+        "Barrel",
+        VoxelObjectBuilder(VoxelObjectType::PhysicsObject)
+            .SetDensityOverride(400.0f)
+            .SetVoxelFilePathName("Textures/Objects/Barrel")
+            .Build()
+    );
+}
+
+void BenchGame::OnMouseScroll(int yOffset) { }
+void BenchGame::OnMouseButtonDown(int button) { }
+void BenchGame::OnMouseButtonUp(int button) { }
+void BenchGame::OnMouseMove(int x, int y) { }
+void BenchGame::OnKeyboardDown(int key) { }
+void BenchGame::OnKeyboardUp(int key) { }
+
+void BenchGame::OnWindowResize(int newX, int newY) { }
+
+void BenchGame::OnSceneChange(ChunkMatrix* oldMatrix, ChunkMatrix* newMatrix)
+{
+    // the chunk matrix does not own its objects, the barrels of the last scenario would keep their physics bodies
+    for(VoxelObject *object : oldMatrix->voxelObjects)
+        delete object;
+    oldMatrix->voxelObjects.clear();
+    oldMatrix->physicsObjects.clear();
+
+    delete oldMatrix;
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <GameEngine.h>
+
+/// @brief Registers the game materials and objects, everything else is driven by the scenarios
+class BenchGame : public IGame {
+public:
+    ~BenchGame() override = default;
+private:
+    void OnInitialize() override;
+    void OnShutdown() override;
+    void Update(float deltaTime) override;
+    void FixedUpdate(float fixedDeltaTime) override;
+    void VoxelUpdate(float deltaTime) override;
+    void Render(glm::mat4 voxelProjection, glm::mat4 viewProjection) override;
+
+    void RegisterVoxels() override;
+    void RegisterVoxelObjects() override;
+
+    void OnMouseScroll(int yOffset) override;
+    void OnMouseButtonDown(int button) override;
+    void OnMouseButtonUp(int button) override;
+    void OnMouseMove(int x, int y) override;
+    void OnKeyboardDown(int key) override;
+    void OnKeyboardUp(int key) override;
+
+    void OnWindowResize(int newX, int newY) override;
+
+    void OnSceneChange(ChunkMatrix* oldMatrix, ChunkMatrix* newMatrix) override;
+};
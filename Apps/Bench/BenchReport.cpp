@@ -0,0 +1,106 @@
+#include "BenchReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <numeric>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace Bench;
+
+void ScenarioResult::AddPhases(Debug::ProfileTrack track, const Debug::ProfileFrame &frame)
+{
+    for(const Debug::ProfileScopeRecord &scope : frame.scopes){
+        if(scope.depth != 0) continue;
+
+        std::string name = std::string(Debug::Profiler::GetTrackName(track)) + "/" + scope.name;
+        auto phase = std::find_if(phaseTotals.begin(), phaseTotals.end(), [&name](const auto &entry) { return entry.first == name; });
+        if(phase == phaseTotals.end()){
+            phaseTotals.emplace_back(name, 0.0);
+            phase = phaseTotals.end() - 1;
+        }
+        phase->second += scope.duration / 1'000'000.0;
+    }
+}
+
+double ScenarioResult::GetTotalSeconds() const
+{
+    return std::accumulate(tickTimes.begin(), tickTimes.end(), 0.0) / 1000.0;
+}
+
+double ScenarioResult::GetPercentile(double percentile) const
+{
+    if(tickTimes.empty()) return 0;
+
+    std::vector<double> sorted = tickTimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sorted.size()));
+    return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+}
+
+void BenchRun::WriteJson(std::ostream &out) const
+{
+    out << std::fixed << std::setprecision(4);
+    out << "{\n";
+    out << "  \"seed\": " << seed << ",\n";
+    out << "  \"deterministic\": " << (deterministic ? "true" : "false") << ",\n";
+    out << "  \"ticks\": " << ticks << ",\n";
+    out << "  \"warmupTicks\": " << warmupTicks << ",\n";
+    out << "  \"scenarios\": [";
+
+    for(size_t i = 0; i < results.size(); ++i){
+        const ScenarioResult &result = results[i];
+        const double totalSeconds = result.GetTotalSeconds();
+        const double tickCount = static_cast<double>(std::max<size_t>(result.tickTimes.size(), 1));
+
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"name\": \"" << result.name << "\",\n";
+        out << "      \"ticks\": " << result.tickTimes.size() << ",\n";
+        out << "      \"totalSeconds\": " << totalSeconds << ",\n";
+        out << "      \"ticksPerSecond\": " << (totalSeconds > 0 ? result.tickTimes.size() / totalSeconds : 0.0) << ",\n";
+        out << "      \"tickMs\": { "
+            << "\"mean\": " << totalSeconds * 1000.0 / tickCount << ", "
+            << "\"p50\": " << result.GetPercentile(50) << ", "
+            << "\"p99\": " << result.GetPercentile(99) << ", "
+            << "\"max\": " << result.GetPercentile(100) << " },\n";
+        out << "      \"phaseMs\": {";
+        for(size_t phase = 0; phase < result.phaseTotals.size(); ++phase){
+            out << (phase == 0 ? "\n" : ",\n");
+            out << "        \"" << result.phaseTotals[phase].first << "\": " << result.phaseTotals[phase].second / tickCount;
+        }
+        out << "\n      },\n";
+        out << "      \"peakRssBytes\": " << result.peakRSS;
+        if(deterministic)
+            out << ",\n      \"checksum\": \"" << std::hex << std::setw(16) << std::setfill('0') << result.checksum << std::dec << std::setfill(' ') << "\"";
+        out << "\n    }";
+    }
+
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+uint64_t Bench::GetPeakRSS()
+{
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if(!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+    return static_cast<uint64_t>(counters.PeakWorkingSetSize);
+#else
+    struct rusage usage;
+    if(getrusage(RUSAGE_SELF, &usage) != 0) return 0;
+#ifdef __APPLE__
+    return static_cast<uint64_t>(usage.ru_maxrss);          // bytes
+#else
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;   // kilobytes
+#endif
+#endif
+}
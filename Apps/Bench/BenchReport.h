@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <Debug/Profiler.h>
+
+namespace Bench {
+    /// @brief Collected timings of one scenario run
+    struct ScenarioResult {
+        std::string name;
+        std::vector<double> tickTimes;      // milliseconds, one entry per measured tick
+        // "<track>/<scope>" -> milliseconds summed over all measured ticks, in the order the phases first ran
+        std::vector<std::pair<std::string, double>> phaseTotals;
+        uint64_t peakRSS = 0;               // bytes, high water mark of the whole process
+        uint64_t checksum = 0;              // rolling world checksum, only with deterministic runs
+
+        /// @brief Adds the top level scopes of a profiled frame to the phase totals
+        void AddPhases(Debug::ProfileTrack track, const Debug::ProfileFrame &frame);
+        double GetTotalSeconds() const;
+        /// @param percentile 0-100, nearest rank
+        double GetPercentile(double percentile) const;
+    };
+
+    struct BenchRun {
+        uint64_t seed = 0;
+        bool deterministic = false;
+        uint32_t ticks = 0;
+        uint32_t warmupTicks = 0;
+        std::vector<ScenarioResult> results;
+
+        void WriteJson(std::ostream &out) const;
+    };
+
+    /// @return peak resident set size of the process in bytes, 0 if unknown
+    uint64_t GetPeakRSS();
+}
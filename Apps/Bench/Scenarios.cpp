@@ -0,0 +1,160 @@
+#include "Scenarios.h"
+
+#include <GameEngine.h>
+#include <Registry/VoxelObjectRegistry.h>
+
+#include "World/Materials.h"
+
+using namespace Volume;
+
+namespace {
+    constexpr int WORLD_LEFT = Bench::WORLD_FIRST_CHUNK * Chunk::CHUNK_SIZE;
+    constexpr int WORLD_RIGHT = (Bench::WORLD_FIRST_CHUNK + Bench::WORLD_WIDTH_CHUNKS) * Chunk::CHUNK_SIZE - 1;
+    constexpr int WORLD_TOP = Bench::WORLD_FIRST_CHUNK * Chunk::CHUNK_SIZE;
+    constexpr int FLOOR_CHUNK_Y = Bench::WORLD_FIRST_CHUNK + Bench::WORLD_HEIGHT_CHUNKS - 1;
+    constexpr int FLOOR_Y = FLOOR_CHUNK_Y * Chunk::CHUNK_SIZE; // first stone row
+
+    constexpr float SOLID_AMOUNT = 20;
+    constexpr float GAS_AMOUNT = 1;
+
+    /// @brief Places `material` in the inclusive rectangle, replacing whatever was there
+    void FillRect(ChunkMatrix &matrix, Vec2i min, Vec2i max, MaterialID material, float amount,
+        bool unmovable = false, Temperature temperature = Temperature(21))
+    {
+        for(int y = min.y; y <= max.y; ++y)
+            for(int x = min.x; x <= max.x; ++x)
+                matrix.PlaceVoxelAt(Vec2i(x, y), material, temperature, unmovable, amount, true);
+    }
+
+    void SetupSandAvalanche(ChunkMatrix &matrix)
+    {
+        // a steep block of sand that collapses into a pile
+        FillRect(matrix, Vec2i(WORLD_LEFT + 96, WORLD_TOP + 16), Vec2i(WORLD_RIGHT - 96, WORLD_TOP + 176), Materials::Sand, SOLID_AMOUNT);
+    }
+
+    void SetupWaterColumn(ChunkMatrix &matrix)
+    {
+        const int center = (WORLD_LEFT + WORLD_RIGHT) / 2;
+        FillRect(matrix, Vec2i(center - 32, WORLD_TOP + 8), Vec2i(center + 32, FLOOR_Y - 1), Materials::Water, SOLID_AMOUNT);
+    }
+
+    void SetupGasMixing(ChunkMatrix &matrix)
+    {
+        const int left = WORLD_LEFT + 32;
+        const int right = WORLD_RIGHT - 32;
+        const int top = WORLD_TOP + 32;
+        const int center = (left + right) / 2;
+
+        // closed stone chamber, heavy CO2 on the left and hot steam on the right
+        FillRect(matrix, Vec2i(left, top), Vec2i(right, top + 3), Materials::Stone, SOLID_AMOUNT, true);
+        FillRect(matrix, Vec2i(left, top), Vec2i(left + 3, FLOOR_Y - 1), Materials::Stone, SOLID_AMOUNT, true);
+        FillRect(matrix, Vec2i(right - 3, top), Vec2i(right, FLOOR_Y - 1), Materials::Stone, SOLID_AMOUNT, true);
+
+        FillRect(matrix, Vec2i(left + 4, top + 4), Vec2i(center, FLOOR_Y - 1), Materials::CarbonDioxide, GAS_AMOUNT);
+        FillRect(matrix, Vec2i(center + 1, top + 4), Vec2i(right - 4, FLOOR_Y - 1), Materials::Steam, GAS_AMOUNT, false, Temperature(120));
+    }
+
+    void SetupForestFire(ChunkMatrix &matrix)
+    {
+        constexpr int TREE_SPACING = 32;
+        constexpr int TRUNK_HEIGHT = 64;
+        constexpr int CROWN_RADIUS = 12;
+
+        // grass covered ground with a row of trees, lit at the leftmost tree
+        FillRect(matrix, Vec2i(WORLD_LEFT, FLOOR_Y - 4), Vec2i(WORLD_RIGHT, FLOOR_Y - 1), Materials::Grass, SOLID_AMOUNT, true);
+
+        for(int x = WORLD_LEFT + 16; x + CROWN_RADIUS <= WORLD_RIGHT; x += TREE_SPACING){
+            const int crownY = FLOOR_Y - 4 - TRUNK_HEIGHT;
+            FillRect(matrix, Vec2i(x - 1, crownY), Vec2i(x + 2, FLOOR_Y - 5), Materials::Wood, SOLID_AMOUNT, true);
+            FillRect(matrix, Vec2i(x - CROWN_RADIUS, crownY - CROWN_RADIUS), Vec2i(x + CROWN_RADIUS, crownY), Materials::Wood, SOLID_AMOUNT, true);
+        }
+
+        for(int y = FLOOR_Y - 12; y < FLOOR_Y - 4; ++y)
+            matrix.SetFireAt(Vec2i(WORLD_LEFT + 16, y), Temperature(600));
+    }
+
+    void SetupExplosionChain(ChunkMatrix &matrix)
+    {
+        FillRect(matrix, Vec2i(WORLD_LEFT, FLOOR_Y - 160), Vec2i(WORLD_RIGHT, FLOOR_Y - 1), Materials::Dirt, SOLID_AMOUNT, true);
+    }
+
+    void ExplosionChainTick(ChunkMatrix &matrix, uint64_t tick)
+    {
+        constexpr uint64_t TICKS_BETWEEN_EXPLOSIONS = 10;
+        constexpr int EXPLOSION_SPACING = 40;
+        constexpr short int EXPLOSION_RADIUS = 24;
+
+        if(tick % TICKS_BETWEEN_EXPLOSIONS != 0) return;
+
+        // walks along the dirt and starts over at the left side
+        const int explosionCount = (WORLD_RIGHT - WORLD_LEFT - 2 * EXPLOSION_RADIUS) / EXPLOSION_SPACING;
+        const int index = static_cast<int>((tick / TICKS_BETWEEN_EXPLOSIONS) % explosionCount);
+        const int depth = static_cast<int>((tick / TICKS_BETWEEN_EXPLOSIONS / explosionCount) % 4);
+
+        matrix.ExplodeAt(
+            Vec2i(WORLD_LEFT + EXPLOSION_RADIUS + index * EXPLOSION_SPACING, FLOOR_Y - 150 + depth * EXPLOSION_RADIUS),
+            EXPLOSION_RADIUS
+        );
+    }
+
+    void SetupFallingBarrels(ChunkMatrix &matrix)
+    {
+        constexpr int COLUMNS = 20;
+        constexpr int ROWS = 10;
+
+        FillRect(matrix, Vec2i(WORLD_LEFT, FLOOR_Y - 4), Vec2i(WORLD_RIGHT, FLOOR_Y - 1), Materials::Dirt, SOLID_AMOUNT, true);
+
+        for(int row = 0; row < ROWS; ++row){
+            for(int column = 0; column < COLUMNS; ++column){
+                // odd rows are shifted so the barrels land on each other
+                Vec2f position(
+                    WORLD_LEFT + 24.0f + column * 24.0f + (row % 2) * 12.0f,
+                    WORLD_TOP + 16.0f + row * 20.0f
+                );
+                Registry::CreateVoxelObject("Barrel", position, &matrix, GameEngine::physics);
+            }
+        }
+    }
+
+    const std::vector<Bench::Scenario> scenarios = {
+        { "sand_avalanche",  "a 320x160 block of sand collapsing into a pile",      SetupSandAvalanche,  nullptr },
+        { "water_column",    "a full height water column flooding the floor",       SetupWaterColumn,    nullptr },
+        { "gas_mixing",      "CO2 and hot steam mixing inside a closed chamber",    SetupGasMixing,      nullptr },
+        { "forest_fire",     "fire spreading over grass and a row of wooden trees", SetupForestFire,     nullptr },
+        { "explosion_chain", "an explosion every 10 ticks walking through dirt",    SetupExplosionChain, ExplosionChainTick },
+        { "falling_barrels", "200 barrel physics objects falling onto the ground",  SetupFallingBarrels, nullptr },
+    };
+}
+
+const std::vector<Bench::Scenario> &Bench::GetScenarios()
+{
+    return scenarios;
+}
+
+const Bench::Scenario *Bench::FindScenario(const std::string &name)
+{
+    for(const Scenario &scenario : scenarios)
+        if(scenario.name == name) return &scenario;
+    return nullptr;
+}
+
+Chunk *Bench::GenerateChunk(const Vec2i &chunkPos, ChunkMatrix &matrix)
+{
+    Chunk *chunk = new Chunk(chunkPos);
+
+    const bool isFloor = chunkPos.y >= FLOOR_CHUNK_Y;
+    // both materials use default constructors, so the chunk is always stored compressed
+    if(isFloor)
+        chunk->FillUniform(Materials::Stone, Temperature(21), SOLID_AMOUNT, true);
+    else
+        chunk->FillUniform(Materials::Oxygen, Temperature(21), GAS_AMOUNT, false);
+
+    return chunk;
+}
+
+void Bench::LoadWorld(ChunkMatrix &matrix)
+{
+    for(int y = WORLD_FIRST_CHUNK; y < WORLD_FIRST_CHUNK + WORLD_HEIGHT_CHUNKS; ++y)
+        for(int x = WORLD_FIRST_CHUNK; x < WORLD_FIRST_CHUNK + WORLD_WIDTH_CHUNKS; ++x)
+            matrix.GenerateChunk(Vec2i(x, y));
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <World/ChunkMatrix.h>
+
+namespace Bench {
+    struct Scenario {
+        std::string name;
+        std::string description;
+        /// @brief Fills the freshly loaded bench world (see `Bench::LoadWorld`)
+        void (*Setup)(ChunkMatrix &matrix);
+        /// @brief Runs before every tick (warm-up ticks included), may be nullptr
+        void (*OnTick)(ChunkMatrix &matrix, uint64_t tick);
+    };
+
+    const std::vector<Scenario>& GetScenarios();
+    const Scenario* FindScenario(const std::string &name);
+
+    // the bench world is a closed box of chunks, nothing is loaded or unloaded while a scenario runs
+    constexpr int WORLD_FIRST_CHUNK = 1;
+    constexpr int WORLD_WIDTH_CHUNKS = 8;
+    constexpr int WORLD_HEIGHT_CHUNKS = 6;  // the last row is the stone floor
+
+    Volume::Chunk* GenerateChunk(const Vec2i &chunkPos, ChunkMatrix &matrix);
+    /// @brief Synchronously generates every chunk of the bench world
+    void LoadWorld(ChunkMatrix &matrix);
+}
@@ -0,0 +1,162 @@
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "BenchGame.h"
+#include "BenchReport.h"
+#include "Scenarios.h"
+
+// Headless scenario benchmarks of the voxel simulation, results are written as JSON
+//
+// VoxaBench [--scenario <name>]... [--ticks <count>] [--warmup <count>] [--seed <seed>] [--deterministic] [--output <file>]
+// VoxaBench --list
+
+namespace {
+    void PrintUsage()
+    {
+        std::cout << "Usage:\n"
+                  << "  VoxaBench [--scenario <name>]... [--ticks <count>] [--warmup <count>] [--seed <seed>] [--deterministic] [--output <file>]\n"
+                  << "  VoxaBench --list\n";
+    }
+
+    void PrintScenarios()
+    {
+        for(const Bench::Scenario &scenario : Bench::GetScenarios())
+            std::cout << "  " << scenario.name << " - " << scenario.description << "\n";
+    }
+
+    /// @brief Replaces the world with a fresh bench world, so every scenario starts from tick 0
+    ChunkMatrix *ResetWorld(GameEngine &engine, uint64_t seed)
+    {
+        ChunkMatrix *matrix = new ChunkMatrix();
+        matrix->ChunkGeneratorFunction = Bench::GenerateChunk;
+        // same random streams on every run, even when the voxel updates run in parallel
+        matrix->simulationSeed = seed;
+
+        // the matrix is swapped in during the next frame
+        engine.SetActiveChunkMatrix(matrix);
+        engine.Tick();
+        matrix->simulationTick = 0;
+        matrix->rollingChecksum = 0;
+
+        Bench::LoadWorld(*matrix);
+        return matrix;
+    }
+
+    Bench::ScenarioResult RunScenario(GameEngine &engine, const Bench::Scenario &scenario, const Bench::BenchRun &run)
+    {
+        Bench::ScenarioResult result;
+        result.name = scenario.name;
+        result.tickTimes.reserve(run.ticks);
+
+        ChunkMatrix *matrix = ResetWorld(engine, run.seed);
+        scenario.Setup(*matrix);
+
+        for(uint32_t tick = 0; tick < run.warmupTicks + run.ticks; ++tick){
+            if(scenario.OnTick) scenario.OnTick(*matrix, tick);
+
+            auto start = std::chrono::steady_clock::now();
+            engine.Tick();
+            auto end = std::chrono::steady_clock::now();
+
+            if(tick < run.warmupTicks) continue;
+            result.tickTimes.push_back(std::chrono::duration<double, std::milli>(end - start).count());
+
+            // every tick ends exactly one frame on each track
+            Debug::ProfileFrame frame;
+            for(Debug::ProfileTrack track : { Debug::ProfileTrack::Main, Debug::ProfileTrack::Simulation }){
+                if(Debug::Profiler::GetLastFrame(track, frame))
+                    result.AddPhases(track, frame);
+            }
+        }
+
+        result.peakRSS = Bench::GetPeakRSS();
+        result.checksum = matrix->rollingChecksum;
+        return result;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    Debug::Logger::Instance().minLogLevel = Debug::Logger::Level::WARN;
+
+    Bench::BenchRun run;
+    run.seed = 1;
+    run.ticks = 600;
+    run.warmupTicks = 30;
+    std::vector<std::string> scenarioNames;
+    std::string outputPath;
+
+    for(int i = 1; i < argc; ++i){
+        std::string argument = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if(argument == "--list"){
+            PrintScenarios();
+            return 0;
+        }
+        else if(argument == "--deterministic") run.deterministic = true;
+        else if(argument == "--scenario" && hasValue) scenarioNames.push_back(argv[++i]);
+        else if(argument == "--ticks" && hasValue) run.ticks = std::stoul(argv[++i]);
+        else if(argument == "--warmup" && hasValue) run.warmupTicks = std::stoul(argv[++i]);
+        else if(argument == "--seed" && hasValue) run.seed = std::stoull(argv[++i]);
+        else if(argument == "--output" && hasValue) outputPath = argv[++i];
+        else{
+            PrintUsage();
+            return 1;
+        }
+    }
+
+    std::vector<const Bench::Scenario*> scenarios;
+    if(scenarioNames.empty()){
+        for(const Bench::Scenario &scenario : Bench::GetScenarios())
+            scenarios.push_back(&scenario);
+    }
+    for(const std::string &name : scenarioNames){
+        const Bench::Scenario *scenario = Bench::FindScenario(name);
+        if(!scenario){
+            std::cerr << "Unknown scenario: " << name << "\n";
+            PrintScenarios();
+            return 1;
+        }
+        scenarios.push_back(scenario);
+    }
+
+    Config::EngineConfig config;
+    config.headless = true;
+    config.vsync = false;
+    // the bench world is fixed, nothing may load in the background while measuring
+    config.automaticLoadingOfChunksInView = false;
+    config.automaticLoadingOfChunksFromEvents = false;
+    config.simulationSeed = run.seed;
+    config.deterministicSimulation = run.deterministic;
+    config.worldChecksums = run.deterministic;
+
+    // the per-phase breakdown comes from the profiler scopes
+    Debug::Profiler::SetEnabled(true);
+
+    GameEngine engine;
+    BenchGame game;
+    engine.Start(game, config);
+
+    for(const Bench::Scenario *scenario : scenarios){
+        std::cerr << "Running " << scenario->name << "...\n";
+        run.results.push_back(RunScenario(engine, *scenario, run));
+    }
+
+    if(outputPath.empty()){
+        run.WriteJson(std::cout);
+        return 0;
+    }
+
+    std::ofstream output(outputPath);
+    if(!output){
+        std::cerr << "Could not open " << outputPath << "\n";
+        return 1;
+    }
+    run.WriteJson(output);
+
+    return 0;
+}
@@ -1,5 +1,7 @@
 #include "Editor.h"
 
+#include <shared_mutex>
+
 #include <Registry/VoxelObjectRegistry.h>
 
 #include "Generation/ChunkGenerator.h"
@@ -76,6 +78,14 @@ void Editor::Update(float deltaTime)
     this->cameraPosition += movementVector * deltaTime * 50.0f;
     GameEngine::renderer->SetCameraPosition(this->cameraPosition);
 
+    if(!Input::mouseData.leftButtonDown && !Input::mouseData.rightButtonDown) return;
+
+    // only the chunks under the brush, the voxel simulation keeps running everywhere else
+    ChunkMatrix *chunkMatrix = GameEngine::instance->GetActiveChunkMatrix();
+    std::shared_lock<Debug::TracedSharedMutex> lock(chunkMatrix->voxelMutex);
+    Vec2f worldMousePos = ChunkMatrix::MousePosToWorldPos(GameEngine::instance->GetMousePos(), GameEngine::renderer->GetCameraOffset());
+    Volume::ChunkLockGuard chunkLocks = chunkMatrix->LockChunksAround(Vec2i(worldMousePos), Input::mouseData.brushRadius);
+
     if(Input::mouseData.leftButtonDown)
     {
         std::string voxelID = "Solid";
@@ -7,7 +7,7 @@ Volume::Chunk *Generator::GenerateEmptyChunk(const Vec2i &pos, ChunkMatrix &matr
     for(int x = 0; x < Volume::Chunk::CHUNK_SIZE; ++x){
         for(int y = 0; y < Volume::Chunk::CHUNK_SIZE; ++y){
             chunk->voxels[y][x] = CreateVoxelElement(
-                "Empty",
+                Volume::Materials::Empty,
                 Vec2i(
                     x + pos.x * Volume::Chunk::CHUNK_SIZE, 
                     y + pos.y * Volume::Chunk::CHUNK_SIZE
@@ -29,7 +29,7 @@ Volume::Chunk *Generator::GenerateOxygenFilledChunk(const Vec2i &pos, ChunkMatri
     for(int x = 0; x < Volume::Chunk::CHUNK_SIZE; ++x){
         for(int y = 0; y < Volume::Chunk::CHUNK_SIZE; ++y){
             chunk->voxels[y][x] = CreateVoxelElement(
-                "Oxygen",
+                Volume::Materials::Oxygen,
                 Vec2i(
                     x + pos.x * Volume::Chunk::CHUNK_SIZE, 
                     y + pos.y * Volume::Chunk::CHUNK_SIZE
@@ -28,6 +28,8 @@ void ObjLoader::InsertVoxelsFromFileIntoScene(const std::string &filePath, Edito
     Vec2f newObjCorner = sceneAABB.GetCenter() - (boundingBox.size / 2.0f) + Vec2i(Volume::Chunk::CHUNK_SIZE, Volume::Chunk::CHUNK_SIZE);
     boundingBox.corner = newObjCorner;
 
+    const Volume::MaterialID solidID = Registry::VoxelRegistry::GetMaterialID("Solid");
+
     for(size_t y = 0; y < voxelData.size(); y++) {
         for(size_t x = 0; x < voxelData[y].size(); x++) {
             const Registry::VoxelData &voxel = voxelData[y][x];
@@ -38,7 +40,7 @@ void ObjLoader::InsertVoxelsFromFileIntoScene(const std::string &filePath, Edito
 
             Volume::VoxelElement *voxelElement = scene->chunkMatrix->PlaceVoxelAt(
                 voxelPos,
-                "Solid",
+                solidID,
                 Volume::Temperature(21.0f),
                 true,
                 1.0f,
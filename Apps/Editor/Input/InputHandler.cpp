@@ -31,8 +31,7 @@ void Input::OnKeyboardUp(int key)
 }
 void Input::OnMouseButtonDown(int button)
 {
-    GameEngine::instance->GetActiveChunkMatrix()->voxelMutex.lock();
-
+    // only the button state, the brush edits the voxels in Editor::Update under chunk locks
     if(button == SDL_BUTTON_LEFT)
         mouseData.leftButtonDown = true;
     if(button == SDL_BUTTON_RIGHT)
@@ -47,8 +46,6 @@ void Input::OnMouseButtonDown(int button)
         mouseData.rightButtonDown = true;
         break;
     }
-
-    GameEngine::instance->GetActiveChunkMatrix()->voxelMutex.unlock();
 }
 void Input::OnMouseButtonUp(int button)
 {
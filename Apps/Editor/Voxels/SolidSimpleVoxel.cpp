@@ -1,6 +1,6 @@
 #include "SolidSimpleVoxel.h"
 
-Volume::SolidSimpleVoxel::SolidSimpleVoxel(std::string id, Vec2i position, Temperature temp, float amount)
+Volume::SolidSimpleVoxel::SolidSimpleVoxel(MaterialID id, Vec2i position, Temperature temp, float amount)
     : VoxelElement(id, position, temp, amount)
 {
 }
\ No newline at end of file
@@ -7,7 +7,7 @@ namespace Volume{
 	{
 	public:
         SolidSimpleVoxel() = default;
-		SolidSimpleVoxel(std::string id, Vec2i position, Temperature temp, float amount);
+		SolidSimpleVoxel(MaterialID id, Vec2i position, Temperature temp, float amount);
 
         State GetState() const override { return State::Solid; };
 
@@ -1,6 +1,7 @@
 #include "Input/InputHandler.h"
 
 #include <algorithm>
+#include <shared_mutex>
 
 #include <SDL_keycode.h>
 #include <GameEngine.h>
@@ -10,6 +11,9 @@
 
 Input::MouseData Input::mouseData = {};
 
+// right click explosion, its rays reach 1.5 times as far
+static constexpr short int EXPLOSION_RADIUS = 15;
+
 void Input::OnMouseScroll(int yOffset)
 {
     mouseData.placementRadius += yOffset;
@@ -46,7 +50,17 @@ void Input::OnKeyboardUp(int key)
 }
 void Input::OnMouseButtonDown(int button)
 {
-    GameEngine::instance->GetActiveChunkMatrix()->voxelMutex.lock();
+    ChunkMatrix *chunkMatrix = GameEngine::instance->GetActiveChunkMatrix();
+    std::shared_lock<Debug::TracedSharedMutex> lock(chunkMatrix->voxelMutex);
+
+    // only the chunks under the brush, the voxel simulation keeps running everywhere else.
+    // AddParticle and the Box2D explosion below are fine under the shared lock only because this runs on the main thread
+    Vec2f worldMousePos = ChunkMatrix::MousePosToWorldPos(
+        GameEngine::instance->GetMousePos(),
+        GameEngine::renderer->GetCameraOffset()
+    );
+    int reach = button == SDL_BUTTON_RIGHT ? EXPLOSION_RADIUS * 2 : mouseData.placementRadius;
+    Volume::ChunkLockGuard chunkLocks = chunkMatrix->LockChunksAround(Vec2i(worldMousePos), reach);
 
     switch (button)
     {
@@ -70,13 +84,11 @@ void Input::OnMouseButtonDown(int button)
     case SDL_BUTTON_RIGHT:
         GameEngine::instance->GetActiveChunkMatrix()->ExplodeAtMousePosition(
             GameEngine::instance->GetMousePos(),
-            15,
+            EXPLOSION_RADIUS,
             GameEngine::renderer->GetCameraOffset()
         );
         break;
     }
-
-    GameEngine::instance->GetActiveChunkMatrix()->voxelMutex.unlock();
 }
 void Input::OnMouseButtonUp(int button)
 {
@@ -6,10 +6,169 @@
 #include <imgui_impl_sdl2.h>
 #include <imgui_impl_opengl3.h>
 
+#include <Debug/Profiler.h>
+#include <Debug/Stats.h>
+
+#include <cfloat>
+#include <functional>
+#include <string_view>
+
 #include "Input/InputHandler.h"
 
 bool ImGuiRenderer::fullImGui = false;
 
+namespace {
+    constexpr float PROFILER_WIDTH = 480;
+    constexpr float FLAME_ROW_HEIGHT = 18;
+
+    struct ProfilerTrackView {
+        std::vector<Debug::ProfileFrame> frames;
+        int selectedFrame = -1; // -1 follows the newest frame
+    };
+
+    ImU32 ScopeColor(const char *name)
+    {
+        // the same scope keeps its color between frames
+        size_t hash = std::hash<std::string_view>{}(name);
+        float hue = (hash % 360) / 360.0f;
+        return ImColor::HSV(hue, 0.45f, 0.8f);
+    }
+
+    /// @brief Draws every scope of the frame as a bar, nested scopes are drawn below their parent
+    void RenderFlameGraph(const Debug::ProfileFrame &frame)
+    {
+        uint16_t maxDepth = 0;
+        for(const Debug::ProfileScopeRecord &scope : frame.scopes)
+            maxDepth = std::max(maxDepth, scope.depth);
+
+        const ImVec2 origin = ImGui::GetCursorScreenPos();
+        const float height = (maxDepth + 1) * FLAME_ROW_HEIGHT;
+        ImGui::InvisibleButton("##flame", ImVec2(PROFILER_WIDTH, height));
+        const bool hovered = ImGui::IsItemHovered();
+        const ImVec2 mouse = ImGui::GetIO().MousePos;
+
+        ImDrawList *drawList = ImGui::GetWindowDrawList();
+        drawList->AddRectFilled(origin, ImVec2(origin.x + PROFILER_WIDTH, origin.y + height), IM_COL32(30, 30, 30, 255));
+
+        const double scale = PROFILER_WIDTH / static_cast<double>(std::max<uint64_t>(frame.duration, 1));
+        for(const Debug::ProfileScopeRecord &scope : frame.scopes){
+            ImVec2 min(origin.x + static_cast<float>((scope.start - frame.start) * scale), origin.y + scope.depth * FLAME_ROW_HEIGHT);
+            ImVec2 max(min.x + std::max(static_cast<float>(scope.duration * scale), 1.0f), min.y + FLAME_ROW_HEIGHT - 1);
+
+            drawList->AddRectFilled(min, max, ScopeColor(scope.name));
+            if(ImGui::CalcTextSize(scope.name).x < max.x - min.x - 4)
+                drawList->AddText(ImVec2(min.x + 2, min.y + 2), IM_COL32(0, 0, 0, 255), scope.name);
+
+            if(hovered && mouse.x >= min.x && mouse.x < max.x && mouse.y >= min.y && mouse.y < max.y)
+                ImGui::SetTooltip("%s: %.3f ms", scope.name, scope.duration / 1'000'000.0);
+        }
+    }
+
+    void RenderProfilerTrack(Debug::ProfileTrack track, ProfilerTrackView &view, bool paused)
+    {
+        if(!paused) view.frames = Debug::Profiler::GetHistory(track);
+
+        ImGui::PushID(static_cast<int>(track));
+        ImGui::SeparatorText(Debug::Profiler::GetTrackName(track));
+
+        if(view.frames.empty()){
+            ImGui::Text("No frames recorded");
+            ImGui::PopID();
+            return;
+        }
+
+        std::vector<float> frameTimes(view.frames.size());
+        for(size_t i = 0; i < view.frames.size(); ++i)
+            frameTimes[i] = view.frames[i].GetMilliseconds();
+
+        int selected = view.selectedFrame;
+        if(selected < 0 || selected >= static_cast<int>(view.frames.size()))
+            selected = static_cast<int>(view.frames.size()) - 1;
+
+        ImGui::PlotHistogram("##history", frameTimes.data(), static_cast<int>(frameTimes.size()), 0, 
+            nullptr, 0.0f, FLT_MAX, ImVec2(PROFILER_WIDTH, 50));
+        // pick a frame from the history, right click goes back to the newest one
+        if(ImGui::IsItemHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Left)){
+            float position = (ImGui::GetIO().MousePos.x - ImGui::GetItemRectMin().x) / ImGui::GetItemRectSize().x;
+            view.selectedFrame = std::clamp(static_cast<int>(position * frameTimes.size()), 0, static_cast<int>(frameTimes.size()) - 1);
+        }
+        if(ImGui::IsItemHovered() && ImGui::IsMouseClicked(ImGuiMouseButton_Right))
+            view.selectedFrame = -1;
+
+        ImGui::Text("Frame %d/%d: %.3f ms", selected + 1, static_cast<int>(frameTimes.size()), frameTimes[selected]);
+        RenderFlameGraph(view.frames[selected]);
+
+        ImGui::PopID();
+    }
+
+    void RenderProfiler()
+    {
+        static ProfilerTrackView trackViews[static_cast<size_t>(Debug::ProfileTrack::COUNT)];
+        static bool paused = false;
+
+        bool enabled = Debug::Profiler::IsEnabled();
+        if(ImGui::Checkbox("Enabled", &enabled)) Debug::Profiler::SetEnabled(enabled);
+        ImGui::SameLine();
+        ImGui::Checkbox("Pause", &paused);
+        ImGui::SameLine();
+        if(ImGui::Button("Clear")){
+            Debug::Profiler::ClearHistory();
+            for(ProfilerTrackView &view : trackViews) view = ProfilerTrackView();
+        }
+
+        for(size_t i = 0; i < static_cast<size_t>(Debug::ProfileTrack::COUNT); ++i)
+            RenderProfilerTrack(static_cast<Debug::ProfileTrack>(i), trackViews[i], paused);
+    }
+
+    void RenderStats()
+    {
+        int logInterval = static_cast<int>(Debug::Stats::GetLogInterval());
+        bool logJson = Debug::Stats::GetLogFormat() == Debug::StatsFormat::JSON;
+
+        ImGui::SetNextItemWidth(100);
+        bool changed = ImGui::DragInt("Log every N ticks (0 = off)", &logInterval, 1, 0, 6000);
+        changed |= ImGui::Checkbox("JSON", &logJson);
+        if(changed)
+            Debug::Stats::SetLogInterval(static_cast<uint32_t>(std::max(logInterval, 0)), logJson ? Debug::StatsFormat::JSON : Debug::StatsFormat::CSV);
+
+        std::vector<Debug::StatsSnapshot> history = Debug::Stats::GetHistory();
+        if(history.empty()){
+            ImGui::Text("No ticks recorded");
+            return;
+        }
+
+        if(!ImGui::BeginTable("##stats", 3)) return;
+        ImGui::TableSetupColumn("Counter");
+        ImGui::TableSetupColumn("Last tick");
+        ImGui::TableSetupColumn("Average");
+        ImGui::TableHeadersRow();
+
+        std::vector<float> values(history.size());
+        for(size_t counter = 0; counter < static_cast<size_t>(Debug::StatCounter::COUNT); ++counter){
+            double sum = 0;
+            for(size_t i = 0; i < history.size(); ++i){
+                values[i] = static_cast<float>(history[i].values[counter]);
+                sum += history[i].values[counter];
+            }
+
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            ImGui::TextUnformatted(Debug::Stats::GetName(static_cast<Debug::StatCounter>(counter)));
+            // the history of a counter shows up when hovering its name
+            if(ImGui::IsItemHovered()){
+                ImGui::BeginTooltip();
+                ImGui::PlotLines("##history", values.data(), static_cast<int>(values.size()), 0, nullptr, 0.0f, FLT_MAX, ImVec2(300, 60));
+                ImGui::EndTooltip();
+            }
+            ImGui::TableNextColumn();
+            ImGui::Text("%llu", static_cast<unsigned long long>(history.back().values[counter]));
+            ImGui::TableNextColumn();
+            ImGui::Text("%.1f", sum / history.size());
+        }
+        ImGui::EndTable();
+    }
+}
+
 void ImGuiRenderer::RenderDebugPanel()
 {
     constexpr int ITEM_WIDTH = 150;
@@ -78,8 +237,37 @@ void ImGuiRenderer::RenderDebugPanel()
     ImGui::SetNextItemWidth(ITEM_WIDTH);
     ImGui::DragFloat("CA sim speed", &GameEngine::instance->voxelFixedDeltaTime, 0.05f, 1/30.0, 4);
 
-    ImGui::Text("Loaded chunks: %lld", GameEngine::instance->GetActiveChunkMatrix()->Grid.size());
+    // the panel runs without the voxel mutex, every simulated chunk is either active or sleeping
+    Debug::StatsSnapshot lastTick;
+    Debug::Stats::GetLastTick(lastTick);
+    ImGui::Text("Loaded chunks: %llu", static_cast<unsigned long long>(
+        lastTick.Get(Debug::StatCounter::ChunksActive) + lastTick.Get(Debug::StatCounter::ChunksSleeping)));
+    ImGui::Text("Pending chunks: %lld", GameEngine::instance->GetActiveChunkMatrix()->GetPendingChunkCount());
+
+    const Volume::ChunkPrefetchStats &prefetchStats = GameEngine::renderer->GetChunkPrefetcher().GetStats();
+    ImGui::Text("Prefetch hits: %llu, misses: %llu (%.1f%%)", 
+        static_cast<unsigned long long>(prefetchStats.hits), static_cast<unsigned long long>(prefetchStats.misses), 
+        prefetchStats.GetHitRate() * 100.0f);
+    if(ImGui::Button("Reset prefetch stats")) GameEngine::renderer->GetChunkPrefetcher().ResetStats();
+
+    ChunkMatrix *chunkMatrix = GameEngine::instance->GetActiveChunkMatrix();
+    if(Volume::ChunkStore *chunkStore = chunkMatrix->GetChunkStore()){
+        if(ImGui::Button("Save world")){
+            // exclusive on purpose, chunk by chunk locks would let voxels cross between two saved chunks
+            std::lock_guard<Debug::TracedSharedMutex> lock(chunkMatrix->voxelMutex);
+            chunkMatrix->SaveWorld();
+        }
+        ImGui::SameLine();
+        if(ImGui::Button("Compact regions")) chunkStore->CompactRegions();
+    }
 
     ImGui::Checkbox("Player Gun", &Game::player->gunEnabled);
+
+    if(ImGui::CollapsingHeader("Profiler"))
+        RenderProfiler();
+
+    if(ImGui::CollapsingHeader("Statistics"))
+        RenderStats();
+
     ImGui::End();
 }
\ No newline at end of file
@@ -5,6 +5,7 @@
 #include <iostream>
 #include <cmath>
 #include <algorithm>
+#include <shared_mutex>
 
 Player::Player(ChunkMatrix *matrix, std::vector<std::vector<Registry::VoxelData>> &voxelData, float densityOverride)
     : PhysicsObject(
@@ -35,7 +36,9 @@ void Player::UpdatePlayer(ChunkMatrix& chunkMatrix, float deltaTime)
 {
     if(!b2Body_IsValid(m_physicsBody)) return;
 
-    chunkMatrix.voxelMutex.lock();
+    // ground and wall checks only read the voxels right around the player
+    std::shared_lock<Debug::TracedSharedMutex> lock(chunkMatrix.voxelMutex);
+    Volume::ChunkLockGuard chunkLocks = chunkMatrix.LockChunksInArea(this->GetBoundingBox().Expand(STEP_HEIGHT + 2));
 
     this->onGround = this->isOnGround(chunkMatrix);
 
@@ -109,8 +112,6 @@ void Player::UpdatePlayer(ChunkMatrix& chunkMatrix, float deltaTime)
     Vec2f direction = mousePos - (this->position);
     float angle = std::atan2(direction.y, direction.x);
     this->gunLaserParticleGenerator->angle = angle;
-
-    chunkMatrix.voxelMutex.unlock();
 }
 
 bool Player::Update(ChunkMatrix &chunkMatrix)
@@ -3,6 +3,8 @@
 #include <Math/Noise.h>
 #include <World/ChunkMatrix.h>
 
+#include "World/Materials.h"
+
 using namespace Volume;
 
 Chunk* ChunkGenerator::GenerateChunk(const Vec2i &chunkPos, ChunkMatrix &chunkMatrix){
@@ -14,11 +16,11 @@ Chunk* ChunkGenerator::GenerateChunk(const Vec2i &chunkPos, ChunkMatrix &chunkMa
     // some basic debug stuff
     if (chunkPos.y == 4 && chunkPos.x <= 3)
         if(chunkPos.x == 2)
-            return FillChunkWith("Water", false, chunk);
+            return FillChunkWith(Materials::Water, false, chunk);
         else
-            return FillChunkWith("Sand", false, chunk);
+            return FillChunkWith(Materials::Sand, false, chunk);
     else if (chunkPos.y < 5)
-        return FillChunkWith("Oxygen", false, chunk);
+        return FillChunkWith(Materials::Oxygen, false, chunk);
 
     ChunkBoolArray chunkData = GenerateArrayFromNoise(chunkPos, seed, chunkMatrix);
 
@@ -34,7 +36,7 @@ Chunk* ChunkGenerator::GenerateChunk(const Vec2i &chunkPos, ChunkMatrix &chunkMa
                 );
             }else{
                 chunk->voxels[y][x] = CreateVoxelElement(
-                    "Oxygen",
+                    Materials::Oxygen,
                     Vec2i(x + chunkPos.x * Chunk::CHUNK_SIZE, y + chunkPos.y * Chunk::CHUNK_SIZE),
                     1,
                     Temperature(21),
@@ -47,15 +49,19 @@ Chunk* ChunkGenerator::GenerateChunk(const Vec2i &chunkPos, ChunkMatrix &chunkMa
     return chunk;
 }
 
-Volume::Chunk *ChunkGenerator::FillChunkWith(std::string materialID, bool unmovable, Volume::Chunk *chunk)
+Volume::Chunk *ChunkGenerator::FillChunkWith(Volume::MaterialID materialID, bool unmovable, Volume::Chunk *chunk)
 {
     Volume::VoxelProperty *prop = Registry::VoxelRegistry::GetProperties(materialID);
     bool isGas = prop->Constructor == Registry::DefaultVoxelConstructor::GasVoxel;
+
+    // single material chunks don't need any voxels until something touches them
+    if(chunk->FillUniform(materialID, Temperature(21), isGas ? 1 : 20, unmovable))
+        return chunk;
+
     for (int x = 0; x < Chunk::CHUNK_SIZE; ++x) {
         for (int y = 0; y < Chunk::CHUNK_SIZE; ++y) {
             Volume::VoxelElement* voxel = CreateVoxelElement(
                 prop,
-                materialID,
                 Vec2i(x + chunk->GetPos().x * Chunk::CHUNK_SIZE, y + chunk->GetPos().y * Chunk::CHUNK_SIZE),
                 isGas ? 1 : 20,
                 Temperature(21),
@@ -67,14 +73,14 @@ Volume::Chunk *ChunkGenerator::FillChunkWith(std::string materialID, bool unmova
     return chunk;
 }
 
-std::string ChunkGenerator::GetMaterialAtYLevel(int yLevel, Random &gen)
+Volume::MaterialID ChunkGenerator::GetMaterialAtYLevel(int yLevel, Random &gen)
 {
-    if(yLevel < 380) return "Grass";
-    if(yLevel < 400) if(gen.GetInt(380, yLevel) < 390) return "Grass";
-    if(yLevel < 700) return "Dirt";
-    if(yLevel < 740) if(gen.GetInt(700, yLevel) < 720) return "Dirt";
+    if(yLevel < 380) return Materials::Grass;
+    if(yLevel < 400) if(gen.GetInt(380, yLevel) < 390) return Materials::Grass;
+    if(yLevel < 700) return Materials::Dirt;
+    if(yLevel < 740) if(gen.GetInt(700, yLevel) < 720) return Materials::Dirt;
 
-    return "Stone";
+    return Materials::Stone;
 }
 
 ChunkGenerator::ChunkBoolArray ChunkGenerator::GenerateArrayFromNoise(Vec2i chunkPos, int seed, ChunkMatrix &chunkMatrix)
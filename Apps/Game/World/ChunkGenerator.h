@@ -9,9 +9,9 @@ namespace ChunkGenerator{
     constexpr float GEN_X_MULTIPLIER = 1.9f; // makes the X axis n times wider
 
     Volume::Chunk* GenerateChunk(const Vec2i &chunkPos, ChunkMatrix &chunkMatrix);
-    Volume::Chunk* FillChunkWith(std::string materialID, bool unmovable, Volume::Chunk* chunk);
+    Volume::Chunk* FillChunkWith(Volume::MaterialID materialID, bool unmovable, Volume::Chunk* chunk);
 
-    std::string GetMaterialAtYLevel(int yLevel, Random &gen);
+    Volume::MaterialID GetMaterialAtYLevel(int yLevel, Random &gen);
 
     using ChunkBoolArray = std::array<std::array<bool, Volume::Chunk::CHUNK_SIZE>, Volume::Chunk::CHUNK_SIZE>;
     ChunkBoolArray GenerateArrayFromNoise(Vec2i chunkPos, int seed, ChunkMatrix &chunkMatrix);
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <Registry/VoxelRegistry.h>
+
+/// @brief Handles for the game materials referenced directly from code
+namespace Volume::Materials {
+    constinit inline Registry::MaterialHandle Grass{"Grass"};
+    constinit inline Registry::MaterialHandle Dirt{"Dirt"};
+    constinit inline Registry::MaterialHandle Stone{"Stone"};
+    constinit inline Registry::MaterialHandle Sand{"Sand"};
+    constinit inline Registry::MaterialHandle Water{"Water"};
+    constinit inline Registry::MaterialHandle Steam{"Steam"};
+    constinit inline Registry::MaterialHandle Wood{"Wood"};
+    constinit inline Registry::MaterialHandle Iron{"Iron"};
+    constinit inline Registry::MaterialHandle Ash{"Ash"};
+    constinit inline Registry::MaterialHandle CarbonDioxide{"Carbon_Dioxide"};
+}
@@ -35,14 +35,14 @@ void Particle::LaserGenerator::TickParticles()
         }
 
         // random alpha value from 70 - 180
-        int alpha = rand() % 111 + 70;
+        int alpha = Volume::voxelRandomGenerator.GetInt(70, 180);
         if(particleCount > totalNumberOfParticlesInLine-10) {
             //make alpha between 70 and 100
-            alpha = rand() % 31 + 70;
+            alpha = Volume::voxelRandomGenerator.GetInt(70, 100);
             alphaOffset += (totalNumberOfParticlesInLine - 10 - particleCount) * 4;
         }
         // 10% chance to increase lifetime by one simulation tick
-        bool increaseLifetime = rand() % 10 == 0;
+        bool increaseLifetime = Volume::voxelRandomGenerator.GetInt(0, 9) == 0;
 
         Particle::VoxelParticle *particle = new Particle::VoxelParticle(
             currentPos,
@@ -3,13 +3,15 @@
 #include <World/Particles/FallingParticle.h>
 #include <World/ChunkMatrix.h>
 
+#include "World/Materials.h"
+
 #include <cmath>
 
 /// @brief Returns a random variation value.
 /// @param max The maximum variation value.
 /// @return A random variation value in the range [-max, max].
 int variation(int max){
-    return rand() % (2 * max + 1) - max;
+    return Volume::voxelRandomGenerator.GetInt(-max, max);
 }
 
 using namespace Particle;
@@ -44,7 +46,7 @@ bool Particle::BulletParticle::Step(ChunkMatrix* matrix){
     Vec2f futurePos = position + m_dPosition;
 
     //40% chance to create a falling particle in opposite direction
-    if (rand() % 100 < 40)
+    if (Volume::voxelRandomGenerator.GetInt(0, 99) < 40)
     {
         VoxelParticle *particle = new FallingParticle(
             position,
@@ -58,11 +60,11 @@ bool Particle::BulletParticle::Step(ChunkMatrix* matrix){
     }
 
     // 20% chance to create a random red falling particle
-    if (rand() % 100 < 20){
+    if (Volume::voxelRandomGenerator.GetInt(0, 99) < 20){
         VoxelParticle *particle = new FallingParticle(
             position,
             RGBA(240+variation(15), 90+variation(40), 2+variation(2), 205+variation(15)),
-            rand() % 360 * M_PI / 180.0f,
+            Volume::voxelRandomGenerator.GetInt(0, 359) * M_PI / 180.0f,
             1.3f + variation(5)/10.0f,
             0.1f
         );
@@ -84,9 +86,9 @@ bool Particle::BulletParticle::Step(ChunkMatrix* matrix){
         Volume::VoxelElement *stepVoxel = matrix->VirtualGetAt(stepPosition, true);
         if (!stepVoxel || stepVoxel->GetState() == Volume::State::Solid ||this->ShouldDie()){
 
-            matrix->ExplodeAt(stepPosition, 2+(rand()%2-1));
+            matrix->ExplodeAt(stepPosition, 1+Volume::voxelRandomGenerator.GetInt(0, 1));
 
-            matrix->PlaceVoxelAt(stepPosition, "Iron", Volume::Temperature(100*this->damage), false, 1.0f, true, false);
+            matrix->PlaceVoxelAt(stepPosition, Volume::Materials::Iron, Volume::Temperature(100*this->damage), false, 1.0f, true, false);
 
             this->position = stepPosition;
 
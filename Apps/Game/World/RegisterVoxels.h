@@ -272,7 +272,7 @@ void RegisterGameVoxels(){
 	VoxelRegistry::RegisterVoxelFactory(
 		"Fire",
 		[](Vec2i position, Volume::Temperature temp, float amount, bool placeUnmovableSolids) {
-			return new FireVoxel(position, temp, amount);
+			return Volume::NewVoxel<FireVoxel>(position, temp, amount);
 		}
 	);
 	VoxelRegistry::RegisterVoxel(
@@ -287,7 +287,7 @@ void RegisterGameVoxels(){
 	VoxelRegistry::RegisterVoxelFactory(
 		"Fire_Solid",
 		[](Vec2i position, Volume::Temperature temp, float amount, bool placeUnmovableSolids) {
-			return new FireSolidVoxel(position, temp, amount, placeUnmovableSolids);
+			return Volume::NewVoxel<FireSolidVoxel>(position, temp, amount, placeUnmovableSolids);
 		}
 	);
 	VoxelRegistry::RegisterVoxel(
@@ -302,7 +302,7 @@ void RegisterGameVoxels(){
 	VoxelRegistry::RegisterVoxelFactory(
 		"Fire_Liquid",
 		[](Vec2i position, Volume::Temperature temp, float amount, bool placeUnmovableSolids) {
-			return new FireLiquidVoxel(position, temp, amount);
+			return Volume::NewVoxel<FireLiquidVoxel>(position, temp, amount);
 		}
 	);
 	VoxelRegistry::RegisterVoxel(
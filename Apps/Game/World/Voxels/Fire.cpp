@@ -1,6 +1,9 @@
 #include "Fire.h"
 
 #include <World/ChunkMatrix.h>
+#include <World/VoxelNeighborhood.h>
+
+#include "World/Materials.h"
 
 using namespace Volume;
 
@@ -15,17 +18,18 @@ const RGBA FireVoxel::fireColors[8] = {
     RGBA(255, 165, 0, 210)
 };
 
-FireVoxel::FireVoxel(Vec2i position, Temperature temp, float pressure) : VoxelGas("Fire", position, temp, pressure){ }
+FireVoxel::FireVoxel(Vec2i position, Temperature temp, float pressure) : VoxelGas(Materials::Fire, position, temp, pressure){ }
 
 // Spread the fire to adjacent voxels, returns true if this fire voxel is near oxygen
-bool FireVoxel::Spread(ChunkMatrix *matrix, const VoxelElement *FireVoxel)
+bool FireVoxel::Spread(ChunkMatrix *matrix, VoxelElement *FireVoxel)
 {
     //check for oxygen and spread
     bool isAroundOxygen = false;
     bool isAroundGas = false;
+    VoxelNeighborhood neighborhood(matrix, FireVoxel);
     for(Vec2i dir : vector::AROUND8){
-        VoxelElement* next = matrix->VirtualGetAt_NoLoad(FireVoxel->position + dir);
-        if(next && next->id == "Oxygen"){
+        VoxelElement* next = neighborhood.Get_NoLoad(dir.x, dir.y);
+        if(next && next->id == Materials::Oxygen){
             isAroundOxygen = true;
             break;
         }
@@ -38,11 +42,12 @@ bool FireVoxel::Spread(ChunkMatrix *matrix, const VoxelElement *FireVoxel)
         return false;
     }
 
+    const Registry::MaterialTable &materials = Registry::VoxelRegistry::GetMaterialTable();
     for(Vec2i dir : vector::AROUND8){
-        VoxelElement* next = matrix->VirtualGetAt_NoLoad(FireVoxel->position + dir);
+        VoxelElement* next = neighborhood.Get_NoLoad(dir.x, dir.y);
         if(next){
             //ignite based on Flamability
-            if((voxelRandomGenerator.GetInt(0, 255)) - next->properties->Flamability < 0){
+            if((voxelRandomGenerator.GetInt(0, 255)) - materials.flamability[next->id] < 0){
 
                 // only 15% chance to ignite if there is no oxygen around
                 bool randomIgniteChance = voxelRandomGenerator.GetInt(0, 100) < 15;
@@ -57,7 +62,7 @@ bool FireVoxel::Spread(ChunkMatrix *matrix, const VoxelElement *FireVoxel)
 
 bool FireVoxel::Step(ChunkMatrix *matrix)
 {
-    if(updatedThisFrame) {
+    if(IsUpdatedThisTick()) {
         return true; // already updated this frame
     }
 
@@ -75,16 +80,17 @@ bool FireVoxel::Step(ChunkMatrix *matrix)
         amountChange = this->amount * 0.25f;
     }
 
-    Chunk *chunk = matrix->GetChunkAtWorldPosition(Vec2f(this->position));
+    VoxelNeighborhood neighborhood(matrix, this);
+    Chunk *chunk = neighborhood.GetChunk(0, 0);
 
     for(Vec2i dir : vector::AROUND8){
-        VoxelElement* next = matrix->VirtualGetAt_NoLoad(this->position + dir);
+        VoxelElement* next = neighborhood.Get_NoLoad(dir.x, dir.y);
         if(next && next->GetState() == State::Gas){
             this->amount -= amountChange;
             if(chunk)
                 chunk->SetPressureAt(this->position, this->amount);
 
-            matrix->PlaceVoxelAt(this->position + dir, "Carbon_Dioxide", this->temperature, false, amountChange, false);
+            matrix->PlaceVoxelAt(this->position + dir, Materials::CarbonDioxide, this->temperature, false, amountChange, false);
             break;
         }
     }
@@ -98,7 +104,7 @@ bool FireVoxel::Step(ChunkMatrix *matrix)
         if(this->amount > 8)
             this->amount = 8;
         
-    	this->DieAndReplace(*matrix, "Carbon_Dioxide");
+    	this->DieAndReplace(*matrix, Materials::CarbonDioxide);
         return true;
     }
     VoxelGas::Step(matrix);
@@ -114,13 +120,13 @@ bool FireVoxel::Step(ChunkMatrix *matrix)
 }
 
 FireLiquidVoxel::FireLiquidVoxel(Vec2i position, Temperature temp, float amount)
-    : VoxelLiquid("Fire_Liquid", position, temp, amount)
+    : VoxelLiquid(Materials::FireLiquid, position, temp, amount)
 {
 }
 
 bool FireLiquidVoxel::Step(ChunkMatrix *matrix)
 {
-    if(updatedThisFrame) {
+    if(IsUpdatedThisTick()) {
         return true; // already updated this frame
     }
     //check for oxygen and spread
@@ -154,7 +160,7 @@ bool FireLiquidVoxel::Step(ChunkMatrix *matrix)
     {
         this->amount = std::max(this->amount, 0.1f);
 
-    	this->DieAndReplace(*matrix, "Carbon_Dioxide");
+    	this->DieAndReplace(*matrix, Materials::CarbonDioxide);
 
         return true;
     }
@@ -171,13 +177,13 @@ bool FireLiquidVoxel::Step(ChunkMatrix *matrix)
 }
 
 FireSolidVoxel::FireSolidVoxel(Vec2i position, Temperature temp, float amount, bool isStatic)
-    : VoxelSolid("Fire_Solid", position, temp, isStatic, amount)
+    : VoxelSolid(Materials::FireSolid, position, temp, isStatic, amount)
 {
 }
 
 bool FireSolidVoxel::Step(ChunkMatrix *matrix)
 {
-    if(updatedThisFrame) {
+    if(IsUpdatedThisTick()) {
         return true; // already updated this frame
     }
     //check for oxygen and spread
@@ -212,9 +218,9 @@ bool FireSolidVoxel::Step(ChunkMatrix *matrix)
         this->amount = std::max(this->amount, 0.1f);
 
         if(voxelRandomGenerator.GetInt(0, 100) < 10) // 10% chance to turn into ash
-            this->DieAndReplace(*matrix, "Ash");
+            this->DieAndReplace(*matrix, Materials::Ash);
         else
-            this->DieAndReplace(*matrix, "Carbon_Dioxide");
+            this->DieAndReplace(*matrix, Materials::CarbonDioxide);
 
         return true;
     }
@@ -9,7 +9,7 @@ namespace Volume{
 		FireVoxel(Vec2i position, Temperature temp, float pressure);
 		bool Step(ChunkMatrix* matrix) override;
 
-		static bool Spread(ChunkMatrix *matrix, const VoxelElement *FireVoxel);
+		static bool Spread(ChunkMatrix *matrix, VoxelElement *FireVoxel);
 
 		constexpr static uint8_t fireColorCount = 8;
 		static const RGBA fireColors[8];
@@ -10,6 +10,7 @@ int main(int argc, char* argv[])
     config.backgroundColor = RGB(25, 196, 255);
     config.vsync = false;
     config.consoleTimerWarnings = true;
+    config.saveDirectory = "Saves/World";
 
     Game game;
     engine.Run(game, config);
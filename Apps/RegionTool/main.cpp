@@ -0,0 +1,95 @@
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "World/Storage/RegionFile.h"
+
+// Offline maintenance of chunk store region files (see docs/Chunks.md)
+//
+// VoxaRegionTool info <save directory | region file>...
+// VoxaRegionTool compact [--min-fragmentation <0-1>] <save directory | region file>...
+
+namespace {
+    void PrintUsage()
+    {
+        std::cout << "Usage:\n"
+                  << "  VoxaRegionTool info <save directory | region file>...\n"
+                  << "  VoxaRegionTool compact [--min-fragmentation <0-1>] <save directory | region file>...\n";
+    }
+
+    std::vector<std::filesystem::path> CollectRegionFiles(const std::vector<std::filesystem::path> &inputs)
+    {
+        std::vector<std::filesystem::path> files;
+        for(const std::filesystem::path &input : inputs){
+            if(!std::filesystem::is_directory(input)){
+                files.push_back(input);
+                continue;
+            }
+            for(const auto &entry : std::filesystem::directory_iterator(input)){
+                if(entry.is_regular_file() && entry.path().extension() == Volume::RegionFile::EXTENSION)
+                    files.push_back(entry.path());
+            }
+        }
+        return files;
+    }
+
+    void PrintStats(const std::filesystem::path &path, const Volume::RegionFileStats &stats)
+    {
+        std::cout << path.string() << ": " << stats.chunkCount << " chunks, "
+                  << stats.fileSize / 1024 << " KiB on disk, "
+                  << stats.liveBytes / 1024 << " KiB live, "
+                  << stats.rawBytes / 1024 << " KiB uncompressed, "
+                  << static_cast<int>(stats.GetFragmentation() * 100.0f) << "% fragmented\n";
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if(argc < 3){
+        PrintUsage();
+        return 1;
+    }
+
+    std::string command = argv[1];
+    float minFragmentation = 0.0f;
+    std::vector<std::filesystem::path> inputs;
+
+    for(int i = 2; i < argc; ++i){
+        std::string argument = argv[i];
+        if(argument == "--min-fragmentation" && i + 1 < argc){
+            minFragmentation = std::stof(argv[++i]);
+            continue;
+        }
+        inputs.emplace_back(argument);
+    }
+
+    if(command != "info" && command != "compact"){
+        PrintUsage();
+        return 1;
+    }
+
+    int failed = 0;
+    for(const std::filesystem::path &path : CollectRegionFiles(inputs)){
+        try{
+            Volume::RegionFile region(path);
+            Volume::RegionFileStats stats = region.GetStats();
+
+            if(command == "info" || stats.GetFragmentation() < minFragmentation){
+                PrintStats(path, stats);
+                continue;
+            }
+
+            uint32_t dropped = region.Compact();
+            std::cout << "Compacted ";
+            PrintStats(path, region.GetStats());
+            if(dropped > 0)
+                std::cout << "  dropped " << dropped << " corrupted chunks\n";
+        }catch(const std::exception &e){
+            std::cerr << path.string() << ": " << e.what() << "\n";
+            failed++;
+        }
+    }
+
+    return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,157 @@
+#include "Debug/Profiler.h"
+
+#include <chrono>
+#include <mutex>
+
+using namespace Debug;
+
+std::atomic<bool> Profiler::enabled = false;
+
+namespace {
+    struct TrackHistory {
+        std::mutex mutex;
+        std::vector<ProfileFrame> frames;   // ring buffer of HISTORY_SIZE frames
+        size_t next = 0;                    // slot the next finished frame goes to
+    };
+
+    TrackHistory histories[static_cast<size_t>(ProfileTrack::COUNT)];
+
+    struct ThreadState {
+        bool inFrame = false;
+        bool inTraceFrame = false;          // frame is also sent to the trace recorder
+        uint64_t traceFrameStart = 0;
+        ProfileTrack track = ProfileTrack::Main;
+        ProfileFrame frame;
+        std::vector<size_t> openScopes;     // indices into frame.scopes
+    };
+
+    thread_local ThreadState threadState;
+
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+}
+
+void Profiler::SetEnabled(bool enable)
+{
+    enabled.store(enable, std::memory_order_relaxed);
+}
+
+void Profiler::BeginFrame(ProfileTrack track)
+{
+    ThreadState &state = threadState;
+    state.track = track;
+    state.inTraceFrame = TraceRecorder::IsRecording();
+    if(state.inTraceFrame) state.traceFrameStart = Now();
+
+    if(!IsEnabled()) return;
+
+    state.inFrame = true;
+    state.frame.scopes.clear();
+    state.openScopes.clear();
+    state.frame.start = Now();
+}
+
+void Profiler::EndFrame()
+{
+    ThreadState &state = threadState;
+    if(state.inTraceFrame){
+        state.inTraceFrame = false;
+        TraceRecorder::Record(GetTrackName(state.track), TraceCategory::Frame, state.traceFrameStart, Now() - state.traceFrameStart);
+    }
+
+    if(!state.inFrame) return;
+    state.inFrame = false;
+
+    const uint64_t end = Now();
+    state.frame.duration = end - state.frame.start;
+
+    // scopes still open when the frame ends are cut off at the end of the frame
+    for(size_t index : state.openScopes)
+        state.frame.scopes[index].duration = end - state.frame.scopes[index].start;
+    state.openScopes.clear();
+
+    TrackHistory &history = histories[static_cast<size_t>(state.track)];
+    std::lock_guard<std::mutex> lock(history.mutex);
+    if(history.frames.size() < HISTORY_SIZE){
+        history.frames.push_back(std::move(state.frame));
+    }else{
+        // hand the old frame back to the thread, so its scope vector is reused
+        std::swap(history.frames[history.next], state.frame);
+    }
+    history.next = (history.next + 1) % HISTORY_SIZE;
+}
+
+void Profiler::BeginScope(const char *name)
+{
+    ThreadState &state = threadState;
+    if(!state.inFrame) return;
+
+    state.openScopes.push_back(state.frame.scopes.size());
+    state.frame.scopes.push_back(ProfileScopeRecord{
+        name,
+        static_cast<uint16_t>(state.openScopes.size() - 1),
+        Now(),
+        0
+    });
+}
+
+void Profiler::EndScope()
+{
+    ThreadState &state = threadState;
+    // the scope may have been opened before the frame began
+    if(!state.inFrame || state.openScopes.empty()) return;
+
+    ProfileScopeRecord &record = state.frame.scopes[state.openScopes.back()];
+    record.duration = Now() - record.start;
+    state.openScopes.pop_back();
+}
+
+std::vector<ProfileFrame> Profiler::GetHistory(ProfileTrack track)
+{
+    TrackHistory &history = histories[static_cast<size_t>(track)];
+    std::lock_guard<std::mutex> lock(history.mutex);
+
+    if(history.frames.size() < HISTORY_SIZE)
+        return history.frames;
+
+    std::vector<ProfileFrame> ordered;
+    ordered.reserve(HISTORY_SIZE);
+    for(size_t i = 0; i < HISTORY_SIZE; ++i)
+        ordered.push_back(history.frames[(history.next + i) % HISTORY_SIZE]);
+    return ordered;
+}
+
+bool Profiler::GetLastFrame(ProfileTrack track, ProfileFrame &frame)
+{
+    TrackHistory &history = histories[static_cast<size_t>(track)];
+    std::lock_guard<std::mutex> lock(history.mutex);
+
+    if(history.frames.empty()) return false;
+
+    frame = history.frames[(history.next + HISTORY_SIZE - 1) % HISTORY_SIZE];
+    return true;
+}
+
+void Profiler::ClearHistory()
+{
+    for(TrackHistory &history : histories){
+        std::lock_guard<std::mutex> lock(history.mutex);
+        history.frames.clear();
+        history.next = 0;
+    }
+}
+
+const char *Profiler::GetTrackName(ProfileTrack track)
+{
+    switch(track){
+        case ProfileTrack::Main: return "Main";
+        case ProfileTrack::Simulation: return "Simulation";
+        default: return "Unknown";
+    }
+}
+
+uint64_t Profiler::Now()
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - epoch
+    ).count());
+}
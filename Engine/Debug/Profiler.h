@@ -0,0 +1,105 @@
+#pragma once
+
+// remove to compile every profiler scope out of the engine
+#define ENABLE_PROFILER
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "Debug/TraceRecorder.h"
+
+namespace Debug{
+    /// @brief Independent timelines, each one is driven by a single thread at a time
+    enum class ProfileTrack : uint8_t {
+        Main = 0,       // input, physics, fixed update and rendering
+        Simulation = 1, // voxel simulation steps
+        COUNT
+    };
+
+    struct ProfileScopeRecord {
+        const char *name;   // has to outlive the profiler, use string literals
+        uint16_t depth;     // 0 for scopes directly inside the frame
+        uint64_t start;     // nanoseconds, see `Profiler::Now`
+        uint64_t duration;  // nanoseconds
+    };
+
+    struct ProfileFrame {
+        uint64_t start = 0;
+        uint64_t duration = 0;
+        std::vector<ProfileScopeRecord> scopes; // in the order they were opened
+
+        float GetMilliseconds() const { return duration / 1'000'000.0f; }
+    };
+
+    /// @brief Hierarchical frame profiler. Scopes are recorded per thread into the frame opened
+    /// with `Profiler::BeginFrame`, finished frames are kept in a rolling history per track
+    /// @note Scopes opened outside of a frame (e.g. on OpenMP workers) are ignored, but still reach
+    /// the `TraceRecorder`. While disabled every scope costs two relaxed atomic loads
+    class Profiler{
+    public:
+        static void SetEnabled(bool enable);
+        static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+        static void BeginFrame(ProfileTrack track);
+        static void EndFrame();
+
+        static void BeginScope(const char *name);
+        static void EndScope();
+
+        /// @brief Copies the finished frames of the track, oldest first
+        static std::vector<ProfileFrame> GetHistory(ProfileTrack track);
+        /// @return false if the track has no finished frame yet
+        static bool GetLastFrame(ProfileTrack track, ProfileFrame &frame);
+        static void ClearHistory();
+
+        static const char* GetTrackName(ProfileTrack track);
+        /// @brief Nanoseconds since the profiler was first used
+        static uint64_t Now();
+
+        static constexpr size_t HISTORY_SIZE = 240;
+    private:
+        static std::atomic<bool> enabled;
+    };
+
+    class ProfileScope{
+    public:
+        explicit ProfileScope(const char *name)
+            : name(name), active(Profiler::IsEnabled()), tracing(TraceRecorder::IsRecording())
+        {
+            if(active) Profiler::BeginScope(name);
+            if(tracing) start = Profiler::Now();
+        }
+        ~ProfileScope()
+        {
+            if(tracing) TraceRecorder::Record(name, TraceCategory::Scope, start, Profiler::Now() - start);
+            if(active) Profiler::EndScope();
+        }
+
+        // disable copy and move
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+    private:
+        const char *name;
+        uint64_t start = 0;
+        bool active;
+        bool tracing;
+    };
+}
+
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+
+#ifdef ENABLE_PROFILER
+    /// @brief Times the rest of the enclosing block, `name` has to be a string literal
+    #define PROFILE_SCOPE(name) Debug::ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(name)
+    #define PROFILE_BEGIN_FRAME(track) Debug::Profiler::BeginFrame(track)
+    #define PROFILE_END_FRAME() Debug::Profiler::EndFrame()
+    /// @brief Only shows up in dumped traces, for short scopes that would clutter the profiler
+    #define TRACE_SCOPE(name) Debug::TraceScope PROFILE_CONCAT(traceScope, __LINE__)(name)
+#else
+    #define PROFILE_SCOPE(name)
+    #define PROFILE_BEGIN_FRAME(track)
+    #define PROFILE_END_FRAME()
+    #define TRACE_SCOPE(name)
+#endif
@@ -0,0 +1,175 @@
+#include "Debug/Stats.h"
+
+#include <mutex>
+
+#include "Debug/Logger.h"
+
+using namespace Debug;
+
+Stats::Counter Stats::counters[static_cast<size_t>(StatCounter::COUNT)];
+
+namespace {
+    constexpr size_t COUNTER_COUNT = static_cast<size_t>(StatCounter::COUNT);
+
+    std::mutex historyMutex;
+    std::vector<StatsSnapshot> history;     // ring buffer of HISTORY_SIZE ticks
+    size_t nextSnapshot = 0;
+
+    // guarded by historyMutex
+    uint32_t logInterval = 0;
+    StatsFormat logFormat = StatsFormat::CSV;
+    StatsSnapshot logAccumulated;
+    uint32_t logAccumulatedTicks = 0;
+
+    void AccumulateForLog(const StatsSnapshot &snapshot)
+    {
+        logAccumulated.tick = snapshot.tick;
+        for(size_t i = 0; i < COUNTER_COUNT; ++i){
+            if(Stats::IsGauge(static_cast<StatCounter>(i))) logAccumulated.values[i] = snapshot.values[i];
+            else logAccumulated.values[i] += snapshot.values[i];
+        }
+        logAccumulatedTicks++;
+    }
+
+    std::string FormatCSVHeader()
+    {
+        std::string line = "stats,tick,ticks";
+        for(size_t i = 0; i < COUNTER_COUNT; ++i)
+            line += std::string(",") + Stats::GetName(static_cast<StatCounter>(i));
+        return line;
+    }
+
+    std::string FormatLogLine(const StatsSnapshot &snapshot, uint32_t ticks, StatsFormat format)
+    {
+        std::string line;
+        if(format == StatsFormat::CSV){
+            line = "stats," + std::to_string(snapshot.tick) + "," + std::to_string(ticks);
+            for(size_t i = 0; i < COUNTER_COUNT; ++i)
+                line += "," + std::to_string(snapshot.values[i]);
+        }else{
+            line = "{\"tick\":" + std::to_string(snapshot.tick) + ",\"ticks\":" + std::to_string(ticks);
+            for(size_t i = 0; i < COUNTER_COUNT; ++i)
+                line += ",\"" + std::string(Stats::GetName(static_cast<StatCounter>(i))) + "\":" + std::to_string(snapshot.values[i]);
+            line += "}";
+        }
+        return line;
+    }
+}
+
+void Stats::FlushTick(uint64_t tick)
+{
+    StatsSnapshot snapshot;
+    snapshot.tick = tick;
+    for(size_t i = 0; i < COUNTER_COUNT; ++i)
+        snapshot.values[i] = counters[i].value.exchange(0, std::memory_order_relaxed);
+
+    std::string logLine;
+    {
+        std::lock_guard<std::mutex> lock(historyMutex);
+        if(history.size() < HISTORY_SIZE) history.push_back(snapshot);
+        else history[nextSnapshot] = snapshot;
+        nextSnapshot = (nextSnapshot + 1) % HISTORY_SIZE;
+
+        if(logInterval > 0){
+            AccumulateForLog(snapshot);
+            if(logAccumulatedTicks >= logInterval){
+                logLine = FormatLogLine(logAccumulated, logAccumulatedTicks, logFormat);
+                logAccumulated = StatsSnapshot();
+                logAccumulatedTicks = 0;
+            }
+        }
+    }
+
+    // logged outside of the lock, sinks may take a while
+    if(!logLine.empty()) Debug::LogInfo(logLine);
+}
+
+bool Stats::GetLastTick(StatsSnapshot &snapshot)
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if(history.empty()) return false;
+
+    snapshot = history[(nextSnapshot + HISTORY_SIZE - 1) % HISTORY_SIZE];
+    return true;
+}
+
+std::vector<StatsSnapshot> Stats::GetHistory()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    if(history.size() < HISTORY_SIZE)
+        return history;
+
+    std::vector<StatsSnapshot> ordered;
+    ordered.reserve(HISTORY_SIZE);
+    for(size_t i = 0; i < HISTORY_SIZE; ++i)
+        ordered.push_back(history[(nextSnapshot + i) % HISTORY_SIZE]);
+    return ordered;
+}
+
+void Stats::ClearHistory()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    history.clear();
+    nextSnapshot = 0;
+}
+
+void Stats::SetLogInterval(uint32_t intervalTicks, StatsFormat format)
+{
+    bool logHeader = false;
+    {
+        std::lock_guard<std::mutex> lock(historyMutex);
+        logHeader = intervalTicks > 0 && format == StatsFormat::CSV && (logInterval == 0 || logFormat != StatsFormat::CSV);
+
+        logInterval = intervalTicks;
+        logFormat = format;
+        logAccumulated = StatsSnapshot();
+        logAccumulatedTicks = 0;
+    }
+
+    if(logHeader) Debug::LogInfo(FormatCSVHeader());
+}
+
+uint32_t Stats::GetLogInterval()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return logInterval;
+}
+
+StatsFormat Stats::GetLogFormat()
+{
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return logFormat;
+}
+
+const char *Stats::GetName(StatCounter counter)
+{
+    switch(counter){
+        case StatCounter::VoxelsStepped: return "voxelsStepped";
+        case StatCounter::VoxelsMoved: return "voxelsMoved";
+        case StatCounter::DirtyArea: return "dirtyArea";
+        case StatCounter::ChunksActive: return "chunksActive";
+        case StatCounter::ChunksSleeping: return "chunksSleeping";
+        case StatCounter::ChunksGenerated: return "chunksGenerated";
+        case StatCounter::ChunksLoaded: return "chunksLoaded";
+        case StatCounter::ChunksDeleted: return "chunksDeleted";
+        case StatCounter::ColliderRegenerations: return "colliderRegenerations";
+        case StatCounter::ParticlesAlive: return "particlesAlive";
+        case StatCounter::VoxelAllocations: return "voxelAllocations";
+        case StatCounter::VoxelFrees: return "voxelFrees";
+        case StatCounter::GPUBytesUploaded: return "gpuBytesUploaded";
+        case StatCounter::GPUBytesReadBack: return "gpuBytesReadBack";
+        case StatCounter::WorldLockWaits: return "worldLockWaits";
+        case StatCounter::WorldLockWaitMicros: return "worldLockWaitMicros";
+        case StatCounter::ChunkLockWaits: return "chunkLockWaits";
+        case StatCounter::ChunkLockWaitMicros: return "chunkLockWaitMicros";
+        case StatCounter::GPUResultsDiscarded: return "gpuResultsDiscarded";
+        default: return "unknown";
+    }
+}
+
+bool Stats::IsGauge(StatCounter counter)
+{
+    return counter == StatCounter::ChunksActive
+        || counter == StatCounter::ChunksSleeping
+        || counter == StatCounter::ParticlesAlive;
+}
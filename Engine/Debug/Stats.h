@@ -0,0 +1,87 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Debug{
+    enum class StatCounter : uint8_t {
+        VoxelsStepped = 0,      // voxels inside dirty rects that were stepped
+        VoxelsMoved,            // steps that changed the voxel or its surroundings
+        DirtyArea,              // voxels covered by the dirty tiles of all chunks
+        ChunksActive,           // gauge, chunks with a dirty rect
+        ChunksSleeping,         // gauge, chunks skipped by the simulation
+        ChunksGenerated,        // chunks created by the generator and inserted into the matrix
+        ChunksLoaded,           // chunks loaded from the chunk store and inserted into the matrix
+        ChunksDeleted,
+        ColliderRegenerations,  // chunk and object collider rebuilds
+        ParticlesAlive,         // gauge, sampled at the end of the tick
+        VoxelAllocations,
+        VoxelFrees,
+        GPUBytesUploaded,
+        GPUBytesReadBack,
+        WorldLockWaits,         // `ChunkMatrix::voxelMutex` locks that had to wait for another thread
+        WorldLockWaitMicros,    // microseconds spent in those waits
+        ChunkLockWaits,         // chunk locks that had to wait for another thread
+        ChunkLockWaitMicros,
+        GPUResultsDiscarded,    // GPU heat, pressure and reaction results dropped because the voxel pass changed the voxel after its upload
+        COUNT
+    };
+
+    /// @brief Counter values of one simulation tick
+    struct StatsSnapshot {
+        uint64_t tick = 0;
+        uint64_t values[static_cast<size_t>(StatCounter::COUNT)] = {};
+
+        uint64_t Get(StatCounter counter) const { return values[static_cast<size_t>(counter)]; }
+    };
+
+    enum class StatsFormat : uint8_t {
+        CSV = 0,
+        JSON = 1,
+    };
+
+    /// @brief Engine wide counters, any thread adds to them and the simulation flushes them once per tick
+    /// @note Hot loops should sum locally and add once (e.g. per chunk), every `Add` is an atomic
+    class Stats{
+    public:
+        static void Add(StatCounter counter, uint64_t amount = 1)
+        {
+            counters[static_cast<size_t>(counter)].value.fetch_add(amount, std::memory_order_relaxed);
+        }
+        /// @brief Overwrites the value of a gauge counter
+        static void Set(StatCounter counter, uint64_t value)
+        {
+            counters[static_cast<size_t>(counter)].value.store(value, std::memory_order_relaxed);
+        }
+
+        /// @brief Closes the tick, moves the counters into the history and resets them
+        /// @note Called by the engine at the end of every simulation step
+        static void FlushTick(uint64_t tick);
+
+        /// @return false if no tick was flushed yet
+        static bool GetLastTick(StatsSnapshot &snapshot);
+        /// @brief Copies the flushed ticks, oldest first
+        static std::vector<StatsSnapshot> GetHistory();
+        static void ClearHistory();
+
+        /// @brief Logs the counters summed over every `intervalTicks` ticks, 0 disables the sink
+        /// @note CSV logs its header line once when enabled
+        static void SetLogInterval(uint32_t intervalTicks, StatsFormat format = StatsFormat::CSV);
+        static uint32_t GetLogInterval();
+        static StatsFormat GetLogFormat();
+
+        static const char* GetName(StatCounter counter);
+        /// @brief Gauges describe the state of a single tick, sums over multiple ticks keep the last value
+        static bool IsGauge(StatCounter counter);
+
+        static constexpr size_t HISTORY_SIZE = 240;
+    private:
+        struct alignas(64) Counter {
+            std::atomic<uint64_t> value = 0;
+        };
+
+        static Counter counters[static_cast<size_t>(StatCounter::COUNT)];
+    };
+}
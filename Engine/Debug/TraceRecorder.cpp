@@ -0,0 +1,255 @@
+#include "Debug/TraceRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "Debug/Logger.h"
+#include "Debug/Profiler.h"
+
+using namespace Debug;
+
+std::atomic<bool> TraceRecorder::recording = false;
+
+namespace {
+    struct TraceSlot {
+        // seqlock, 0 while the slot is being written, otherwise the index of the event + 1
+        std::atomic<uint64_t> sequence{0};
+        const char *name = nullptr;
+        uint64_t start = 0;
+        uint64_t duration = 0;
+        uint32_t lane = 0;
+        TraceCategory category = TraceCategory::Scope;
+    };
+
+    struct TraceEvent {
+        const char *name;
+        uint64_t start;
+        uint64_t duration;
+        uint32_t lane;
+        TraceCategory category;
+    };
+
+    std::unique_ptr<TraceSlot[]> slots;
+    std::once_flag slotsAllocated;
+    std::atomic<uint64_t> nextSlot = 0;
+
+    std::mutex laneMutex;
+    std::vector<std::string> laneNames;     // indexed by lane id
+
+    std::atomic<uint32_t> nextLane = 0;
+    thread_local uint32_t threadLane = UINT32_MAX;
+
+    uint32_t GetThreadLane()
+    {
+        if(threadLane != UINT32_MAX) return threadLane;
+        threadLane = nextLane.fetch_add(1, std::memory_order_relaxed);
+
+        // threads that never named themselves are OpenMP workers or foreign threads
+        std::string name;
+#ifdef _OPENMP
+        if(omp_in_parallel()) name = "OpenMP worker " + std::to_string(omp_get_thread_num());
+#endif
+        if(name.empty()) name = "Thread " + std::to_string(threadLane);
+
+        std::lock_guard<std::mutex> lock(laneMutex);
+        if(laneNames.size() <= threadLane) laneNames.resize(threadLane + 1);
+        if(laneNames[threadLane].empty()) laneNames[threadLane] = name;
+        return threadLane;
+    }
+
+    const char *GetCategoryName(TraceCategory category)
+    {
+        switch(category){
+            case TraceCategory::Scope: return "scope";
+            case TraceCategory::Frame: return "frame";
+            case TraceCategory::Lock: return "lock";
+            default: return "unknown";
+        }
+    }
+
+    void WriteEscaped(std::ostream &out, const std::string &text)
+    {
+        for(char c : text){
+            if(c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+    }
+}
+
+void TraceRecorder::SetRecording(bool record)
+{
+    if(record) std::call_once(slotsAllocated, []{ slots = std::make_unique<TraceSlot[]>(CAPACITY); });
+    recording.store(record, std::memory_order_relaxed);
+}
+
+void TraceRecorder::SetThreadName(const std::string &name)
+{
+    uint32_t lane = GetThreadLane();
+
+    std::lock_guard<std::mutex> lock(laneMutex);
+    laneNames[lane] = name;
+}
+
+void TraceRecorder::Record(const char *name, TraceCategory category, uint64_t start, uint64_t duration)
+{
+    if(!IsRecording()) return;
+
+    const uint64_t index = nextSlot.fetch_add(1, std::memory_order_relaxed);
+    TraceSlot &slot = slots[index % CAPACITY];
+
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name = name;
+    slot.start = start;
+    slot.duration = duration;
+    slot.lane = GetThreadLane();
+    slot.category = category;
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+bool TraceRecorder::DumpChromeTrace(const std::string &path, uint32_t frameCount)
+{
+    if(!slots){
+        Debug::LogWarn("Nothing to dump, the trace recorder was never started");
+        return false;
+    }
+
+    // stop writers from lapping the buffer while it is read
+    const bool wasRecording = IsRecording();
+    recording.store(false, std::memory_order_relaxed);
+
+    const uint64_t end = nextSlot.load(std::memory_order_acquire);
+    const uint64_t begin = end > CAPACITY ? end - CAPACITY : 0;
+
+    std::vector<TraceEvent> events;
+    events.reserve(end - begin);
+    for(uint64_t index = begin; index < end; ++index){
+        const TraceSlot &slot = slots[index % CAPACITY];
+
+        const uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        TraceEvent event{ slot.name, slot.start, slot.duration, slot.lane, slot.category };
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        // skip slots still being written or already overwritten
+        if(sequence != index + 1 || slot.sequence.load(std::memory_order_relaxed) != sequence) continue;
+        events.push_back(event);
+    }
+
+    recording.store(wasRecording, std::memory_order_relaxed);
+
+    // the window starts with the oldest of the last `frameCount` main frames
+    const char *mainFrameName = Profiler::GetTrackName(ProfileTrack::Main);
+    std::vector<uint64_t> frameStarts;
+    for(const TraceEvent &event : events)
+        if(event.category == TraceCategory::Frame && event.name == mainFrameName)
+            frameStarts.push_back(event.start);
+    std::sort(frameStarts.begin(), frameStarts.end());
+
+    uint64_t windowStart = 0;
+    if(frameCount > 0 && frameStarts.size() > frameCount)
+        windowStart = frameStarts[frameStarts.size() - frameCount];
+
+    std::filesystem::path filePath(path);
+    if(filePath.has_parent_path()){
+        std::error_code error;
+        std::filesystem::create_directories(filePath.parent_path(), error);
+    }
+
+    std::ofstream out(filePath);
+    if(!out.is_open()){
+        Debug::LogError("Failed to open trace file: " + path);
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    bool first = true;
+    {
+        std::lock_guard<std::mutex> lock(laneMutex);
+        for(size_t lane = 0; lane < laneNames.size(); ++lane){
+            out << (first ? "" : ",\n");
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << lane << ",\"args\":{\"name\":\"";
+            WriteEscaped(out, laneNames[lane]);
+            out << "\"}},\n";
+            out << "{\"name\":\"thread_sort_index\",\"ph\":\"M\",\"pid\":1,\"tid\":" << lane << ",\"args\":{\"sort_index\":" << lane << "}}";
+            first = false;
+        }
+    }
+
+    size_t written = 0;
+    for(const TraceEvent &event : events){
+        if(event.start + event.duration < windowStart) continue;
+
+        out << (first ? "" : ",\n");
+        out << "{\"name\":\"";
+        WriteEscaped(out, event.name);
+        out << "\",\"cat\":\"" << GetCategoryName(event.category) << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.lane
+            << ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << event.duration / 1000.0 << "}";
+        first = false;
+        ++written;
+    }
+
+    out << "\n]}\n";
+    if(!out.good()){
+        Debug::LogError("Failed to write trace file: " + path);
+        return false;
+    }
+
+    Debug::LogInfo("Trace with " + std::to_string(written) + " events written to " + path);
+    return true;
+}
+
+void TraceRecorder::Capture()
+{
+    if(!IsRecording()){
+        SetRecording(true);
+        Debug::LogInfo("Trace recording started, capture again to save the recorded frames");
+        return;
+    }
+
+    const auto timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()
+    ).count();
+    DumpChromeTrace("Traces/trace-" + std::to_string(timestamp) + ".json");
+}
+
+TraceScope::TraceScope(const char *name)
+    : name(name), active(TraceRecorder::IsRecording())
+{
+    if(active) start = Profiler::Now();
+}
+
+TraceScope::~TraceScope()
+{
+    if(active) TraceRecorder::Record(name, TraceCategory::Scope, start, Profiler::Now() - start);
+}
+
+void TracedMutex::LockContended()
+{
+    const uint64_t start = Profiler::Now();
+    mutex.lock();
+    TraceRecorder::Record(name, TraceCategory::Lock, start, Profiler::Now() - start);
+}
+
+void TracedSharedMutex::LockContended(bool shared)
+{
+    const uint64_t start = Profiler::Now();
+    if(shared) mutex.lock_shared();
+    else mutex.lock();
+    const uint64_t waited = Profiler::Now() - start;
+
+    Stats::Add(waitCounter);
+    Stats::Add(waitMicrosCounter, waited / 1000);
+    if(TraceRecorder::IsRecording())
+        TraceRecorder::Record(name, TraceCategory::Lock, start, waited);
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+
+#include "Debug/Stats.h"
+
+namespace Debug{
+    enum class TraceCategory : uint8_t {
+        Scope = 0,  // profiler and trace scopes
+        Frame = 1,  // whole profiler frames
+        Lock = 2,   // time spent waiting on a `TracedMutex` or `TracedSharedMutex`
+    };
+
+    /// @brief Records timed events of every thread into a fixed ring buffer, which can be
+    /// dumped as Chrome Trace Event JSON (chrome://tracing, ui.perfetto.dev)
+    /// @note Profiler scopes are recorded too, including the ones opened outside of a frame.
+    /// While not recording every event costs a single relaxed atomic load
+    class TraceRecorder{
+    public:
+        static void SetRecording(bool record);
+        static bool IsRecording() { return recording.load(std::memory_order_relaxed); }
+
+        /// @brief Names the lane of the calling thread in dumped traces
+        static void SetThreadName(const std::string &name);
+
+        /// @param name has to outlive the recorder, use string literals
+        /// @param start nanoseconds, see `Profiler::Now`
+        static void Record(const char *name, TraceCategory category, uint64_t start, uint64_t duration);
+
+        /// @brief Writes the events of the last `frameCount` main frames to `path`
+        /// @return false if the file could not be written
+        static bool DumpChromeTrace(const std::string &path, uint32_t frameCount = DEFAULT_DUMP_FRAMES);
+        /// @brief Starts recording, or dumps the recorded frames into the Traces folder if already recording
+        static void Capture();
+
+        static constexpr uint32_t CAPACITY = 1 << 18;
+        static constexpr uint32_t DEFAULT_DUMP_FRAMES = 300;
+    private:
+        static std::atomic<bool> recording;
+    };
+
+    class TraceScope{
+    public:
+        explicit TraceScope(const char *name);
+        ~TraceScope();
+
+        // disable copy and move
+        TraceScope(const TraceScope&) = delete;
+        TraceScope& operator=(const TraceScope&) = delete;
+    private:
+        const char *name;
+        uint64_t start = 0;
+        bool active;
+    };
+
+    /// @brief std::mutex that shows up as a lock event in traces while a thread is blocked on it
+    class TracedMutex{
+    public:
+        /// @param name of the wait event, has to outlive the mutex, use string literals
+        explicit TracedMutex(const char *name) : name(name) {}
+
+        void lock()
+        {
+            if(!TraceRecorder::IsRecording()){
+                mutex.lock();
+                return;
+            }
+            if(!mutex.try_lock()) LockContended();
+        }
+        bool try_lock() { return mutex.try_lock(); }
+        void unlock() { mutex.unlock(); }
+
+        // disable copy and move
+        TracedMutex(const TracedMutex&) = delete;
+        TracedMutex& operator=(const TracedMutex&) = delete;
+    private:
+        void LockContended();
+
+        std::mutex mutex;
+        const char *name;
+    };
+
+    /// @brief std::shared_mutex that counts every lock which had to wait into `Stats`, and shows
+    /// up as a lock event in traces like `TracedMutex`
+    /// @note An uncontended lock costs one extra try_lock
+    class TracedSharedMutex{
+    public:
+        /// @param name of the wait event, has to outlive the mutex, use string literals
+        /// @param waitCounter counts the waits, `waitMicrosCounter` the time spent in them
+        TracedSharedMutex(const char *name, StatCounter waitCounter, StatCounter waitMicrosCounter)
+            : name(name), waitCounter(waitCounter), waitMicrosCounter(waitMicrosCounter) {}
+
+        void lock() { if(!mutex.try_lock()) LockContended(false); }
+        bool try_lock() { return mutex.try_lock(); }
+        void unlock() { mutex.unlock(); }
+
+        void lock_shared() { if(!mutex.try_lock_shared()) LockContended(true); }
+        bool try_lock_shared() { return mutex.try_lock_shared(); }
+        void unlock_shared() { mutex.unlock_shared(); }
+
+        // disable copy and move
+        TracedSharedMutex(const TracedSharedMutex&) = delete;
+        TracedSharedMutex& operator=(const TracedSharedMutex&) = delete;
+    private:
+        void LockContended(bool shared);
+
+        std::shared_mutex mutex;
+        const char *name;
+        StatCounter waitCounter;
+        StatCounter waitMicrosCounter;
+    };
+}
+
@@ -1,6 +1,7 @@
 #include "GameEngine.h"
 #include <iostream>
 #include <mutex>
+#include <shared_mutex>
 #include <cstring>
 #include <algorithm>
 
@@ -20,9 +21,6 @@ GameEngine::GameEngine()
     if(GameEngine::instance != nullptr){
         throw std::runtime_error("GameEngine is already initialized! Cannot run more than one instance.");
     }
-
-    //init srand
-    std::srand(static_cast<unsigned>(time(NULL)));
 }
 
 void GameEngine::Initialize(const Config::EngineConfig& config){
@@ -30,12 +28,18 @@ void GameEngine::Initialize(const Config::EngineConfig& config){
         throw std::runtime_error("GameEngine is already initialized! Cannot run more than one instance.");
     }
 
+    this->config = config;
+    this->taskScheduler = std::make_unique<Threading::TaskScheduler>(config.workerThreads);
+    // compute shaders need a GL context
+    if(this->config.headless) this->config.disableGPUSimulations = true;
+
     this->chunkMatrix = new ChunkMatrix();
     this->chunkMatrix->isActive = true;
 
     GameEngine::physics = new GamePhysics();
 
-    GameEngine::renderer = new GameRenderer(&glContext, config.backgroundColor, config.automaticLoadingOfChunksInView);
+    if(!this->config.headless)
+        GameEngine::renderer = new GameRenderer(&glContext, config.backgroundColor, config.automaticLoadingOfChunksInView);
 
     this->fixedDeltaTime = config.fixedDeltaTime;
     this->voxelFixedDeltaTime = config.voxelFixedDeltaTime;
@@ -48,105 +52,231 @@ void GameEngine::Initialize(const Config::EngineConfig& config){
     this->consoleTimerWarnings = config.consoleTimerWarnings;
 
     GameEngine::instance = this;
-    GameEngine::renderer->SetVSYNC(config.vsync);
+    if(GameEngine::renderer)
+        GameEngine::renderer->SetVSYNC(config.vsync);
 
-    this->chunkMatrix->Initialize(config.disableGPUSimulations);
+    this->chunkMatrix->Initialize(this->config.disableGPUSimulations);
+    if(config.deterministicSimulation)
+        this->chunkMatrix->EnableDeterministicSimulation(config.simulationSeed);
+    if(!config.saveDirectory.empty())
+        this->chunkMatrix->EnableChunkStore(config.saveDirectory);
 
     //TODO: just a temp fix to stop fixed and simulation time from running at the same time, blocking each other
     this->fixedUpdateTimer = -fixedDeltaTime / 2.0f;
 
     this->running = true;
-    this->config = config;
 }
 
 void GameEngine::Run(IGame &game, const Config::EngineConfig& config)
 {
+    this->Start(game, config);
+
+    GameEngine::instance->StartSimulationThread(game);
+
+    //Main game loop
+    while (this->running)
+    {
+        PROFILE_BEGIN_FRAME(Debug::ProfileTrack::Main);
+
+        this->Update(game);
+
+        if(GameEngine::renderer)
+            this->Render();
+
+        PROFILE_END_FRAME();
+
+        this->EndFrame();
+    }
+
+    game.OnShutdown();
+}
+
+void GameEngine::Start(IGame &game, const Config::EngineConfig &config)
+{
+    Debug::TraceRecorder::SetThreadName("Main");
     this->Initialize(config);
     this->currentGame = &game;
 
     Registry::VoxelRegistry::RegisterVoxels(this->currentGame);
-    Registry::VoxelRegistry::CloseRegistry();
+    Registry::VoxelRegistry::CloseRegistry(!this->config.disableGPUSimulations);
 
     Registry::VoxelObjectRegistry::RegisterObjects(this->currentGame);
     Registry::VoxelObjectRegistry::CloseRegistry();
 
     game.OnInitialize();
+}
 
-    GameEngine::instance->StartSimulationThread(game);
+void GameEngine::Tick()
+{
+    this->deltaTime = this->voxelFixedDeltaTime;
 
-    //Main game loop
-    while (this->running)
-    {
-        this->Update(game);
+    PROFILE_BEGIN_FRAME(Debug::ProfileTrack::Main);
+    this->Update(*this->currentGame);
+    PROFILE_END_FRAME();
 
-        this->Render();
+    // there is no simulation thread, the step below is the voxel update of this frame
+    this->voxelUpdateTimer = 0;
 
-        this->EndFrame();
-    }
+    PROFILE_BEGIN_FRAME(Debug::ProfileTrack::Simulation);
+    this->chunkMatrix->voxelMutex.lock();
+    this->VoxelSimulationStep();
+    this->chunkMatrix->voxelMutex.unlock();
 
-    game.OnShutdown();
+    {
+        PROFILE_SCOPE("Game voxel update");
+        this->currentGame->VoxelUpdate(this->voxelFixedDeltaTime);
+    }
+    PROFILE_END_FRAME();
 }
 
 void GameEngine::VoxelSimulationStep()
 {
+    chunkMatrix->SeedVoxelRandom(ChunkMatrix::OBJECT_RANDOM_STREAM);
+
     // Update game objects
-    for (auto it = chunkMatrix->voxelObjects.begin(); it != chunkMatrix->voxelObjects.end(); ) {
-        VoxelObject* voxelObject = *it;
-        if (voxelObject->IsEnabled()) {
-            if (!voxelObject->Update(*chunkMatrix)) {
-                it = chunkMatrix->voxelObjects.erase(it);
-
-                PhysicsObject* physicsObject = dynamic_cast<PhysicsObject*>(voxelObject);
-                if (physicsObject) {
-                    GameEngine::instance->chunkMatrix->physicsObjects.remove(physicsObject);
+    {
+        PROFILE_SCOPE("Voxel objects");
+        for (auto it = chunkMatrix->voxelObjects.begin(); it != chunkMatrix->voxelObjects.end(); ) {
+            VoxelObject* voxelObject = *it;
+            if (voxelObject->IsEnabled()) {
+                if (!voxelObject->Update(*chunkMatrix)) {
+                    it = chunkMatrix->voxelObjects.erase(it);
+
+                    PhysicsObject* physicsObject = voxelObject->AsPhysicsObject();
+                    if (physicsObject) {
+                        GameEngine::instance->chunkMatrix->physicsObjects.remove(physicsObject);
+                    }
+
+                    delete voxelObject;
+                    continue;
                 }
-
-                delete voxelObject;
-                continue;
             }
+            ++it;
         }
-        ++it;
     }
 
-    //Reset voxels to default pre-simulation state
-    #pragma omp parallel for
-    for(uint8_t i = 0; i < 4; ++i)
-    {
-        for (auto& chunk : chunkMatrix->GridSegmented[i]) {
-            // decrease lastCheckedCountDown, this slowly kills unused chunks
-            if(chunk->lastCheckedCountDown > 0 ) chunk->lastCheckedCountDown -= 1;
+    // objects move on the main thread while the voxel pass runs, take their positions now
+    for (Volume::Chunk *chunk : chunkMatrix->Grid)
+        chunk->UpdateVoxelObjectsInChunk(chunkMatrix->voxelObjects);
 
-            if (!chunk->dirtyRect.IsEmpty())
-                chunk->SIM_ResetVoxelUpdateData();
-        }
+    // every voxel stepped before this counts as not updated, no voxel has to be reset
+    Volume::VoxelElement::AdvanceUpdateTick();
+
+    // decrease lastCheckedCountDown, this slowly kills unused chunks
+    for (auto& chunk : chunkMatrix->Grid) {
+        if(chunk->lastCheckedCountDown > 0 ) chunk->lastCheckedCountDown -= 1;
     }
 
     //delete all chunks marked for deletion
-    for(int32_t i = static_cast<size_t>(chunkMatrix->Grid.size()) - 1; i >= 0; --i){
-        if(chunkMatrix->Grid[i]->ShouldChunkDelete(GameEngine::renderer->GetCameraAABB()))
-            chunkMatrix->DeleteChunk(chunkMatrix->Grid[i]->GetPos());
+    // headless engines have no camera, chunks stay until DeleteChunk is called
+    {
+        PROFILE_SCOPE("Chunk deletion");
+        for(int32_t i = static_cast<size_t>(chunkMatrix->Grid.size()) - 1; i >= 0 && GameEngine::renderer; --i){
+            if(chunkMatrix->Grid[i]->ShouldChunkDelete(GameEngine::renderer->GetCameraAABB()))
+                chunkMatrix->DeleteChunk(chunkMatrix->Grid[i]->GetPos());
+        }
     }
 
     //Voxel update logic
-    for(uint8_t i = 0; i < 4; ++i) UpdateGridVoxel(i);
+    {
+        // the voxel pass only needs chunk locks, physics, GPU results and edits of the main thread
+        // keep going on the chunks it is not touching
+        this->chunkMatrix->voxelMutex.unlock();
+        {
+            std::shared_lock<Debug::TracedSharedMutex> lock(this->chunkMatrix->voxelMutex);
+            PROFILE_SCOPE("Voxels");
+            this->UpdateGridVoxels();
+        }
+        this->chunkMatrix->voxelMutex.lock();
+    }
 
     // Update colliders for all chunks
     //TODO: make multithreaded
-    for(size_t i = 0; i < chunkMatrix->Grid.size(); ++i) {
-        if(chunkMatrix->Grid[i]->dirtyColliders)
-            physics->Generate2DCollidersForChunk(chunkMatrix->Grid[i]);
+    {
+        PROFILE_SCOPE("Colliders");
+        for(size_t i = 0; i < chunkMatrix->Grid.size(); ++i) {
+            if(chunkMatrix->Grid[i]->dirtyColliders)
+                physics->Generate2DCollidersForChunk(chunkMatrix->Grid[i]);
+        }
     }
 
     // Update render buffers
-    this->openGLMutex.lock();
-    for (size_t i = 0; i < chunkMatrix->Grid.size(); ++i) {
-        auto& chunk = chunkMatrix->Grid[i];
+    {
+        PROFILE_SCOPE("Render data");
+        // CPU side only, every chunk touches just its own data
+        this->taskScheduler->ParallelFor(static_cast<uint32_t>(chunkMatrix->Grid.size()), [this](uint32_t i) {
+            auto& chunk = chunkMatrix->Grid[i];
+
+            // chunks that stayed idle long enough drop their voxels
+            if(chunk->idleTicks >= Volume::Chunk::COMPRESS_AFTER_IDLE_TICKS)
+                chunk->TryCompress();
+
+            if(GameEngine::renderer)
+                chunk->UpdateRenderCPUData();
+        });
+    }
+
+    {
+        PROFILE_SCOPE("Particles");
+        chunkMatrix->SeedVoxelRandom(ChunkMatrix::PARTICLE_RANDOM_STREAM);
+        chunkMatrix->UpdateParticles();
+    }
+
+    if(this->config.worldChecksums){
+        PROFILE_SCOPE("Checksum");
+        chunkMatrix->worldChecksum = chunkMatrix->ComputeWorldChecksum();
+        chunkMatrix->rollingChecksum = Random::Mix(chunkMatrix->rollingChecksum, chunkMatrix->worldChecksum);
+    }
+
+    chunkMatrix->simulationTick++;
+
+    if(GameEngine::renderer){
+        PROFILE_SCOPE("Render snapshot");
+        this->PublishRenderSnapshot();
+    }
+
+    // the allocator counts on its own, only the difference belongs to this tick
+    Volume::VoxelAllocatorStats allocatorStats = Volume::VoxelAllocator::GetStats();
+    Debug::Stats::Add(Debug::StatCounter::VoxelAllocations, allocatorStats.allocations - this->flushedAllocatorStats.allocations);
+    Debug::Stats::Add(Debug::StatCounter::VoxelFrees, allocatorStats.frees - this->flushedAllocatorStats.frees);
+    this->flushedAllocatorStats = allocatorStats;
+
+    Debug::Stats::Set(Debug::StatCounter::ParticlesAlive, chunkMatrix->particles.size());
+    Debug::Stats::FlushTick(chunkMatrix->simulationTick);
+}
+
+/// @warning call with the voxel mutex locked
+void GameEngine::PublishRenderSnapshot()
+{
+    RenderSnapshot &snapshot = this->renderSnapshots.GetWriteSnapshot();
+    snapshot.Clear();
+    snapshot.tick = chunkMatrix->simulationTick;
+
+    snapshot.chunks.reserve(chunkMatrix->Grid.size());
+    for(Volume::Chunk *chunk : chunkMatrix->Grid){
+        chunk->ReleaseUploadedRenderData();
+        snapshot.chunks.push_back({ chunk, chunk->GetAABB(), chunk->GetRenderVersion(), chunk->GetRenderData() });
+    }
 
-        chunk->UpdateRenderCPUData();
+    for(VoxelObject *object : chunkMatrix->voxelObjects){
+        if(!object->ShouldRender()) continue;
+        const std::vector<Volume::VoxelRenderData> &voxels = object->GetRenderData();
+        snapshot.objectVoxels.insert(snapshot.objectVoxels.end(), voxels.begin(), voxels.end());
+    }
+    if(this->player && this->player->ShouldRender()){
+        const std::vector<Volume::VoxelRenderData> &voxels = this->player->GetRenderData();
+        snapshot.objectVoxels.insert(snapshot.objectVoxels.end(), voxels.begin(), voxels.end());
+    }
+
+    snapshot.particles.reserve(chunkMatrix->particles.size());
+    for(Particle::VoxelParticle *particle : chunkMatrix->particles){
+        snapshot.particles.push_back({
+            .position = glm::vec2(particle->GetPosition().x, particle->GetPosition().y),
+            .color = particle->color.getGLMVec4()
+        });
     }
-    this->openGLMutex.unlock();
 
-    chunkMatrix->UpdateParticles();
+    this->renderSnapshots.Publish();
 }
 
 void GameEngine::SetPauseVoxelSimulation(bool pause)
@@ -166,9 +296,12 @@ GameEngine::~GameEngine()
 {
     this->running = false;
     
-    simulationThread.join();
+    // engines driven by Tick never start the simulation thread
+    if(simulationThread.joinable())
+        simulationThread.join();
 
-    SDL_GL_DeleteContext(glContext);
+    if(glContext)
+        SDL_GL_DeleteContext(glContext);
 
     if(GameEngine::renderer){
         delete GameEngine::renderer;
@@ -211,38 +344,90 @@ void GameEngine::EndFrame()
 
 void GameEngine::Update(IGame& game)
 {
+    // input edits (explosions, fire) roll from the stream of the main thread, seed it from the tick
+    // the simulation thread advances, the tick only changes under the exclusive lock
+    if(this->chunkMatrix->IsDeterministic()){
+        std::shared_lock<Debug::TracedSharedMutex> lock(this->chunkMatrix->voxelMutex);
+        this->chunkMatrix->SeedVoxelRandom(ChunkMatrix::INPUT_RANDOM_STREAM);
+    }
+
     //Polls events - e.g. window close, keyboard input..
-    this->PollEvents();
-    
-    this->chunkMatrix->voxelMutex.lock();
+    if(GameEngine::renderer){
+        PROFILE_SCOPE("Poll events");
+        this->PollEvents();
+    }
     
+    // Insert chunks finished by the generation workers, their buffers are initialized below
+    if(this->chunkMatrix->IsDeterministic() || this->chunkMatrix->GetGeneratedChunkCount() > 0){
+        {
+            PROFILE_SCOPE("Wait for voxel lock");
+            this->chunkMatrix->voxelMutex.lock();
+        }
+        PROFILE_SCOPE("Commit chunks");
+        this->chunkMatrix->CommitGeneratedChunks();
+        this->chunkMatrix->voxelMutex.unlock();
+    }
+
+    // nothing below changes the chunk set, every voxel and object write locks the chunks it touches
+    {
+        PROFILE_SCOPE("Wait for voxel lock");
+        this->chunkMatrix->voxelMutex.lock_shared();
+    }
+
     // Run physics simulation
-    physics->Step(this->deltaTime, *this->chunkMatrix);
+    {
+        PROFILE_SCOPE("Physics step");
+        physics->Step(this->deltaTime, *this->chunkMatrix);
+    }
 
     // update voxelobjects rotation
-    for(VoxelObject* object : chunkMatrix->voxelObjects) {
-        if(object->IsEnabled()) {
-            object->UpdateRotatedVoxelBuffer();
+    {
+        PROFILE_SCOPE("Object rotation");
+        for(VoxelObject* object : chunkMatrix->voxelObjects) {
+            if(object->IsEnabled()) {
+                Volume::ChunkLockGuard chunkLocks = chunkMatrix->LockChunksInArea(object->GetBoundingBox().Expand(2));
+                object->UpdateRotatedVoxelBuffer();
+            }
         }
     }
 
     //Physics
-    for(PhysicsObject* object : chunkMatrix->physicsObjects) {
-        if(object->IsEnabled()) {
-            object->UpdatePhysicsEffects(*chunkMatrix, deltaTime);
+    {
+        PROFILE_SCOPE("Physics effects");
+        for(PhysicsObject* object : chunkMatrix->physicsObjects) {
+            if(object->IsEnabled()) {
+                Volume::ChunkLockGuard chunkLocks = chunkMatrix->LockChunksInArea(object->GetBoundingBox().Expand(2));
+                object->UpdatePhysicsEffects(*chunkMatrix, deltaTime);
+            }
         }
     }
-    this->chunkMatrix->voxelMutex.unlock();
+    this->chunkMatrix->voxelMutex.unlock_shared();
+
+    {
+        PROFILE_SCOPE("Game update");
+        game.Update(this->deltaTime);
+    }
 
-    game.Update(this->deltaTime);
+    // Load chunks the camera is moving towards
+    if(renderer){
+        PROFILE_SCOPE("Chunk prefetch");
+        Vec2f playerVelocity = Vec2f(0, 0);
+        if(this->player && this->player->AsPhysicsObject())
+            playerVelocity = this->player->AsPhysicsObject()->GetLinearVelocity();
+        renderer->UpdateChunkPrefetch(*this->chunkMatrix, playerVelocity, this->deltaTime);
+    }
 
     // Fixed update
     fixedUpdateTimer += deltaTime;
     voxelUpdateTimer += deltaTime;
     if (fixedUpdateTimer >= fixedDeltaTime)
     {
+        PROFILE_SCOPE("Fixed update");
         FixedUpdate(game);
-        game.FixedUpdate(this->fixedDeltaTime);
+        {
+            PROFILE_SCOPE("Game fixed update");
+            game.FixedUpdate(this->fixedDeltaTime);
+        }
         fixedUpdateTimer -= fixedDeltaTime;
     }
 
@@ -252,13 +437,17 @@ void GameEngine::Update(IGame& game)
     }
 
     // Initialize any chunks that are not yet initialized
-    while (!chunkMatrix->newUninitializedChunks.empty()) {
-        auto chunk = chunkMatrix->newUninitializedChunks.front();
-        chunkMatrix->newUninitializedChunks.pop();
-
-        if (!chunk->IsInitialized()) {
-            std::lock_guard<std::mutex> lock(this->openGLMutex);
-            chunk->InitializeBuffers();
+    {
+        PROFILE_SCOPE("Chunk buffers");
+        while (!chunkMatrix->newUninitializedChunks.empty()) {
+            auto chunk = chunkMatrix->newUninitializedChunks.front();
+            chunkMatrix->newUninitializedChunks.pop();
+
+            // headless chunks never get render or compute buffers
+            if (!chunk->IsInitialized() && GameEngine::renderer) {
+                std::lock_guard<Debug::TracedMutex> lock(this->openGLMutex);
+                chunk->InitializeBuffers();
+            }
         }
     }
 
@@ -268,19 +457,80 @@ void GameEngine::Update(IGame& game)
     if(voxelUpdateTimer > voxelFixedDeltaTime*2.5f && consoleTimerWarnings && !this->pauseVoxelSimulation)
         Debug::LogSpam("Voxel Simulation update timer is too high: " + std::to_string(voxelUpdateTimer));
 }
-void GameEngine::UpdateGridVoxel(int pass)
-{    
-    #pragma omp parallel for
-    for (size_t i = 0; i < chunkMatrix->GridSegmented[pass].size(); ++i) {
-        auto& chunk = chunkMatrix->GridSegmented[pass][i];
+void GameEngine::UpdateGridVoxels()
+{
+    // chunks of the same pass can still reach into the same neighbour, the order has to be fixed
+    if(chunkMatrix->IsDeterministic()){
+        for(uint8_t pass = 0; pass < 4; ++pass)
+            for(Volume::Chunk *chunk : chunkMatrix->GridSegmented[pass])
+                this->UpdateChunkVoxels(chunk);
+        return;
+    }
 
-        chunk->UpdateVoxels(this->chunkMatrix);
-        
-        chunk->dirtyRect.Update();
+    {
+        PROFILE_SCOPE("Build chunk graph");
+        this->BuildChunkGraph();
+    }
+
+    this->taskScheduler->Run(this->chunkGraph, [this](uint32_t task) {
+        this->UpdateChunkVoxels(this->chunkGraphChunks[task]);
+    });
+}
+
+void GameEngine::UpdateChunkVoxels(Volume::Chunk *chunk)
+{
+    TRACE_SCOPE("Update chunk");
+
+    // voxels move into the neighbours, which only other tasks ordered by the chunk graph share
+    Volume::ChunkLockGuard chunkLocks;
+    chunkLocks.AddExclusive(chunk);
+    for(uint8_t direction = 0; direction < static_cast<uint8_t>(Volume::ChunkNeighbor::Count); ++direction){
+        if(Volume::Chunk *neighbor = chunk->GetNeighbor(static_cast<Volume::ChunkNeighbor>(direction)))
+            chunkLocks.AddShared(neighbor);
+    }
+    chunkLocks.Lock();
+
+    chunk->UpdateVoxels(this->chunkMatrix);
+    chunk->dirtyTiles.Update();
+}
+
+/// @brief Orders every chunk after its neighbours of earlier passes, the same order the passes
+/// had. Neighbours never run at the same time, and a chunk starts as soon as they are done
+/// instead of waiting for the slowest chunk of the previous pass
+void GameEngine::BuildChunkGraph()
+{
+    this->chunkGraphChunks.clear();
+    this->chunkGraphIndices.clear();
+    for(uint8_t pass = 0; pass < 4; ++pass){
+        for(Volume::Chunk *chunk : chunkMatrix->GridSegmented[pass]){
+            this->chunkGraphIndices[chunk] = static_cast<uint32_t>(this->chunkGraphChunks.size());
+            this->chunkGraphChunks.push_back(chunk);
+        }
+    }
+
+    this->chunkGraph.Reset(this->chunkGraphChunks.size());
+    for(uint32_t i = 0; i < this->chunkGraphChunks.size(); ++i){
+        Volume::Chunk *chunk = this->chunkGraphChunks[i];
+
+        // neighbours never share a pass and the tasks are numbered pass by pass,
+        // a lower index is an earlier pass
+        for(uint8_t direction = 0; direction < static_cast<uint8_t>(Volume::ChunkNeighbor::Count); ++direction){
+            Volume::Chunk *neighbor = chunk->GetNeighbor(static_cast<Volume::ChunkNeighbor>(direction));
+            if(!neighbor) continue;
+
+            auto it = this->chunkGraphIndices.find(neighbor);
+            if(it != this->chunkGraphIndices.end() && it->second < i)
+                this->chunkGraph.AddDependency(it->second, i);
+        }
+
+        // sleeping chunks only do bookkeeping, they do not need a task of their own
+        this->chunkGraph.SetInline(i, chunk->dirtyTiles.IsEmpty());
     }
 }
 void GameEngine::SimulationThread(IGame& game)
 {
+    Debug::TraceRecorder::SetThreadName("Simulation");
+
     while (this->running)
     {
         if (voxelUpdateTimer < voxelFixedDeltaTime || this->pauseVoxelSimulation) {
@@ -289,13 +539,18 @@ void GameEngine::SimulationThread(IGame& game)
         }
         voxelUpdateTimer -= voxelFixedDeltaTime;
 
+        PROFILE_BEGIN_FRAME(Debug::ProfileTrack::Simulation);
         chunkMatrix->voxelMutex.lock();
         
         this->VoxelSimulationStep();
 
         chunkMatrix->voxelMutex.unlock();
 
-        game.VoxelUpdate(this->voxelFixedDeltaTime);
+        {
+            PROFILE_SCOPE("Game voxel update");
+            game.VoxelUpdate(this->voxelFixedDeltaTime);
+        }
+        PROFILE_END_FRAME();
 
         // Give the thread a time to breathe
         std::this_thread::sleep_for(std::chrono::milliseconds(2));
@@ -304,6 +559,8 @@ void GameEngine::SimulationThread(IGame& game)
 void GameEngine::ChangeChunkMatrix(ChunkMatrix *newMatrix)
 {
     newMatrix->Initialize(this->config.disableGPUSimulations);
+    if(this->config.deterministicSimulation)
+        newMatrix->EnableDeterministicSimulation(this->config.simulationSeed);
 
     ChunkMatrix* oldMatrix = this->chunkMatrix;
     oldMatrix->voxelMutex.lock();
@@ -312,6 +569,9 @@ void GameEngine::ChangeChunkMatrix(ChunkMatrix *newMatrix)
     oldMatrix->isActive = false;
     this->futureChunkMatrix->isActive = true;
 
+    // the snapshots point into the chunks of the old matrix
+    this->renderSnapshots.Reset();
+
     this->chunkMatrix = this->futureChunkMatrix;
     this->futureChunkMatrix = nullptr;
 
@@ -322,10 +582,11 @@ void GameEngine::ChangeChunkMatrix(ChunkMatrix *newMatrix)
 }
 void GameEngine::FixedUpdate(IGame &game)
 {
-    std::lock_guard<std::mutex> lock(this->chunkMatrix->chunkCreationMutex);
-    std::lock_guard<std::mutex> lock2(this->chunkMatrix->voxelMutex);
+    // the GPU simulations lock the chunks they read and write one by one
+    std::shared_lock<Debug::TracedSharedMutex> lock(this->chunkMatrix->voxelMutex);
 
     // Run heat and pressure simulation
+    PROFILE_SCOPE("GPU simulations");
     this->chunkMatrix->RunGPUSimulations();
 }
 
@@ -375,6 +636,9 @@ void GameEngine::PollEvents()
                 case SDLK_d:
                     GameEngine::MovementKeysHeld[3] = true;
                     break;
+                case SDLK_F2:
+                    if(!this->windowEvent.key.repeat) Debug::TraceRecorder::Capture();
+                    break;
                 }
                 currentGame->OnKeyboardDown(this->windowEvent.key.keysym.sym);
                 break;
@@ -431,9 +695,13 @@ void GameEngine::PollEvents()
 
 void GameEngine::Render()
 {
-    chunkMatrix->voxelMutex.lock();
-    GameEngine::renderer->Render(*chunkMatrix, this->mousePos, this->currentGame);
-    chunkMatrix->voxelMutex.unlock();
+    PROFILE_SCOPE("Render");
+    // the simulation keeps running meanwhile, the frame only reads the newest render snapshot
+    const RenderSnapshot *snapshot = this->renderSnapshots.AcquireLatest();
+    chunkMatrix->FreeRetiredChunks(snapshot ? snapshot->tick : UINT64_MAX);
+
+    static const RenderSnapshot EMPTY_SNAPSHOT;
+    GameEngine::renderer->Render(snapshot ? *snapshot : EMPTY_SNAPSHOT, *chunkMatrix, this->mousePos, this->currentGame);
 }
 
 void GameEngine::StartSimulationThread(IGame& game)
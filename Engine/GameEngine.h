@@ -4,6 +4,8 @@
 #include <mutex>
 #include <atomic>
 #include <list>
+#include <memory>
+#include <unordered_map>
 
 #include <GL/glew.h>
 
@@ -17,12 +19,16 @@
 #include <box2d/types.h>
 
 #include "Debug/Logger.h"
+#include "Debug/Profiler.h"
+#include "Debug/Stats.h"
 #include "Rendering/Renderer.h"
 #include "Math/Vector.h"
 #include "Math/AABB.h"
 #include "World/Chunk.h"
 #include "World/ChunkMatrix.h"
 #include "Physics/Physics.h"
+#include "Threading/TaskScheduler.h"
+#include "Rendering/RenderSnapshot.h"
 
 #define AVG_FPS_SIZE_COUNT 25
 
@@ -108,12 +114,19 @@ namespace Config{
         bool automaticLoadingOfChunksInView = true;
         bool automaticLoadingOfChunksFromEvents = true;
         bool disableGPUSimulations = false;
+        bool headless = false; // no window, GL context or rendering, implies disableGPUSimulations
+        std::string saveDirectory = ""; // evicted chunks are stored here, empty to regenerate them instead
         float fixedDeltaTime = 3.0f / 30.0f;
         float voxelFixedDeltaTime = 1.0f / 30.0f;
 
         bool pauseVoxelSimulation = false;
         EnabledEngineFeatures enabledFeatures = EnabledEngineFeatures::ALL;
 
+        bool deterministicSimulation = false; // seeded random streams, fixed chunk order, single threaded voxel updates
+        uint64_t simulationSeed = 0; // only used with deterministicSimulation
+        bool worldChecksums = false; // hash the world after every voxel simulation step (ChunkMatrix::worldChecksum)
+        unsigned int workerThreads = 0; // task scheduler threads besides the calling one, 0 for one less than the hardware threads
+
         bool consoleTimerWarnings = false;
     };
 }
@@ -124,7 +137,7 @@ private:
     Config::EngineConfig config;
     IGame *currentGame = nullptr;
 
-    SDL_GLContext glContext;
+    SDL_GLContext glContext = nullptr;
     SDL_Event windowEvent;
     Uint64 LastFrameEndTime = SDL_GetPerformanceCounter();
 
@@ -133,6 +146,19 @@ private:
 
     std::thread simulationThread;
 
+    std::unique_ptr<Threading::TaskScheduler> taskScheduler;
+    // rebuilt every voxel step, a chunk runs once its neighbours of earlier passes finished
+    Threading::TaskGraph chunkGraph;
+    std::vector<Volume::Chunk*> chunkGraphChunks;
+    std::unordered_map<Volume::Chunk*, uint32_t> chunkGraphIndices;
+
+    // allocator totals at the last stats flush
+    Volume::VoxelAllocatorStats flushedAllocatorStats;
+
+    // written by the simulation thread after every tick, drawn by the main thread without the voxel mutex
+    RenderSnapshotBuffer renderSnapshots;
+    void PublishRenderSnapshot();
+
     bool pauseVoxelSimulation = false;
 
     // Mouse position in screen coordinates
@@ -143,8 +169,10 @@ private:
     float fixedUpdateTimer = 0;
     std::atomic<float> voxelUpdateTimer = 0;
 
-    //Deletes old chunks and updates steps for voxel celluar automata simulation
-    void UpdateGridVoxel(int pass);
+    //Updates the voxel celluar automata of every chunk
+    void UpdateGridVoxels();
+    void UpdateChunkVoxels(Volume::Chunk *chunk);
+    void BuildChunkGraph();
 
     //Fixed update, Handles heat and pressure simulation
     void FixedUpdate(IGame& game);
@@ -168,7 +196,7 @@ public:
     static GameEngine* instance;
 
     // Mutex for OpenGL context access from multiple threads
-    std::mutex openGLMutex;
+    Debug::TracedMutex openGLMutex{"Wait openGLMutex"};
 
     static constexpr int MAX_FRAME_RATE = 60;
     float fixedDeltaTime;
@@ -199,6 +227,14 @@ public:
 
     void Run(IGame& game, const Config::EngineConfig& config);
 
+    /// @brief Initializes the engine and the registries without starting the game loop or the simulation thread
+    /// @note The engine is then driven by `GameEngine::Tick`. Meant for headless tools like benchmarks and servers
+    void Start(IGame& game, const Config::EngineConfig& config);
+    /// @brief Runs one frame and one voxel simulation step on the calling thread, `voxelFixedDeltaTime` is used as the frame time
+    /// @warning Only for engines started with `GameEngine::Start`
+    void Tick();
+
+    /// @warning Call with the voxel mutex locked exclusively, it is only held shared during the voxel pass
     void VoxelSimulationStep();
 
     void SetPauseVoxelSimulation(bool pause);
@@ -208,6 +244,11 @@ public:
     VoxelObject *GetPlayer() const { return player; };
     ~GameEngine();
 
+    /// @brief Headless engines have no `GameEngine::renderer`, window or GL context
+    bool IsHeadless() const { return config.headless; }
+    /// @brief Shared worker pool of the engine, runs one graph or parallel loop at a time
+    Threading::TaskScheduler& GetTaskScheduler() { return *taskScheduler; }
+
     ChunkMatrix* GetActiveChunkMatrix();
     ChunkMatrix* SetActiveChunkMatrix(ChunkMatrix* matrix);
 
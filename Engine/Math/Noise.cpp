@@ -1,5 +1,7 @@
 #include "Noise.h"
 
+#include <cmath>
+
 inline unsigned int Hash(int x, int y, int seed) {
     unsigned int h = x * 374761393u + y * 668265263u + seed * 951274213u; 
     h = (h ^ (h >> 13u)) * 1274126177u;
@@ -1,22 +1,77 @@
 #pragma once
 
-#include <random>
+#include <cstdint>
 
+/// @brief xoshiro128++ generator, 16 bytes of state and a handful of instructions per number
+/// @note Not thread safe, every thread (or chunk) needs its own instance. The bounded helpers trade
+/// a bias far below anything the simulation can notice for not having to loop
 class Random
 {
 private:
-    unsigned int seed;
-    std::mt19937 generator;
+    uint32_t state[4] = {};
+
+    static constexpr uint32_t RotateLeft(uint32_t value, int shift)
+    {
+        return (value << shift) | (value >> (32 - shift));
+    }
 public:
     Random();
-    Random(int seed);
-    ~Random();
+    constexpr explicit Random(uint64_t seed) { this->SetSeed(seed); }
+
+    /// @brief Expands the seed with SplitMix64, any seed (including 0) gives a usable state
+    constexpr void SetSeed(uint64_t seed)
+    {
+        for(int i = 0; i < 4; i += 2){
+            uint64_t mixed = Mix(seed, i);
+            this->state[i] = static_cast<uint32_t>(mixed);
+            this->state[i + 1] = static_cast<uint32_t>(mixed >> 32);
+        }
+    }
+
+    /// @brief Hashes a value into a seed, chain calls to combine several values (e.g. seed, position, tick)
+    static constexpr uint64_t Mix(uint64_t seed, uint64_t value)
+    {
+        uint64_t z = seed + (value + 1) * 0x9E3779B97F4A7C15ull;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    uint32_t GetUInt()
+    {
+        const uint32_t result = RotateLeft(this->state[0] + this->state[3], 7) + this->state[0];
+        const uint32_t t = this->state[1] << 9;
+
+        this->state[2] ^= this->state[0];
+        this->state[3] ^= this->state[1];
+        this->state[1] ^= this->state[2];
+        this->state[0] ^= this->state[3];
+        this->state[2] ^= t;
+        this->state[3] = RotateLeft(this->state[3], 11);
+
+        return result;
+    }
+
+    /// @param min minimum value (inclusive)
+    /// @param max maximum value (exclusive)
+    float GetFloat(float min, float max)
+    {
+        // 24 random bits fill the float mantissa
+        return min + (this->GetUInt() >> 8) * (1.0f / 16777216.0f) * (max - min);
+    }
+
+    /// @param min minimum value (inclusive)
+    /// @param max maximum value (inclusive)
+    int GetInt(int min, int max)
+    {
+        const uint32_t range = static_cast<uint32_t>(max) - static_cast<uint32_t>(min) + 1;
+        if(range == 0) return static_cast<int>(this->GetUInt());
 
-    void SetSeed(unsigned int seed);
+        // multiply-shift maps the 32 bit number onto the range without a division
+        return min + static_cast<int>((static_cast<uint64_t>(this->GetUInt()) * range) >> 32);
+    }
 
-    float GetFloat(float min, float max);
-    int GetInt(int min, int max);
-    bool GetBool();
+    bool GetBool() { return (this->GetUInt() >> 31) != 0; }
 
     // disable copy and move semantics
     Random(const Random&) = delete;
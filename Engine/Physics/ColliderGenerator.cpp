@@ -1,5 +1,6 @@
 #include "ColliderGenerator.h"
 
+#include <cmath>
 #include <queue>
 
 #include "Physics/Physics.h"
@@ -6,6 +6,7 @@
 
 #include "Physics.h"
 #include "GameEngine.h"
+#include "Debug/Stats.h"
 #include "Physics/ColliderGenerator.h"
 
 GamePhysics::GamePhysics()
@@ -36,14 +37,9 @@ void GamePhysics::Generate2DCollidersForChunk(Volume::Chunk *chunk)
 
     bool grid   [Volume::Chunk::CHUNK_SIZE+GRID_PADDING_FILL][Volume::Chunk::CHUNK_SIZE+GRID_PADDING_FILL] = {false};
 
-    for(int y = 0; y < Volume::Chunk::CHUNK_SIZE+GRID_PADDING_FILL; ++y) {
-        for(int x = 0; x < Volume::Chunk::CHUNK_SIZE+GRID_PADDING_FILL; ++x) {
-
-            if( y < Volume::Chunk::CHUNK_SIZE && x < Volume::Chunk::CHUNK_SIZE &&
-                    chunk->voxels[y][x] && chunk->voxels[y][x]->IsSolidCollider()) {
-                grid[y][x] = true;
-            }
-            
+    for(int y = 0; y < Volume::Chunk::CHUNK_SIZE; ++y) {
+        for(int x = 0; x < Volume::Chunk::CHUNK_SIZE; ++x) {
+            grid[y][x] = (chunk->GetVoxelFlags(Volume::ChunkVoxelStorage::Index(x, y)) & Volume::VoxelFlags::SOLID_COLLIDER) != 0;
         }
     }
 
@@ -100,6 +96,7 @@ void GamePhysics::Generate2DCollidersForChunk(Volume::Chunk *chunk)
     }
     // STEP 7: Update the chunk's physics body with the generated triangles
     chunk->UpdateColliders(allTriangleColliders, allEdges, worldId);
+    Debug::Stats::Add(Debug::StatCounter::ColliderRegenerations);
 }
 
 void GamePhysics::Generate2DCollidersForVoxelObject(PhysicsObject *object, ChunkMatrix* chunkMatrix)
@@ -155,6 +152,10 @@ void GamePhysics::Generate2DCollidersForVoxelObject(PhysicsObject *object, Chunk
     
     // remove all non-prominent voxel groups
     if(object->CanBreakIntoParts()){
+        // the voxel pass can run at the same time, the ejected voxels land (and push voxels aside)
+        // inside the chunks around the object
+        Volume::ChunkLockGuard chunkLocks = chunkMatrix->LockChunksInArea(
+            object->GetBoundingBox().Expand(static_cast<float>(ChunkMatrix::EDIT_LOCK_MARGIN + 1)));
         for(int y = 0; y < static_cast<int>(object->voxels.size()); ++y) {
             for(int x = 0; x < static_cast<int>(object->voxels[0].size()); ++x) {
                 if(labels[y][x] != maxLabel) { // any other label than the most prominent one get removed
@@ -166,9 +167,9 @@ void GamePhysics::Generate2DCollidersForVoxelObject(PhysicsObject *object, Chunk
                         voxel->position += Vec2i(object->GetPosition().x, object->GetPosition().y) -
                             Vec2i(object->GetSize().x / 2, object->GetSize().y / 2);
 
-                        Volume::VoxelSolid* solidVoxel = dynamic_cast<Volume::VoxelSolid*>(voxel);
+                        Volume::VoxelSolid* solidVoxel = voxel->AsSolid();
                         if(solidVoxel)
-                            solidVoxel->isStatic = false;
+                            solidVoxel->SetStatic(false);
 
                         chunkMatrix->PlaceVoxelAt(
                             voxel,
@@ -223,10 +224,12 @@ void GamePhysics::Generate2DCollidersForVoxelObject(PhysicsObject *object, Chunk
     }
     // STEP 7: Update the object's physics body with the generated triangles
     object->UpdateColliders(allTriangleColliders, allEdges, worldId);
+    Debug::Stats::Add(Debug::StatCounter::ColliderRegenerations);
 }
 
 /// @brief Steps the physics simulation forward by a given time step
 /// @param deltaTime        time step for the simulation
+/// @note Runs with `voxelMutex` held shared next to the voxel pass, voxel and object writes lock their chunks
 void GamePhysics::Step(float deltaTime, ChunkMatrix& chunkMatrix)
 {
     for(PhysicsObject* obj : chunkMatrix.physicsObjects) {
@@ -240,6 +243,8 @@ void GamePhysics::Step(float deltaTime, ChunkMatrix& chunkMatrix)
     // Update all physics object locations
     for(PhysicsObject* obj : chunkMatrix.physicsObjects) {
         if(b2Body_IsEnabled(obj->GetPhysicsBodyId())) {
+            // the voxel pass reads object voxels at the object position
+            Volume::ChunkLockGuard chunkLocks = chunkMatrix.LockChunksInArea(obj->GetBoundingBox().Expand(2));
             obj->UpdatePhysicPosition(worldId);
         }
     }
@@ -63,14 +63,14 @@ void Registry::VoxelObjectRegistry::GetVoxelsFromFiles(std::vector<std::vector<V
             RGBA color = RGBA(colorPixel);
 
             if(color.a == 0) {
-                elements[y][x] = { "", color }; // Transparent pixel
+                elements[y][x] = { Volume::INVALID_MATERIAL_ID, color }; // Transparent pixel
                 continue; // Skip transparent pixels
             }
 
             uint32_t materialId = materialPixel;
 
             VoxelData data = {
-                .id = GetVoxelFromColorID(materialId),
+                .id = VoxelRegistry::GetMaterialID(GetVoxelFromColorID(materialId)),
                 .color = color
             };
 
@@ -105,20 +105,20 @@ void Registry::VoxelObjectRegistry::GetVoxelsFromFile(std::vector<std::vector<Vo
             RGBA color = RGBA(pixel);
 
             if(color.a == 0) {
-                elements[y][x] = { "", color }; // Transparent pixel
+                elements[y][x] = { Volume::INVALID_MATERIAL_ID, color }; // Transparent pixel
                 continue; // Skip transparent pixels
             }
 
             VoxelData data;
             if(loadingColor){
                 data = {
-                    .id = "",
+                    .id = Volume::INVALID_MATERIAL_ID,
                     .color = color
                 };
             } else{
                 uint32_t materialId = pixel;
                 data = {
-                    .id = GetVoxelFromColorID(materialId),
+                    .id = VoxelRegistry::GetMaterialID(GetVoxelFromColorID(materialId)),
                     .color = RGBA(0, 0, 0, 0)
                 };
             }
@@ -19,7 +19,7 @@ namespace Registry
         Custom              // Uses custom constructor
     };
     struct VoxelData{
-        std::string id;
+        Volume::MaterialID id = Volume::INVALID_MATERIAL_ID; // INVALID_MATERIAL_ID = no voxel
         RGBA color;
     };
     struct VoxelObjectProperty{
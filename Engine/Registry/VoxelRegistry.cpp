@@ -2,6 +2,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <algorithm>
+#include <cassert>
 
 #include "World/Voxels/Empty.h"
 #include "VoxelObjectRegistry.h"
@@ -14,20 +15,27 @@ using namespace Registry;
 // Initialize the voxel properties
 
 std::unordered_map<std::string, VoxelProperty> VoxelRegistry::registry = {};
-std::unordered_map<uint32_t, VoxelProperty*> VoxelRegistry::idRegistry = {};
+std::unordered_map<MaterialID, VoxelProperty*> VoxelRegistry::idRegistry = {};
 std::unordered_map<std::string, VoxelFactory> VoxelRegistry::voxelFactories = {};
 std::unordered_map<std::string, VoxelTextureMap*> VoxelRegistry::textureMaps = {};
 std::vector<Registry::ChemicalReaction> VoxelRegistry::reactionRegistry = {};
+std::vector<VoxelProperty> VoxelRegistry::properties = {};
+std::vector<std::string> VoxelRegistry::stringIDs = {};
+std::unordered_map<std::string, MaterialID> VoxelRegistry::materialIDs = {};
+MaterialTable VoxelRegistry::materialTable = {};
 Shader::GLBuffer<Registry::VoxelRegistry::ChemicalReactionGL, GL_SHADER_STORAGE_BUFFER>* 
 	Registry::VoxelRegistry::chemicalReactionsGLBuffer = nullptr;
 
-uint32_t VoxelRegistry::idCounter = 1;
+MaterialID VoxelRegistry::idCounter = 1;
 bool VoxelRegistry::registryClosed = false;
+bool VoxelRegistry::registryFrozen = false;
 
 void VoxelRegistry::RegisterVoxel(const std::string &id, VoxelProperty property)
 {
 	if(registryClosed) 
 		throw std::runtime_error("Voxel registered after designated time window: " + id);
+	if(idCounter >= MAX_MATERIAL_ID)
+		throw std::runtime_error("Voxel registry is out of material ids: " + id);
 	
 	property.id = ++idCounter;
 
@@ -75,25 +83,42 @@ void VoxelRegistry::RegisterVoxels(IGame *game)
 	VoxelRegistry::RegisterVoxelFactory(
 		"Empty",
 		[](Vec2i position, Volume::Temperature temp, float amount, bool placeUnmovableSolids) {
-			return new EmptyVoxel(position);
+			return Volume::NewVoxel<EmptyVoxel>(position);
 		}
 	);
 
 	game->RegisterVoxels();
 }
 
-void Registry::VoxelRegistry::CloseRegistry()
+/// @param createGPUBuffers uploads the chemical reactions for the GPU simulation, needs a GL context
+void Registry::VoxelRegistry::CloseRegistry(bool createGPUBuffers)
 {
 	if(registryClosed) return;
 
 	registryClosed = true;
 
+	// resolve everything that was registered by string id, so the simulation never has to
+	for(auto& [id, property] : VoxelRegistry::registry){
+		if(property.HeatedChange.has_value())
+			property.HeatedChange->to = VoxelRegistry::GetMaterialID(property.HeatedChange->toName);
+		if(property.CooledChange.has_value())
+			property.CooledChange->to = VoxelRegistry::GetMaterialID(property.CooledChange->toName);
+
+		if(property.Constructor == DefaultVoxelConstructor::Custom){
+			std::string factoryID = property.specialFactoryID.empty() ? id : property.specialFactoryID;
+			property.factory = VoxelRegistry::FindFactoryWithID(factoryID);
+
+			if(property.factory == nullptr)
+				throw std::runtime_error("Voxel factory not found for id: " + factoryID + ". Did you forget use RegisterVoxelFactory?");
+		}
+	}
+
 	// get IDs for chemical reactions
 	std::vector<ChemicalReactionGL> reactions;
 	for(ChemicalReaction reaction : VoxelRegistry::reactionRegistry){
-		uint32_t from = VoxelRegistry::GetProperties(reaction.from)->id;
-		uint32_t catalyst = VoxelRegistry::GetProperties(reaction.catalyst)->id;
-		uint32_t to = VoxelRegistry::GetProperties(reaction.to)->id;
+		MaterialID from = VoxelRegistry::GetMaterialID(reaction.from);
+		MaterialID catalyst = VoxelRegistry::GetMaterialID(reaction.catalyst);
+		MaterialID to = VoxelRegistry::GetMaterialID(reaction.to);
 
 		reactions.push_back({
 			from,
@@ -122,12 +147,67 @@ void Registry::VoxelRegistry::CloseRegistry()
 	});
 
 	// Upload chemical reactions to a GPU buffer
-	VoxelRegistry::chemicalReactionsGLBuffer = new Shader::GLBuffer<ChemicalReactionGL, GL_SHADER_STORAGE_BUFFER>("Chemical Reactions Buffer");
-	VoxelRegistry::chemicalReactionsGLBuffer->SetData(reactions, GL_STATIC_DRAW);
+	if(createGPUBuffers){
+		VoxelRegistry::chemicalReactionsGLBuffer = new Shader::GLBuffer<ChemicalReactionGL, GL_SHADER_STORAGE_BUFFER>("Chemical Reactions Buffer");
+		VoxelRegistry::chemicalReactionsGLBuffer->SetData(reactions, GL_STATIC_DRAW);
+	}
 
 	// Clear reaction registry to free up memory
 	VoxelRegistry::reactionRegistry.clear();
 	std::vector<ChemicalReactionGL>().swap(reactions); // free memory
+
+	VoxelRegistry::FreezeRegistry();
+}
+
+/// @brief Moves all properties into the dense array indexed by id and fills the `MaterialTable`
+/// @warning invalidates every `VoxelProperty*` returned by `GetProperties` before this point
+void Registry::VoxelRegistry::FreezeRegistry()
+{
+	const size_t count = static_cast<size_t>(VoxelRegistry::idCounter) + 1;
+
+	VoxelRegistry::properties.resize(count);
+	VoxelRegistry::stringIDs.resize(count);
+	for(auto& [id, property] : VoxelRegistry::registry){
+		MaterialID numericId = property.id;
+		VoxelRegistry::stringIDs[numericId] = id;
+		VoxelRegistry::materialIDs[id] = numericId;
+		VoxelRegistry::properties[numericId] = std::move(property);
+	}
+	VoxelRegistry::registry.clear();
+	VoxelRegistry::idRegistry.clear();
+	VoxelRegistry::registryFrozen = true;
+
+	MaterialTable &table = VoxelRegistry::materialTable;
+	table.density.assign(count, 0.0f);
+	table.heatCapacity.assign(count, 0.0f);
+	table.heatConductivity.assign(count, 0.0f);
+	table.state.assign(count, State::Gas);
+	table.flamability.assign(count, 0);
+	table.fluidDispersionRate.assign(count, 0);
+
+	for(size_t i = 0; i < count; ++i){
+		const VoxelProperty &property = VoxelRegistry::properties[i];
+		if(property.id == INVALID_MATERIAL_ID) continue;
+
+		table.density[i] = property.Density;
+		table.heatCapacity[i] = property.heatCapacity;
+		table.heatConductivity[i] = property.heatConductivity;
+		table.flamability[i] = property.Flamability;
+		table.fluidDispersionRate[i] = property.FluidDispursionRate;
+
+		switch(property.Constructor){
+			case DefaultVoxelConstructor::GasVoxel: 	table.state[i] = State::Gas; break;
+			case DefaultVoxelConstructor::LiquidVoxel: 	table.state[i] = State::Liquid; break;
+			case DefaultVoxelConstructor::SolidVoxel: 	table.state[i] = State::Solid; break;
+			case DefaultVoxelConstructor::Custom: {
+				// the state of a custom voxel is only known by the voxel itself
+				VoxelElement *probe = (*property.factory)(vector::ZERO, Temperature(21), 1.0f, false);
+				table.state[i] = probe->GetState();
+				delete probe;
+				break;
+			}
+		}
+	}
 }
 
 VoxelFactory *Registry::VoxelRegistry::FindFactoryWithID(std::string id)
@@ -150,8 +230,14 @@ void Registry::VoxelRegistry::CleanupRegistry()
 	delete VoxelRegistry::chemicalReactionsGLBuffer;
 }
 
-VoxelProperty* VoxelRegistry::GetProperties(std::string id)
+VoxelProperty* VoxelRegistry::GetProperties(const std::string &id)
 {
+	if(VoxelRegistry::registryFrozen){
+		assert(VoxelRegistry::registryClosed && VoxelRegistry::registry.empty() && "frozen registry still holds open entries");
+		return &VoxelRegistry::properties[VoxelRegistry::GetMaterialID(id)];
+	}
+	assert(VoxelRegistry::properties.empty() && "open registry already holds frozen properties");
+
     auto it = VoxelRegistry::registry.find(id);
 	if(it == VoxelRegistry::registry.end()){
 		throw std::runtime_error("Voxel property not found for character id: " + id);
@@ -159,24 +245,51 @@ VoxelProperty* VoxelRegistry::GetProperties(std::string id)
 	return &it->second;
 }
 
-VoxelProperty *VoxelRegistry::GetProperties(uint32_t id)
+VoxelProperty *VoxelRegistry::GetProperties(MaterialID id)
 {
+	if(VoxelRegistry::registryFrozen){
+		assert(VoxelRegistry::registryClosed && VoxelRegistry::idRegistry.empty() && "frozen registry still holds open entries");
+		if(id == INVALID_MATERIAL_ID || id >= VoxelRegistry::properties.size())
+			throw std::runtime_error("Voxel property not found for numeric id: " + std::to_string(id));
+
+		return &VoxelRegistry::properties[id];
+	}
+
+	assert(VoxelRegistry::properties.empty() && "open registry already holds frozen properties");
     auto it = VoxelRegistry::idRegistry.find(id);
 
 	if(it == VoxelRegistry::idRegistry.end()){
-		throw std::runtime_error("Voxel property not found for numeric id: " + id);
+		throw std::runtime_error("Voxel property not found for numeric id: " + std::to_string(id));
 	}
 
 	return it->second;
 }
 
-std::string Registry::VoxelRegistry::GetStringID(uint32_t numericId)
+/// @brief Interns a string id, should only be used during registration and from UI code
+MaterialID Registry::VoxelRegistry::GetMaterialID(const std::string &id)
+{
+	if(VoxelRegistry::registryFrozen){
+		auto it = VoxelRegistry::materialIDs.find(id);
+		if(it == VoxelRegistry::materialIDs.end())
+			throw std::runtime_error("Voxel property not found for character id: " + id);
+
+		return it->second;
+	}
+
+	return VoxelRegistry::GetProperties(id)->id;
+}
+
+/// @brief Reverse lookup of a string id. Only meant for UI and debugging
+std::string Registry::VoxelRegistry::GetStringID(MaterialID numericId)
 {
-	VoxelProperty* it = VoxelRegistry::idRegistry.find(numericId)->second;
-	if(it == nullptr){
-		throw std::runtime_error("Voxel property not found for numeric id: " + std::to_string(numericId));
+	if(!VoxelRegistry::stringIDs.empty()){
+		if(numericId == INVALID_MATERIAL_ID || numericId >= VoxelRegistry::stringIDs.size())
+			throw std::runtime_error("Voxel property not found for numeric id: " + std::to_string(numericId));
+
+		return VoxelRegistry::stringIDs[numericId];
 	}
 
+	// registry is still open, fall back to a linear search
 	for(const auto& pair : VoxelRegistry::registry){
 		if(pair.second.id == numericId){
 			return pair.first;
@@ -191,11 +304,6 @@ bool VoxelRegistry::CanGetMovedByExplosion(State state)
     return state == State::Liquid || state == State::Solid;
 }
 
-bool VoxelRegistry::CanGetDestroyedByExplosion(std::string id, float explosionPower)
-{
-    return true;
-}
-
 bool VoxelRegistry::CanBeMovedBySolid(State state)
 {
     return state == State::Gas || state == State::Liquid;
@@ -228,13 +336,13 @@ VoxelBuilder &VoxelBuilder::SetColor(RGBA Color)
 
 VoxelBuilder &VoxelBuilder::PhaseUp(std::string To, Volume::Temperature Temperature)
 {
-	this->HeatedChange = { Temperature, To };
+	this->HeatedChange = PhaseChange{ Temperature, To };
 	return *this;
 }
 
 VoxelBuilder &VoxelBuilder::PhaseDown(std::string To, Volume::Temperature Temperature)
 {
-	this->CooledChange = { Temperature, To };
+	this->CooledChange = PhaseChange{ Temperature, To };
 	return *this;
 }
 
@@ -361,52 +469,45 @@ VoxelProperty VoxelBuilder::Build()
 	};
 }
 
-/// @brief Allocates a new instance of a voxel element from string id
+/// @brief Allocates a new instance of a voxel element from numeric id
 /// @return pointer to the newly created voxel element
-VoxelElement *CreateVoxelElement(std::string id, Vec2i position, float amount, Temperature temp, bool placeUnmovableSolids)
+Volume::VoxelElement *CreateVoxelElement(MaterialID id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids)
 {
-	VoxelProperty* prop = VoxelRegistry::GetProperties(id);   
-
-	return CreateVoxelElement(prop, id, position, amount, temp, placeUnmovableSolids);
+	return CreateVoxelElement(VoxelRegistry::GetProperties(id), position, amount, temp, placeUnmovableSolids);
 }
 
-/// @brief Allocates a new instance of a voxel element from numeric id
+/// @brief Allocates a new instance of a voxel element from string id
 /// @return pointer to the newly created voxel element
-Volume::VoxelElement *CreateVoxelElement(uint32_t id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids)
+VoxelElement *CreateVoxelElement(const std::string &id, Vec2i position, float amount, Temperature temp, bool placeUnmovableSolids)
 {
-	VoxelProperty* prop = VoxelRegistry::GetProperties(id);
-
-	std::string stringId = VoxelRegistry::GetStringID(id);
-
-	return CreateVoxelElement(prop, stringId, position, amount, temp, placeUnmovableSolids);
+	return CreateVoxelElement(VoxelRegistry::GetProperties(id), position, amount, temp, placeUnmovableSolids);
 }
+
 /// @brief Allocates a new instance of a voxel element from VoxelProperty pointer
 /// @return pointer to the newly created voxel element
-Volume::VoxelElement *CreateVoxelElement(Volume::VoxelProperty *property, std::string id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids)
+Volume::VoxelElement *CreateVoxelElement(const Volume::VoxelProperty *property, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids)
 {
-	VoxelElement *voxel;
-
     if(property->Constructor == DefaultVoxelConstructor::Custom){
-		std::string factoryID = property->specialFactoryID.empty() ? id : property->specialFactoryID;
-		auto it = VoxelRegistry::FindFactoryWithID(factoryID);
+		if(property->factory == nullptr)
+			throw std::runtime_error("Voxel factory not resolved for: " + property->name + ". Was the registry closed?");
 
-		if(it == nullptr){
-			throw std::runtime_error("Voxel factory not found for id: " + factoryID + ". Did you forget use RegisterVoxelFactory?");
-		}
-
-		voxel = (*it)(position, temp, amount, placeUnmovableSolids);
-		return voxel;
+		return (*property->factory)(position, temp, amount, placeUnmovableSolids);
 	}
 	
+	// every built-in class and every factory type allocates from a pool of its own
 	if(property->Constructor == DefaultVoxelConstructor::GasVoxel)
-		voxel = new VoxelGas(id, position, temp, amount);
+		return NewVoxel<VoxelGas>(property->id, position, temp, amount);
 	else if(property->Constructor == DefaultVoxelConstructor::LiquidVoxel)
-		voxel = new VoxelLiquid(id, position, temp, amount);
-	else{
-		voxel = new VoxelSolid(id, position, temp, placeUnmovableSolids, amount);
-	}
-	
-	return voxel;
+		return NewVoxel<VoxelLiquid>(property->id, position, temp, amount);
+
+	return NewVoxel<VoxelSolid>(property->id, position, temp, placeUnmovableSolids, amount);
+}
+
+MaterialID Registry::MaterialHandle::Resolve() const
+{
+	MaterialID resolved = VoxelRegistry::GetMaterialID(this->name);
+	this->id.store(resolved, std::memory_order_relaxed);
+	return resolved;
 }
 
 Registry::VoxelTextureMap::VoxelTextureMap()
@@ -5,6 +5,7 @@
 #include <optional>
 #include <vector>
 #include <functional>
+#include <atomic>
 
 #include "GL/glew.h"
 
@@ -15,6 +16,14 @@
 
 struct IGame;
 
+namespace Volume{
+	/// @brief Interned numeric id of a registered material (`VoxelProperty::id`)
+	using MaterialID = uint32_t;
+	static constexpr MaterialID INVALID_MATERIAL_ID = 0;
+	/// @brief Highest id the registry hands out, chunks store material ids as `uint16_t` (`ChunkVoxelStorage`)
+	static constexpr MaterialID MAX_MATERIAL_ID = 0xFFFF;
+}
+
 namespace Registry{
 	enum class TextureRotation {
 		None 			= 0b00,
@@ -31,15 +40,16 @@ namespace Registry{
 		float minTemperatureC = Volume::Temperature::absoluteZero.GetCelsius();
 	};
 	struct ChemicalReactionProperty{
-		uint32_t catalyst;
-		uint32_t to;
+		Volume::MaterialID catalyst;
+		Volume::MaterialID to;
 		float reactionSpeed;
 		bool preserveCatalyst;
 		Volume::Temperature minTemperature;
 	};
 	struct PhaseChange{
 		Volume::Temperature temperatureAt;
-		std::string to;
+		std::string toName;											// only used until the registry closes
+		Volume::MaterialID to = Volume::INVALID_MATERIAL_ID;		// resolved from toName in CloseRegistry
 	};
 
 	enum class DefaultVoxelConstructor {
@@ -76,14 +86,22 @@ namespace Registry{
 
 namespace Volume{
 	class VoxelElement;
-	
+}
+
+namespace Registry{
+	using VoxelFactory = std::function<Volume::VoxelElement*(Vec2i pos, Volume::Temperature temp, float amount, bool placeUnmovableSolids)>;
+}
+
+namespace Volume{
+
     static constexpr float TEMP_TRANSITION_THRESHOLD = 1.5f;
 	enum class State {
 		Gas,
 		Liquid,
 		Solid,
 	};
-	struct VoxelProperty {
+	/// @note Cache line aligned, the frozen registry keeps all properties in one contiguous array indexed by id
+	struct alignas(64) VoxelProperty {
 		std::string name;
 		Registry::DefaultVoxelConstructor Constructor;
 		RGBA pColor;
@@ -98,21 +116,34 @@ namespace Volume{
 
 		uint8_t Flamability = 0; // 0 - 255
 
-		uint32_t id = 0;
+		MaterialID id = INVALID_MATERIAL_ID;
 
 		Registry::VoxelTextureMap* TextureMap = nullptr;
 		bool RandomColorTints = true;
 
 		std::vector<Registry::ChemicalReactionProperty> Reactions;
 		std::string specialFactoryID = "";
+		const Registry::VoxelFactory* factory = nullptr; // resolved in CloseRegistry for Custom constructors
 	};
 }
 
-Volume::VoxelElement* CreateVoxelElement(std::string id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids);
-Volume::VoxelElement* CreateVoxelElement(uint32_t id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids);
-Volume::VoxelElement* CreateVoxelElement(Volume::VoxelProperty* property, std::string id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids);
+Volume::VoxelElement* CreateVoxelElement(Volume::MaterialID id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids);
+Volume::VoxelElement* CreateVoxelElement(const Volume::VoxelProperty* property, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids);
+/// @brief Slow path resolving the string id first, meant for UI and tooling only
+Volume::VoxelElement* CreateVoxelElement(const std::string &id, Vec2i position, float amount, Volume::Temperature temp, bool placeUnmovableSolids);
 
 namespace Registry{
+	/// @brief Hot scalar fields of every material split into arrays indexed by `MaterialID`
+	/// @note Filled when the registry closes, index 0 (`INVALID_MATERIAL_ID`) is zeroed
+	struct MaterialTable {
+		std::vector<float> density;
+		std::vector<float> heatCapacity;
+		std::vector<float> heatConductivity;
+		std::vector<Volume::State> state;	// custom factory voxels report the state of the voxel they construct
+		std::vector<uint8_t> flamability;
+		std::vector<uint8_t> fluidDispersionRate;
+	};
+
 	class VoxelBuilder{
 	public:
 		VoxelBuilder(DefaultVoxelConstructor Constructor, float tCapacity, float tConductivity, float Density);
@@ -145,15 +176,18 @@ namespace Registry{
 		std::string specialFactoryID = "";
 	};
 
-	using VoxelFactory = std::function<Volume::VoxelElement*(Vec2i pos, Volume::Temperature temp, float amount, bool placeUnmovableSolids)>;
-
 	class VoxelRegistry {
 	public:
-		static Volume::VoxelProperty* GetProperties(std::string id);
-		static Volume::VoxelProperty* GetProperties(uint32_t id);
-		static std::string GetStringID(uint32_t id);
+		/// @brief Properties of a registered voxel, throws if there is none
+		/// @warning Pointers returned before `CloseRegistry` point into the open registry and are invalidated
+		/// when it freezes. Do not keep them across `CloseRegistry`, look the properties up again afterwards
+		static Volume::VoxelProperty* GetProperties(const std::string &id);
+		static Volume::VoxelProperty* GetProperties(Volume::MaterialID id);
+		/// @brief Hot material fields as arrays indexed by `MaterialID`, only valid after `CloseRegistry`
+		static const MaterialTable& GetMaterialTable() { return materialTable; }
+		static Volume::MaterialID GetMaterialID(const std::string &id);
+		static std::string GetStringID(Volume::MaterialID id);
 		static bool CanGetMovedByExplosion(Volume::State state);
-		static bool CanGetDestroyedByExplosion(std::string id, float explosionPower);
 		static bool CanBeMovedBySolid(Volume::State state);
 		static bool CanBeMovedByLiquid(Volume::State state);
 
@@ -162,9 +196,11 @@ namespace Registry{
 		static void RegisterTextureMap(const std::string& name, const std::string& texturePath, TextureRotation possibleRotations);
 		static void RegisterReaction(Registry::ChemicalReaction reaction);
 		static void RegisterVoxels(IGame *game);
-		static void CloseRegistry();
+		/// @note Freezes the registry, every `VoxelProperty*` obtained from `GetProperties` before this call is invalidated
+		static void CloseRegistry(bool createGPUBuffers = true);
 
 		static VoxelFactory* FindFactoryWithID(std::string id);
+		static bool IsRegistryClosed() { return registryClosed; }
 
 		static void CleanupRegistry();
 
@@ -180,13 +216,58 @@ namespace Registry{
 
 		friend class VoxelBuilder;
 	private:
-		static std::unordered_map<std::string, Volume::VoxelProperty> registry;
-		static std::unordered_map<uint32_t, Volume::VoxelProperty*> idRegistry;
+		static void FreezeRegistry();
+
+		static std::unordered_map<std::string, Volume::VoxelProperty> registry;  			// moved into `properties` after closing registries
+		static std::unordered_map<Volume::MaterialID, Volume::VoxelProperty*> idRegistry;	// cleared after closing registries
 		static std::unordered_map<std::string, VoxelFactory> voxelFactories;
 
+		// frozen registry, indexed by MaterialID
+		static std::vector<Volume::VoxelProperty> properties;
+		static std::vector<std::string> stringIDs;
+		static std::unordered_map<std::string, Volume::MaterialID> materialIDs;
+		static MaterialTable materialTable;
+
 		static std::unordered_map<std::string, VoxelTextureMap*> textureMaps;
 		static std::vector<Registry::ChemicalReaction> reactionRegistry;  // cleared after closing registries
-		static uint32_t idCounter;
+		static Volume::MaterialID idCounter;
 		static bool registryClosed;
+		static bool registryFrozen; // set once the properties moved into `properties`, after `registryClosed`
+	};
+
+	/// @brief `constinit` handle to a material by its string id, resolved on first use
+	/// @note Only the name is fixed at compile time. The numeric id is looked up at runtime on first use and cached, so comparing against a handle
+	/// costs the same as comparing two `MaterialID`s. Declare handles as `constinit` globals
+	class MaterialHandle {
+	public:
+		constexpr explicit MaterialHandle(const char *name) : name(name) {};
+
+		// disable copy, every copy would need to resolve again
+		MaterialHandle(const MaterialHandle&) = delete;
+		MaterialHandle& operator=(const MaterialHandle&) = delete;
+
+		Volume::MaterialID ID() const {
+			Volume::MaterialID resolved = id.load(std::memory_order_relaxed);
+			if(resolved == Volume::INVALID_MATERIAL_ID) [[unlikely]]
+				resolved = Resolve();
+			return resolved;
+		}
+		operator Volume::MaterialID() const { return ID(); }
+
+		const char* GetName() const { return name; }
+	private:
+		Volume::MaterialID Resolve() const;
+
+		const char *name;
+		mutable std::atomic<Volume::MaterialID> id = Volume::INVALID_MATERIAL_ID;
 	};
-}
\ No newline at end of file
+}
+
+/// @brief Handles for materials the engine itself refers to
+namespace Volume::Materials {
+	constinit inline Registry::MaterialHandle Empty{"Empty"};
+	constinit inline Registry::MaterialHandle Oxygen{"Oxygen"};
+	constinit inline Registry::MaterialHandle Fire{"Fire"};
+	constinit inline Registry::MaterialHandle FireSolid{"Fire_Solid"};
+	constinit inline Registry::MaterialHandle FireLiquid{"Fire_Liquid"};
+}
@@ -0,0 +1,38 @@
+#include "Rendering/RenderSnapshot.h"
+
+void RenderSnapshot::Clear()
+{
+    this->tick = 0;
+    // keeps the capacity, snapshots are refilled every tick
+    this->chunks.clear();
+    this->objectVoxels.clear();
+    this->particles.clear();
+}
+
+void RenderSnapshotBuffer::Publish()
+{
+    const uint8_t previous = this->publishedIndex.exchange(this->writeIndex | NEW_SNAPSHOT, std::memory_order_acq_rel);
+    this->writeIndex = previous & INDEX_MASK;
+}
+
+const RenderSnapshot *RenderSnapshotBuffer::AcquireLatest()
+{
+    if(this->publishedIndex.load(std::memory_order_relaxed) & NEW_SNAPSHOT){
+        const uint8_t latest = this->publishedIndex.exchange(this->readIndex, std::memory_order_acq_rel);
+        this->readIndex = latest & INDEX_MASK;
+        this->hasRead = true;
+    }
+
+    return this->hasRead ? &this->snapshots[this->readIndex] : nullptr;
+}
+
+void RenderSnapshotBuffer::Reset()
+{
+    for(RenderSnapshot &snapshot : this->snapshots)
+        snapshot.Clear();
+
+    this->writeIndex = 0;
+    this->readIndex = 1;
+    this->hasRead = false;
+    this->publishedIndex.store(2, std::memory_order_relaxed);
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "Math/AABB.h"
+#include "World/Chunk.h"
+#include "World/Particle.h"
+
+/// @brief Render data of one chunk as of a simulation tick
+struct ChunkRenderSnapshot {
+    // only used for its GL objects, chunks live until no snapshot can reference them (ChunkMatrix::FreeRetiredChunks)
+    Volume::Chunk *chunk = nullptr;
+    AABB aabb;
+    uint64_t version = 0;   // 0 until the chunk got its first colors
+    // immutable, nullptr when the renderer already uploaded this version
+    std::shared_ptr<const Volume::VoxelRenderData[]> voxels;
+};
+
+/// @brief Everything the renderer draws from the world, published by the simulation thread after every tick
+struct RenderSnapshot {
+    uint64_t tick = 0;
+    std::vector<ChunkRenderSnapshot> chunks;
+    std::vector<Volume::VoxelRenderData> objectVoxels;   // every voxel object, the player last
+    std::vector<Particle::ParticleRenderData> particles;
+
+    void Clear();
+};
+
+/// @brief Triple buffer of render snapshots. The simulation writes one snapshot while the renderer
+/// reads another, the third holds the newest published one. Neither side ever waits for the other
+class RenderSnapshotBuffer {
+public:
+    /// @brief Snapshot to fill next, the renderer cannot see it before `Publish`
+    /// @note Writer side only
+    RenderSnapshot& GetWriteSnapshot() { return snapshots[writeIndex]; }
+    /// @brief Makes the written snapshot the newest one, older unread snapshots are dropped
+    void Publish();
+
+    /// @brief Newest published snapshot, the previous one if nothing new was published since
+    /// @return nullptr before the first publish
+    /// @note Reader side only, the snapshot stays valid until the next call
+    const RenderSnapshot* AcquireLatest();
+
+    /// @brief Drops every snapshot, used when the chunks they reference go away
+    /// @warning Neither the writer nor the reader may use the buffer meanwhile
+    void Reset();
+private:
+    static constexpr uint8_t INDEX_MASK = 0b011;
+    static constexpr uint8_t NEW_SNAPSHOT = 0b100;
+
+    RenderSnapshot snapshots[3];
+    uint8_t writeIndex = 0;                 // writer only
+    uint8_t readIndex = 1;                  // reader only
+    bool hasRead = false;                   // reader only
+    std::atomic<uint8_t> publishedIndex = 2;  // | NEW_SNAPSHOT until the reader takes it
+};
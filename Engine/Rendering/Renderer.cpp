@@ -4,6 +4,7 @@
 
 #include <iostream>
 #include <vector>
+#include <bit>
 #include <mutex>
 #include <math.h>
 #include <algorithm>
@@ -123,6 +124,19 @@ GameRenderer::GameRenderer(SDL_GLContext *glContext, RGB backgroundColor, bool l
     particleVAO.Unbind();
     // --------------
 
+    objectVBO = Shader::GLBuffer<Volume::VoxelRenderData, GL_ARRAY_BUFFER>("Voxel Object Render VBO");
+
+    //Voxel object VAO setup ----
+    objectVAO = Shader::GLVertexArray("Voxel Object Render VAO");
+    objectVAO.Bind();
+
+    objectVAO.AddAttribute<glm::vec2>(0, 2, *quadBuffer, GL_FALSE, 0, 0);                                                   // location 0: vec2 texCoord
+    objectVAO.AddIntAttribute<glm::ivec2>(1, 2, objectVBO, offsetof(Volume::VoxelRenderData, position), 1);                 // location 1: vec2 worldPos
+    objectVAO.AddAttribute<glm::vec4>(2, 4, objectVBO, GL_FALSE, offsetof(Volume::VoxelRenderData, color), 1);              // location 2: vec4 color
+
+    objectVAO.Unbind();
+    // --------------
+
     // Closed shape VAO setup ----
     closedShapeVAO = Shader::GLVertexArray("Closed Shape VAO");
     closedShapeVBO = Shader::GLBuffer<glm::vec2, GL_ARRAY_BUFFER>("Closed Shape VBO");
@@ -198,11 +212,18 @@ void GameRenderer::SetCameraPosition(Vec2f centerPos)
         }
 
         for (const auto& chunkPos : chunksToLoad) {
-            GameEngine::instance->GetActiveChunkMatrix()->GenerateChunk(chunkPos);
+            GameEngine::instance->GetActiveChunkMatrix()->RequestChunk(chunkPos, Volume::ChunkGenerationPriority::Visible);
         }
     }
 }
 
+void GameRenderer::UpdateChunkPrefetch(ChunkMatrix &chunkMatrix, Vec2f velocity, float deltaTime)
+{
+    if(!this->loadChunksInView) return;
+
+    this->chunkPrefetcher.Update(chunkMatrix, this->Camera, velocity, deltaTime);
+}
+
 /// @brief Set when the window is resized
 /// @param size size in voxels
 void GameRenderer::SetCameraSize(Vec2f size)
@@ -210,9 +231,9 @@ void GameRenderer::SetCameraSize(Vec2f size)
     this->Camera.size = size;
 }
 
-void GameRenderer::Render(ChunkMatrix &chunkMatrix, Vec2i mousePos, IGame *game)
+void GameRenderer::Render(const RenderSnapshot &snapshot, ChunkMatrix &chunkMatrix, Vec2i mousePos, IGame *game)
 {
-    std::lock_guard<std::mutex> lock(GameEngine::instance->openGLMutex);
+    std::lock_guard<Debug::TracedMutex> lock(GameEngine::instance->openGLMutex);
     GLenum err;
     while ((err = glGetError()) != GL_NO_ERROR) {
         Debug::LogError("[PreRender] GL error: [" + std::to_string(err) + "]");
@@ -241,13 +262,15 @@ void GameRenderer::Render(ChunkMatrix &chunkMatrix, Vec2i mousePos, IGame *game)
         -1.0f, 1.0f
     );
 
-    this->RenderVoxelObjects(chunkMatrix, voxelProj);
-
-    VoxelObject *player = GameEngine::instance->GetPlayer();
-    if(player)
-        this->RenderPlayer(player, voxelProj);
+    {
+        PROFILE_SCOPE("Voxel objects");
+        this->RenderVoxelObjects(snapshot, voxelProj);
+    }
 
-    this->RenderChunks(chunkMatrix, voxelProj);
+    {
+        PROFILE_SCOPE("Chunks");
+        this->RenderChunks(snapshot, voxelProj);
+    }
 
     //glm::vec2 mousePosInWorld = {
     //    mousePos.x / Volume::Chunk::RENDER_VOXEL_SIZE + static_cast<int>(this->Camera.corner.x),
@@ -256,15 +279,28 @@ void GameRenderer::Render(ChunkMatrix &chunkMatrix, Vec2i mousePos, IGame *game)
     Vec2f mousePosInWorldF = ChunkMatrix::MousePosToWorldPos(mousePos, this->Camera.corner);
     glm::vec2 mousePosInWorldInt = glm::vec2(static_cast<int>(mousePosInWorldF.x), static_cast<int>(mousePosInWorldF.y));
 
-    this->RenderHeat(chunkMatrix, mousePosInWorldInt, voxelProj);
+    {
+        PROFILE_SCOPE("Heat");
+        this->RenderHeat(snapshot, mousePosInWorldInt, voxelProj);
+    }
 
-    this->RenderParticles(chunkMatrix, voxelProj);
+    {
+        PROFILE_SCOPE("Particles");
+        this->RenderParticles(snapshot, voxelProj);
+    }
 
-    if (this->debugRendering)
+    // the debug views read the live world
+    if (this->debugRendering){
+        PROFILE_SCOPE("Debug");
+        std::lock_guard<Debug::TracedSharedMutex> voxelLock(chunkMatrix.voxelMutex);
         this->RenderDebugMode(chunkMatrix, mousePosInWorldInt, voxelProj, screenProj);
+    }
 
-    if(this->renderMeshData)
+    if(this->renderMeshData){
+        PROFILE_SCOPE("Mesh data");
+        std::lock_guard<Debug::TracedSharedMutex> voxelLock(chunkMatrix.voxelMutex);
         this->RenderMeshData(chunkMatrix, voxelProj);
+    }
 
 
     // prepare IMGUI for the game renderer
@@ -272,13 +308,22 @@ void GameRenderer::Render(ChunkMatrix &chunkMatrix, Vec2i mousePos, IGame *game)
     ImGui_ImplOpenGL3_NewFrame();
     ImGui::NewFrame();
 
-    game->Render(voxelProj, screenProj);
+    {
+        PROFILE_SCOPE("Game render");
+        game->Render(voxelProj, screenProj);
+    }
 
     // Render the ImGui frame
-    ImGui::Render();
-    ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    {
+        PROFILE_SCOPE("ImGui");
+        ImGui::Render();
+        ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+    }
 
-    SDL_GL_SwapWindow(r_window); 
+    {
+        PROFILE_SCOPE("Swap window");
+        SDL_GL_SwapWindow(r_window); 
+    }
 
     while ((err = glGetError()) != GL_NO_ERROR) {
         Debug::LogError("[Render] GL error: [" + std::to_string(err) + "]");
@@ -330,54 +375,34 @@ void GameRenderer::ToggleDebugRendering()
     this->debugRendering = !this->debugRendering;
 }
 
-void GameRenderer::RenderVoxelObjects(ChunkMatrix &chunkMatrix, glm::mat4 projection)
+void GameRenderer::RenderVoxelObjects(const RenderSnapshot &snapshot, glm::mat4 projection)
 {
-    this->voxelRenderProgram->Use();
-    this->voxelRenderProgram->SetMat4("projection", projection);
+    if(snapshot.objectVoxels.empty()) return;
 
-    for (VoxelObject* object : chunkMatrix.voxelObjects) {
-        if(object == nullptr) continue;
-        if(!object->ShouldRender()) continue;
-
-        auto pos = object->GetPosition();
-
-        unsigned int voxelCount = object->UpdateGPURenderBuffer();
-
-        object->renderVoxelArray.Bind();
-        glDrawArraysInstanced(
-            GL_TRIANGLE_FAN, 0, 4, 
-            static_cast<GLsizei>(voxelCount)
-        );
-    }
-}
-
-void GameRenderer::RenderPlayer(VoxelObject *player, glm::mat4 projection)
-{
     this->voxelRenderProgram->Use();
     this->voxelRenderProgram->SetMat4("projection", projection);
 
-    if(player->ShouldRender()) {
-        unsigned int voxelCount = player->UpdateGPURenderBuffer();
+    objectVBO.SetData(snapshot.objectVoxels, GL_DYNAMIC_DRAW);
 
-        player->renderVoxelArray.Bind();
-        glDrawArraysInstanced(
-            GL_TRIANGLE_FAN, 0, 4, 
-            static_cast<GLsizei>(voxelCount)
-        );
-    }
+    objectVAO.Bind();
+    glDrawArraysInstanced(
+        GL_TRIANGLE_FAN, 0, 4, 
+        static_cast<GLsizei>(snapshot.objectVoxels.size())
+    );
 }
 
-void GameRenderer::RenderChunks(ChunkMatrix &chunkMatrix,  glm::mat4 projection)
+void GameRenderer::RenderChunks(const RenderSnapshot &snapshot,  glm::mat4 projection)
 {
     this->voxelRenderProgram->Use();
     this->voxelRenderProgram->SetMat4("projection", projection);
 
-    for (auto& chunk : chunkMatrix.Grid) {
-        if(!chunk->IsInitialized()) continue;
+    for (const ChunkRenderSnapshot &chunkSnapshot : snapshot.chunks) {
+        Volume::Chunk *chunk = chunkSnapshot.chunk;
+        if(!chunk->IsInitialized() || chunkSnapshot.version == 0) continue;
         
-        chunk->UpdateRenderGPUBuffers();
+        chunk->UploadRenderData(chunkSnapshot.voxels.get(), chunkSnapshot.version);
 
-        if(chunk->GetAABB().Overlaps(this->Camera)){
+        if(chunkSnapshot.aabb.Overlaps(this->Camera)){
             chunk->renderVoxelVAO.Bind();
             glDrawArraysInstanced(
                 GL_TRIANGLE_FAN, 0, 4, 
@@ -387,16 +412,18 @@ void GameRenderer::RenderChunks(ChunkMatrix &chunkMatrix,  glm::mat4 projection)
     }
 }
 
-void GameRenderer::RenderHeat(ChunkMatrix &chunkMatrix, glm::vec2 mousePos,  glm::mat4 projection)
+void GameRenderer::RenderHeat(const RenderSnapshot &snapshot, glm::vec2 mousePos,  glm::mat4 projection)
 {
     this->temperatureRenderProgram->Use();
     this->temperatureRenderProgram->SetMat4("projection", projection);
     this->temperatureRenderProgram->SetBool("showHeatAroundCursor", this->showHeatAroundCursor);
     this->temperatureRenderProgram->SetVec2("cursorPosition", mousePos);
 
-    for (auto& chunk : chunkMatrix.Grid) {
-        if(chunk->GetAABB().Overlaps(this->Camera)) {
-            chunk->heatRenderingVAO.Bind();
+    for (const ChunkRenderSnapshot &chunkSnapshot : snapshot.chunks) {
+        if(!chunkSnapshot.chunk->IsInitialized()) continue;
+
+        if(chunkSnapshot.aabb.Overlaps(this->Camera)) {
+            chunkSnapshot.chunk->heatRenderingVAO.Bind();
             glDrawArraysInstanced(
                 GL_TRIANGLE_FAN, 0, 4, 
                 Volume::Chunk::CHUNK_SIZE_SQUARED
@@ -405,17 +432,17 @@ void GameRenderer::RenderHeat(ChunkMatrix &chunkMatrix, glm::vec2 mousePos,  glm
     }
 }
 
-void GameRenderer::RenderParticles(ChunkMatrix &chunkMatrix, glm::mat4 projection)
+void GameRenderer::RenderParticles(const RenderSnapshot &snapshot, glm::mat4 projection)
 {
-    if(chunkMatrix.particles.size() > 0){
-        this->UpdateParticleVBO(chunkMatrix);
+    if(snapshot.particles.size() > 0){
+        particleVBO.SetData(snapshot.particles, GL_DYNAMIC_DRAW);
         this->particleRenderProgram->Use();
         this->particleRenderProgram->SetMat4("projection", projection);
         
         particleVAO.Bind();
         glDrawArraysInstanced(
             GL_TRIANGLE_FAN, 0, 4, 
-            static_cast<GLsizei>(chunkMatrix.particles.size())
+            static_cast<GLsizei>(snapshot.particles.size())
         );
     }
 }
@@ -480,25 +507,27 @@ void GameRenderer::RenderDebugMode(ChunkMatrix &chunkMatrix, glm::vec2 mousePos,
                 voxelProj
             );
             
-            //draw dirty rects
-            if(chunk->dirtyRect.IsEmpty()) continue;
+            //draw dirty tiles
+            for(uint64_t tiles = chunk->dirtyTiles.GetMask(); tiles != 0; tiles &= tiles - 1){
+                const DirtyTiles::TileBounds &bounds = chunk->dirtyTiles.GetTileBounds(std::countr_zero(tiles));
 
-            glm::vec2 dirtyStart = {
-                chunk->dirtyRect.start.x + chunk->GetAABB().corner.x,
-                chunk->dirtyRect.start.y + chunk->GetAABB().corner.y
-            };
-            glm::vec2 dirtyEnd = {
-                chunk->dirtyRect.end.x - chunk->dirtyRect.start.x + dirtyStart.x,
-                chunk->dirtyRect.end.y - chunk->dirtyRect.start.y + dirtyStart.y
-            };
+                glm::vec2 dirtyStart = {
+                    bounds.startX + chunk->GetAABB().corner.x,
+                    bounds.startY + chunk->GetAABB().corner.y
+                };
+                glm::vec2 dirtyEnd = {
+                    bounds.endX + 1 + chunk->GetAABB().corner.x,
+                    bounds.endY + 1 + chunk->GetAABB().corner.y
+                };
 
-            std::vector<glm::vec2> dirtyRectPoints = {
-                dirtyStart,
-                {dirtyEnd.x, dirtyStart.y},
-                dirtyEnd,
-                {dirtyStart.x, dirtyEnd.y}
-            };
-            this->DrawClosedShape(dirtyRectPoints, green, voxelProj, 1.0f);
+                std::vector<glm::vec2> dirtyTilePoints = {
+                    dirtyStart,
+                    {dirtyEnd.x, dirtyStart.y},
+                    dirtyEnd,
+                    {dirtyStart.x, dirtyEnd.y}
+                };
+                this->DrawClosedShape(dirtyTilePoints, green, voxelProj, 1.0f);
+            }
         }
     }
 
@@ -645,17 +674,3 @@ void GameRenderer::RenderMeshData(ChunkMatrix &chunkMatrix, glm::mat4 projection
         this->DrawClosedShape(aabbPoints, glm::vec4(0.8f, 0.2f, 0.8f, 1.0f), projection, 1.5f);
     }
 }
-
-void GameRenderer::UpdateParticleVBO(ChunkMatrix &chunkMatrix)
-{
-    std::vector<Particle::ParticleRenderData> particleData;
-    for (Particle::VoxelParticle* particle : chunkMatrix.particles) {
-        particleData.push_back({
-            .position = glm::vec2(particle->GetPosition().x, particle->GetPosition().y),
-            .color = particle->color.getGLMVec4()
-        });
-    }
-
-    particleVBO.SetData(particleData, GL_DYNAMIC_DRAW);
-    particleVAO.Bind();
-}
@@ -1,10 +1,12 @@
 #pragma once
 
 #include "World/Chunk.h"
+#include "World/ChunkPrefetcher.h"
 #include "Math/Vector.h"
 #include "Shader/Rendering/RenderingShader.h"
 #include "Rendering/FontRenderer.h"
 #include "Rendering/SpriteRenderer.h"
+#include "Rendering/RenderSnapshot.h"
 
 struct IGame;
 
@@ -24,23 +26,25 @@ private:
     Shader::RenderShader *closedShapeRenderProgram = nullptr;
     Shader::RenderShader *cursorRenderProgram = nullptr;
 
-    void RenderVoxelObjects(ChunkMatrix &chunkMatrix, glm::mat4 projection);
-    void RenderPlayer(VoxelObject *player, glm::mat4 projection);
-    void RenderChunks(ChunkMatrix &chunkMatrix, glm::mat4 projection);
-    void RenderHeat(ChunkMatrix &chunkMatrix, glm::vec2 mousePos, glm::mat4 projection);
-    void RenderParticles(ChunkMatrix &chunkMatrix, glm::mat4 projection);
+    void RenderVoxelObjects(const RenderSnapshot &snapshot, glm::mat4 projection);
+    void RenderChunks(const RenderSnapshot &snapshot, glm::mat4 projection);
+    void RenderHeat(const RenderSnapshot &snapshot, glm::vec2 mousePos, glm::mat4 projection);
+    void RenderParticles(const RenderSnapshot &snapshot, glm::mat4 projection);
 
     void RenderDebugMode(ChunkMatrix &chunkMatrix, glm::vec2 mousePos, glm::mat4 voxelProj, glm::mat4 screenProj);
     void RenderMeshData(ChunkMatrix &chunkMatrix, glm::mat4 projection);
 
-    void UpdateParticleVBO(ChunkMatrix &chunkMatrix);
-
     AABB Camera;
     bool loadChunksInView;
+    Volume::ChunkPrefetcher chunkPrefetcher;
 
     Shader::GLVertexArray particleVAO;
     Shader::GLBuffer<Particle::ParticleRenderData, GL_ARRAY_BUFFER> particleVBO;
 
+    // every voxel object of the snapshot in one draw call
+    Shader::GLVertexArray objectVAO;
+    Shader::GLBuffer<Volume::VoxelRenderData, GL_ARRAY_BUFFER> objectVBO;
+
     Shader::GLVertexArray closedShapeVAO;
     Shader::GLBuffer<glm::vec2, GL_ARRAY_BUFFER> closedShapeVBO;
 
@@ -57,6 +61,9 @@ public:
     bool renderMeshData = false;
 
     void SetCameraPosition(Vec2f centerPos);
+    /// @brief Requests chunks ahead of the camera, called by the engine every frame
+    void UpdateChunkPrefetch(ChunkMatrix &chunkMatrix, Vec2f velocity, float deltaTime);
+    Volume::ChunkPrefetcher& GetChunkPrefetcher() { return this->chunkPrefetcher; }
     /// @brief Used by the engine during window resize 
     void SetCameraSize(Vec2f size);
     Vec2f GetCameraOffset() const { return this->Camera.corner; }
@@ -68,7 +75,8 @@ public:
 
     void ToggleDebugRendering();
 
-    void Render(ChunkMatrix &chunkMatrix, Vec2i mousePos, IGame *game);
+    /// @brief Draws the frame from the render snapshot, the voxel mutex is only taken for the debug views
+    void Render(const RenderSnapshot &snapshot, ChunkMatrix &chunkMatrix, Vec2i mousePos, IGame *game);
     void DrawClosedShape(const std::vector<glm::vec2> &points, const glm::vec4 &color, glm::mat4 projection, float lineWidth);
     void DrawClosedShape(const GLuint VAO, const GLsizei size, const glm::vec4 &color, glm::mat4 projection, float lineWidth);
 
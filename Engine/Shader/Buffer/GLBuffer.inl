@@ -4,6 +4,7 @@
 #include "GLBuffer.h"
 #include "GLGroupStorageBuffer.h"
 #include "Debug/Logger.h"
+#include "Debug/Stats.h"
 
 namespace Shader{
 
@@ -79,6 +80,7 @@ inline void GLBuffer<T, Target>::SetData(const T &data, GLenum usage)
     this->Bind();
     glBufferData(Target, sizeof(T), &data, usage);
     this->bufferSize = 1;
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, sizeof(T));
 }
 
 /// @brief Sets a data array (Causes reallocation)
@@ -91,6 +93,7 @@ inline void GLBuffer<T, Target>::SetData(const T *data, GLuint size, GLenum usag
     this->Bind();
     glBufferData(Target, size * sizeof(T), data, usage);
     this->bufferSize = size;
+    if(data) Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, size * sizeof(T));
     this->Unbind();
 }
 
@@ -104,6 +107,7 @@ inline void GLBuffer<T, Target>::SetData(const std::vector<T> &data, GLenum usag
     if constexpr (!std::is_same_v<T, bool>) {
         glBufferData(Target, data.size() * sizeof(T), data.data(), usage);
         this->bufferSize = static_cast<GLint>(data.size());
+        Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, data.size() * sizeof(T));
     } else{
         // special behaviour for std::vector<bool>
         std::vector<uint32_t> boolData(data.size());
@@ -112,6 +116,7 @@ inline void GLBuffer<T, Target>::SetData(const std::vector<T> &data, GLenum usag
         }
         glBufferData(Target, boolData.size() * sizeof(uint32_t), boolData.data(), usage);
         this->bufferSize = static_cast<GLint>(data.size());
+        Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, boolData.size() * sizeof(uint32_t));
     }
 }
 
@@ -128,6 +133,7 @@ inline void GLBuffer<T, Target>::UpdateData(GLuint offset, const std::vector<T>
 
     this->Bind();
     glBufferSubData(Target, offset * sizeof(T), data.size() * sizeof(T), data.data());
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, data.size() * sizeof(T));
 }
 
 /// @brief Updates a portion of the buffer with new data
@@ -145,6 +151,7 @@ inline void GLBuffer<T, Target>::UpdateData(GLuint offset, const T *data, GLuint
 
     this->Bind();
     glBufferSubData(Target, offset * sizeof(T), size * sizeof(T), data);
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, size * sizeof(T));
 }
 
 /// @brief Uploads a portion of the buffer from another buffer
@@ -264,6 +271,7 @@ inline T *GLBuffer<T, Target>::ReadBuffer() const
     T* result = new T[this->bufferSize];
     std::memcpy(result, data, this->bufferSize * sizeof(T));
     glUnmapBuffer(Target);
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesReadBack, this->bufferSize * sizeof(T));
     return result;
 }
 
@@ -290,6 +298,7 @@ inline T *GLBuffer<T, Target>::ReadBuffer(GLuint size) const
     T* result = new T[size];
     std::memcpy(result, data, size * sizeof(T));
     glUnmapBuffer(Target);
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesReadBack, size * sizeof(T));
     return result;
 }
 }
\ No newline at end of file
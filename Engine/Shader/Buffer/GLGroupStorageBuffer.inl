@@ -4,6 +4,7 @@
 #include <stack>
 
 #include "Debug/Logger.h"
+#include "Debug/Stats.h"
 
 template <typename T>
 Shader::GLGroupStorageBuffer<T>::GLGroupStorageBuffer()
@@ -158,6 +159,7 @@ inline void Shader::GLGroupStorageBuffer<T>::SetData(StorageBufferTicket ticket,
     this->Bind();
     glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, segmentSize * sizeof(T), data);
     this->Unbind();
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, segmentSize * sizeof(T));
 }
 
 /// @brief Sets the data for a specific segment. Data must have the same size as segment size
@@ -175,6 +177,7 @@ inline void Shader::GLGroupStorageBuffer<T>::SetData(StorageBufferTicket ticket,
     this->Bind();
     glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, segmentSize * sizeof(T), data.data());
     this->Unbind();
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, segmentSize * sizeof(T));
 }
 
 /// @brief Updates a portion of a specific segment. Data must not go over segment size
@@ -193,6 +196,7 @@ inline void Shader::GLGroupStorageBuffer<T>::UpdateData(StorageBufferTicket tick
     this->Bind();
     glBufferSubData(GL_SHADER_STORAGE_BUFFER, baseOffset + offset, data.size() * sizeof(T), data.data());
     this->Unbind();
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, data.size() * sizeof(T));
 }
 
 /// @brief Updates a portion of a specific segment. Data must not go over segment size
@@ -212,6 +216,7 @@ inline void Shader::GLGroupStorageBuffer<T>::UpdateData(StorageBufferTicket tick
     this->Bind();
     glBufferSubData(GL_SHADER_STORAGE_BUFFER, baseOffset + offset, size * sizeof(T), data);
     this->Unbind();
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, size * sizeof(T));
 }
 
 template <typename T>
@@ -304,6 +309,7 @@ inline void Shader::GLGroupStorageBuffer<T>::ClearBuffer(const StorageBufferTick
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, ID);
     glBufferSubData(GL_SHADER_STORAGE_BUFFER, offset, segmentSize * sizeof(T), zeros.data());
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, segmentSize * sizeof(T));
 }
 
 template <typename T>
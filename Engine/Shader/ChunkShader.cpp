@@ -1,6 +1,7 @@
 #include "Shader/ChunkShader.h"
 
 #include <iostream>
+#include <algorithm>
 #include <cstring>
 
 #include "GameEngine.h"
@@ -54,9 +55,54 @@ Shader::ChunkShaderManager::~ChunkShaderManager()
     delete this->clearBufferShader;
 }
 
+namespace {
+    /// @warning the chunk has to be locked
+    void CaptureUploadedVoxels(const Volume::Chunk &chunk, Shader::UploadedChunkVoxels &uploaded)
+    {
+        if(const Volume::ChunkPalette *palette = chunk.GetPalette()){
+            for(uint16_t i = 0; i < Volume::Chunk::CHUNK_SIZE_SQUARED; ++i){
+                const Volume::ChunkPaletteEntry &entry = palette->Get(i);
+                uploaded.materialId[i] = static_cast<uint16_t>(entry.material);
+                uploaded.temperature[i] = entry.temperature;
+                uploaded.amount[i] = entry.amount;
+            }
+            return;
+        }
+
+        const Volume::ChunkVoxelStorage &storage = chunk.GetVoxelStorage();
+        std::memcpy(uploaded.materialId, storage.materialId, sizeof(uploaded.materialId));
+        std::memcpy(uploaded.temperature, storage.temperature, sizeof(uploaded.temperature));
+        std::memcpy(uploaded.amount, storage.amount, sizeof(uploaded.amount));
+    }
+
+    /// @brief True if the voxel still has the material, temperature and amount the GPU simulated
+    /// @warning the chunk has to be locked
+    bool IsVoxelUnchanged(const Volume::Chunk &chunk, const Shader::UploadedChunkVoxels &uploaded, uint16_t index)
+    {
+        // any write expands the chunk, and only the exclusive voxel mutex compresses one
+        if(chunk.IsCompressed()) return true;
+
+        const Volume::ChunkVoxelStorage &storage = chunk.GetVoxelStorage();
+        return storage.materialId[index] == uploaded.materialId[index]
+            && storage.temperature[index] == uploaded.temperature[index]
+            && storage.amount[index] == uploaded.amount[index];
+    }
+
+    /// @brief Takes the current state of the voxel as its uploaded state, after the batch itself changed it
+    void RefreshUploadedVoxel(const Volume::Chunk &chunk, Shader::UploadedChunkVoxels &uploaded, uint16_t index)
+    {
+        const Volume::ChunkVoxelStorage &storage = chunk.GetVoxelStorage();
+        uploaded.materialId[index] = storage.materialId[index];
+        uploaded.temperature[index] = storage.temperature[index];
+        uploaded.amount[index] = storage.amount[index];
+    }
+}
+
 void Shader::ChunkShaderManager::BatchRunChunkShaders(ChunkMatrix &chunkMatrix)
 {
-    std::lock_guard<std::mutex> lock(GameEngine::instance->openGLMutex);
+    chunkMatrix.SeedVoxelRandom(ChunkMatrix::GPU_RANDOM_STREAM);
+
+    std::lock_guard<Debug::TracedMutex> lock(GameEngine::instance->openGLMutex);
     std::vector<Volume::Chunk*> chunksToUpdate;
     for(Volume::Chunk* chunk : chunkMatrix.Grid){
         if(chunk->IsInitialized()){
@@ -73,43 +119,44 @@ void Shader::ChunkShaderManager::BatchRunChunkShaders(ChunkMatrix &chunkMatrix)
 
     std::vector<ChunkConnectivityData> connectivityDataBuffer(bufferNumberOfSegments);
 
-    for(uint16_t i = 0; i < static_cast<uint16_t>(chunksToUpdate.size()); ++i){
-        Volume::Chunk *c = chunksToUpdate[i];
-        c->UpdateComputeGPUBuffers(
-            voxelPressureBuffer,
-            voxelTemperatureBuffer,
-            voxelIdBuffer,
-            voxelHeatCapacityBuffer,
-            voxelConductivityBuffer
-        );
+    this->uploadedVoxels.resize(chunkCount);
+    uint64_t discardedResults = 0;
+    {
+        PROFILE_SCOPE("Upload chunk buffers");
+        for(uint16_t i = 0; i < static_cast<uint16_t>(chunksToUpdate.size()); ++i){
+            Volume::Chunk *c = chunksToUpdate[i];
+            Volume::ChunkLockGuard chunkLock;
+            chunkLock.AddExclusive(c);
+            chunkLock.Lock();
+
+            CaptureUploadedVoxels(*c, this->uploadedVoxels[i]);
+            c->UpdateComputeGPUBuffers(
+                voxelPressureBuffer,
+                voxelTemperatureBuffer,
+                voxelIdBuffer,
+                voxelHeatCapacityBuffer,
+                voxelConductivityBuffer
+            );
+        }
     }
 
+    // neighbours that are not being simulated this update stay disconnected (-1)
+    auto ticketOf = [](const Volume::Chunk *neighbor) -> int32_t {
+        if(!neighbor || !neighbor->IsInitialized()) return -1;
+        return neighbor->bufferTicket;
+    };
+
     std::unordered_set<StorageBufferTicket> availableTickets = {};
     std::unordered_map<StorageBufferTicket, Volume::Chunk*> ticketToChunkMap = {};
     for(uint16_t i = 0; i < static_cast<uint16_t>(chunksToUpdate.size()); ++i){
-        // Set up chunk connectivity data
+        // Set up chunk connectivity data from the chunk's neighbour links
+        const Volume::Chunk *chunk = chunksToUpdate[i];
         ChunkConnectivityData data;
-        data.chunk = chunksToUpdate[i]->bufferTicket;
-        data.chunkUp = -1;
-        data.chunkDown = -1;
-        data.chunkLeft = -1;
-        data.chunkRight = -1;
-        Vec2i pos = chunksToUpdate[i]->GetPos();
-        Vec2i posUp = pos + vector::UP;
-        Vec2i posDown = pos + vector::DOWN;
-        Vec2i posLeft = pos + vector::LEFT;
-        Vec2i posRight = pos + vector::RIGHT;
-        for(uint16_t j = 0; j < static_cast<uint16_t>(chunksToUpdate.size()); ++j){
-            Vec2i otherPos = chunksToUpdate[j]->GetPos();
-            if(otherPos == posUp)
-                data.chunkUp = chunksToUpdate[j]->bufferTicket;
-            else if(otherPos == posDown)
-                data.chunkDown = chunksToUpdate[j]->bufferTicket;
-            else if(otherPos == posLeft)
-                data.chunkLeft = chunksToUpdate[j]->bufferTicket;
-            else if(otherPos == posRight)
-                data.chunkRight = chunksToUpdate[j]->bufferTicket;
-        }
+        data.chunk = chunk->bufferTicket;
+        data.chunkUp = ticketOf(chunk->GetNeighbor(Volume::ChunkNeighbor::Up));
+        data.chunkDown = ticketOf(chunk->GetNeighbor(Volume::ChunkNeighbor::Down));
+        data.chunkLeft = ticketOf(chunk->GetNeighbor(Volume::ChunkNeighbor::Left));
+        data.chunkRight = ticketOf(chunk->GetNeighbor(Volume::ChunkNeighbor::Right));
         
         connectivityDataBuffer[i] = data;
         availableTickets.insert(chunksToUpdate[i]->bufferTicket);
@@ -122,6 +169,7 @@ void Shader::ChunkShaderManager::BatchRunChunkShaders(ChunkMatrix &chunkMatrix)
     float *heatOutput = nullptr;
     if(GameEngine::instance->runHeatSimulation)
     {
+        PROFILE_SCOPE("Heat shader");
         floatOutputDataBuffer.ClearBuffer(this->voxelTemperatureBuffer.GetTotalSize(), GL_DYNAMIC_DRAW);
         floatOutputDataBufferCompressed.ClearBuffer(numberOfVoxels, GL_DYNAMIC_DRAW);
         this->BindHeatShaderBuffers();
@@ -146,6 +194,7 @@ void Shader::ChunkShaderManager::BatchRunChunkShaders(ChunkMatrix &chunkMatrix)
     float *pressureOutput = nullptr;
     if(GameEngine::instance->runPressureSimulation)
     {
+        PROFILE_SCOPE("Pressure shader");
         this->BindPressureShaderBuffers();
         this->pressureShader->Use();
         
@@ -164,12 +213,13 @@ void Shader::ChunkShaderManager::BatchRunChunkShaders(ChunkMatrix &chunkMatrix)
     uint32_t reactionsSize = 0;
     if(GameEngine::instance->runChemicalReactions)
     {
+        PROFILE_SCOPE("Reaction shader");
         chemicalOutputDataBuffer.ClearBuffer(numberOfVoxels, GL_DYNAMIC_DRAW);
         this->BindReactionShaderBuffers();
         this->reactionShader->Use();
 
         this->reactionShader->SetUnsignedInt("NumberOfVoxels", bufferNumberOfVoxels);
-        uint32_t randomNumber = static_cast<uint32_t>(rand() % 1000);
+        uint32_t randomNumber = static_cast<uint32_t>(Volume::voxelRandomGenerator.GetInt(0, 999));
         this->reactionShader->SetUnsignedInt("randomNumber", randomNumber);
 
         this->reactionShader->Run(Volume::Chunk::CHUNK_SIZE/8, Volume::Chunk::CHUNK_SIZE/4, chunkCount);
@@ -182,24 +232,63 @@ void Shader::ChunkShaderManager::BatchRunChunkShaders(ChunkMatrix &chunkMatrix)
         reactionOutput = chemicalOutputDataBuffer.ReadBuffer(reactionsSize);
     }
 
-    // Apply the heat and pressure updates
-    #pragma omp parallel for
-    for (uint32_t i = 0; i < numberOfVoxels; i++) {
-        uint16_t index = i / Volume::Chunk::CHUNK_SIZE_SQUARED;
-        //if(!availableTickets.contains(ticketIndex))
-        //    continue;
-
-        uint16_t voxelIndex = i % Volume::Chunk::CHUNK_SIZE_SQUARED;	
-        uint16_t x = voxelIndex % Volume::Chunk::CHUNK_SIZE;
-        uint16_t y = voxelIndex / Volume::Chunk::CHUNK_SIZE;
-
-        auto& chunk = chunksToUpdate[index];
-        if(heatOutput) chunk->voxels[y][x]->temperature = Volume::Temperature(heatOutput[i]);
-        if(pressureOutput) chunk->voxels[y][x]->amount = pressureOutput[i];
-
-        std::string newId = chunk->voxels[y][x]->ShouldTransitionToID();
-        if(!newId.empty()){
-            chunk->voxels[y][x]->DieAndReplace(chunkMatrix, newId);
+    {
+        PROFILE_SCOPE("Apply heat and pressure");
+        // replacement voxels may roll random numbers, deterministic matrices apply them in order
+        #pragma omp parallel for schedule(dynamic) if(!chunkMatrix.IsDeterministic())
+        for (int32_t i = 0; i < static_cast<int32_t>(chunkCount); i++) {
+            Volume::Chunk *chunk = chunksToUpdate[i];
+            Volume::ChunkLockGuard chunkLock;
+            chunkLock.AddExclusive(chunk);
+            chunkLock.Lock();
+
+            const uint32_t offset = i * Volume::Chunk::CHUNK_SIZE_SQUARED;
+            // Compressed chunks stay compressed unless the simulation changed them. Only the exclusive
+            // voxel mutex compresses chunks, a compressed chunk is still the one that got uploaded
+            if(chunk->IsCompressed()){
+                if(chunk->MatchesSimulationOutput(
+                    heatOutput ? heatOutput + offset : nullptr,
+                    pressureOutput ? pressureOutput + offset : nullptr))
+                    continue;
+                chunk->Expand();
+            }
+
+            // Apply the heat and pressure updates
+            UploadedChunkVoxels &uploaded = this->uploadedVoxels[i];
+            uint64_t discardedVoxels = 0;
+            for (uint16_t voxelIndex = 0; voxelIndex < Volume::Chunk::CHUNK_SIZE_SQUARED; voxelIndex++) {
+                // the voxel pass moved or changed the voxel after the upload, it keeps that state
+                if(!IsVoxelUnchanged(*chunk, uploaded, voxelIndex)){
+                    discardedVoxels++;
+                    continue;
+                }
+
+                uint16_t x = voxelIndex % Volume::Chunk::CHUNK_SIZE;
+                uint16_t y = voxelIndex / Volume::Chunk::CHUNK_SIZE;
+
+                Volume::VoxelHandle handle = chunk->GetVoxelHandle(Vec2i(x, y));
+                if(heatOutput){
+                    chunk->voxels[y][x]->temperature = Volume::Temperature(heatOutput[offset + voxelIndex]);
+                    handle.SetTemperature(heatOutput[offset + voxelIndex]);
+                }
+                if(pressureOutput){
+                    chunk->voxels[y][x]->amount = pressureOutput[offset + voxelIndex];
+                    handle.SetAmount(pressureOutput[offset + voxelIndex]);
+                }
+
+                Volume::MaterialID newId = chunk->voxels[y][x]->ShouldTransitionToID();
+                if(newId != Volume::INVALID_MATERIAL_ID){
+                    chunk->voxels[y][x]->DieAndReplace(chunkMatrix, newId);
+                }
+
+                // reactions of this voxel still apply on top of the new heat and pressure
+                RefreshUploadedVoxel(*chunk, uploaded, voxelIndex);
+            }
+
+            if(discardedVoxels > 0){
+                #pragma omp atomic
+                discardedResults += discardedVoxels;
+            }
         }
     }
 
@@ -209,24 +298,50 @@ void Shader::ChunkShaderManager::BatchRunChunkShaders(ChunkMatrix &chunkMatrix)
         chunkIndexToPosOffset[i] = chunksToUpdate[i]->GetPos() * Volume::Chunk::CHUNK_SIZE;
     }
 
-    //Place voxels that underwent chemical reactions
-    //#pragma omp parallel for ( crashes :( )
-    for(uint32_t i = 0; i < reactionsSize; i++) {
-        ChemicalVoxelChanges& change = reactionOutput[i];
-        std::string stringID = Registry::VoxelRegistry::GetStringID(change.voxelID);
-        Vec2i voxelPos =  Vec2i(change.localPosX, change.localPosY) + chunkIndexToPosOffset[change.chunk];
-
-        Volume::VoxelElement* oldVoxel = chunkMatrix.VirtualGetAt(voxelPos, false);
-        Volume::VoxelElement* voxel = CreateVoxelElement(
-            stringID, 
-            voxelPos, 
-            oldVoxel->amount, 
-            oldVoxel->temperature,
-            oldVoxel->IsUnmoveableSolid()
-        );
-        chunkMatrix.PlaceVoxelAt(voxel, true, true);
+    // the shader appends reactions in whatever order its invocations finish
+    if(chunkMatrix.IsDeterministic()){
+        std::sort(reactionOutput, reactionOutput + reactionsSize, [](const ChemicalVoxelChanges &a, const ChemicalVoxelChanges &b) {
+            if(a.chunk != b.chunk) return a.chunk < b.chunk;
+            if(a.localPosY != b.localPosY) return a.localPosY < b.localPosY;
+            if(a.localPosX != b.localPosX) return a.localPosX < b.localPosX;
+            return a.voxelID < b.voxelID;
+        });
     }
 
+    {
+        PROFILE_SCOPE("Apply reactions");
+        //Place voxels that underwent chemical reactions
+        //#pragma omp parallel for ( crashes :( )
+        for(uint32_t i = 0; i < reactionsSize; i++) {
+            ChemicalVoxelChanges& change = reactionOutput[i];
+            Vec2i voxelPos =  Vec2i(change.localPosX, change.localPosY) + chunkIndexToPosOffset[change.chunk];
+
+            Volume::Chunk *chunk = chunksToUpdate[change.chunk];
+            Volume::ChunkLockGuard chunkLock;
+            chunkLock.AddExclusive(chunk);
+            chunkLock.Lock();
+            // the reaction was found on a voxel that is gone by now
+            const uint16_t voxelIndex = Volume::ChunkVoxelStorage::Index(change.localPosX, change.localPosY);
+            if(!IsVoxelUnchanged(*chunk, this->uploadedVoxels[change.chunk], voxelIndex)){
+                discardedResults++;
+                continue;
+            }
+
+            Volume::VoxelElement* oldVoxel = chunkMatrix.VirtualGetAt(voxelPos, false);
+            Volume::VoxelElement* voxel = CreateVoxelElement(
+                change.voxelID, 
+                voxelPos, 
+                oldVoxel->amount, 
+                oldVoxel->temperature,
+                oldVoxel->IsUnmoveableSolid()
+            );
+            chunkMatrix.PlaceVoxelAt(voxel, true, true);
+            RefreshUploadedVoxel(*chunk, this->uploadedVoxels[change.chunk], voxelIndex);
+        }
+    }
+
+    Debug::Stats::Add(Debug::StatCounter::GPUResultsDiscarded, discardedResults);
+
     delete[] heatOutput;
     delete[] pressureOutput;
     delete[] reactionOutput;
@@ -5,12 +5,22 @@
 #include "Shader/Buffer/GLGroupStorageBuffer.h"
 
 #include <cstdint>
+#include <vector>
 #include <GL/glew.h>
 
+#include "World/ChunkVoxelStorage.h"
+
 class ChunkMatrix; // Forward declaration
 struct ChunkConnectivityData; // Forward declaration for template usage
 
 namespace Shader{
+       /// @brief Simulation inputs of a chunk as they were uploaded to the GPU
+       struct UploadedChunkVoxels {
+              uint16_t materialId[Volume::ChunkVoxelStorage::SIZE_SQUARED];
+              float temperature[Volume::ChunkVoxelStorage::SIZE_SQUARED];
+              float amount[Volume::ChunkVoxelStorage::SIZE_SQUARED];
+       };
+
        class ChunkShaderManager {
        public:
               ChunkShaderManager();
@@ -54,6 +64,10 @@ namespace Shader{
 
               GLBuffer<uint32_t, GL_ATOMIC_COUNTER_BUFFER> atomicCounterBuffer;
 
+              // the voxel pass runs next to a batch, results only land on voxels that still match their upload.
+              // Kept between batches to reuse the allocation
+              std::vector<UploadedChunkVoxels> uploadedVoxels;
+
               // -------------------
 
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Shader/Shader.h"
+#include "Debug/Stats.h"
 #include <cstring>
 #include <iostream>
 
@@ -36,6 +37,7 @@ void Shader::ComputeShader::UploadDataToBuffer(GLuint buffer, const T *data, siz
 {
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
     glBufferData(GL_SHADER_STORAGE_BUFFER, size * sizeof(T), data, GL_STATIC_DRAW);
+    if(data) Debug::Stats::Add(Debug::StatCounter::GPUBytesUploaded, size * sizeof(T));
 }
 
 /**
@@ -65,6 +67,7 @@ T *Shader::ComputeShader::ReadDataFromBuffer(GLuint buffer, size_t size)
     T* result = new T[size];
     std::memcpy(result, data, size * sizeof(T));
     glUnmapBuffer(GL_SHADER_STORAGE_BUFFER);
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesReadBack, size * sizeof(T));
     return result;
 }
 
@@ -75,5 +78,6 @@ inline T Shader::ComputeShader::ReadDataFromAtomicCounter(GLuint counter)
     T result = T();
     glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(T), &result);
     glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+    Debug::Stats::Add(Debug::StatCounter::GPUBytesReadBack, sizeof(T));
     return result;
 }
@@ -0,0 +1,197 @@
+#include "Threading/TaskScheduler.h"
+
+#include <algorithm>
+#include <string>
+
+#include "Debug/Profiler.h"
+
+using namespace Threading;
+
+void TaskGraph::Reset(size_t taskCount)
+{
+    this->dependencyCounts.assign(taskCount, 0);
+    this->inlineTasks.assign(taskCount, 0);
+
+    // keep the capacity of the successor lists for the next build
+    if(this->successors.size() > taskCount) this->successors.resize(taskCount);
+    for(std::vector<uint32_t> &list : this->successors) list.clear();
+    this->successors.resize(taskCount);
+}
+
+void TaskGraph::AddDependency(uint32_t before, uint32_t after)
+{
+    this->successors[before].push_back(after);
+    this->dependencyCounts[after]++;
+}
+
+TaskScheduler::TaskScheduler(unsigned int workerCount)
+{
+    if(workerCount == 0)
+        workerCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+    this->queues = std::make_unique<TaskQueue[]>(workerCount + 1);
+    for(unsigned int i = 0; i < workerCount; ++i)
+        this->workers.emplace_back(&TaskScheduler::WorkerLoop, this, i);
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->wakeMutex);
+        this->stopping = true;
+    }
+    this->wakeUp.notify_all();
+
+    for(std::thread &worker : this->workers)
+        worker.join();
+}
+
+void TaskScheduler::Run(const TaskGraph &graph, const std::function<void(uint32_t)> &task)
+{
+    std::lock_guard<std::mutex> runLock(this->runMutex);
+    this->RunLocked(graph, task);
+}
+
+void TaskScheduler::ParallelFor(uint32_t count, const std::function<void(uint32_t)> &task)
+{
+    // the graph is shared between calls
+    std::lock_guard<std::mutex> runLock(this->runMutex);
+    this->parallelForGraph.Reset(count);
+    this->RunLocked(this->parallelForGraph, task);
+}
+
+/// @warning call with `runMutex` locked
+void TaskScheduler::RunLocked(const TaskGraph &graph, const std::function<void(uint32_t)> &task)
+{
+    const size_t taskCount = graph.GetTaskCount();
+    if(taskCount == 0) return;
+
+    Job job;
+    job.graph = &graph;
+    job.task = &task;
+    job.dependencyCounts = std::make_unique<std::atomic<uint32_t>[]>(taskCount);
+    job.remaining.store(taskCount, std::memory_order_relaxed);
+    for(size_t i = 0; i < taskCount; ++i)
+        job.dependencyCounts[i].store(graph.dependencyCounts[i], std::memory_order_relaxed);
+
+    // spread the tasks that can start right away, so every worker begins with its own queue
+    const unsigned int callerQueue = static_cast<unsigned int>(this->workers.size());
+    std::vector<uint32_t> inlineRoots;
+    unsigned int nextQueue = 0;
+    for(uint32_t i = 0; i < taskCount; ++i){
+        if(graph.dependencyCounts[i] != 0) continue;
+
+        if(graph.inlineTasks[i]) inlineRoots.push_back(i);
+        else{
+            this->Push(nextQueue, i);
+            nextQueue = (nextQueue + 1) % (callerQueue + 1);
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->wakeMutex);
+        this->currentJob = &job;
+        this->jobGeneration++;
+        this->busyWorkers.store(static_cast<unsigned int>(this->workers.size()), std::memory_order_relaxed);
+    }
+    this->wakeUp.notify_all();
+
+    for(uint32_t root : inlineRoots)
+        this->Execute(job, root, callerQueue);
+    this->Work(job, callerQueue);
+
+    // the job lives on this stack, every worker has to be done looking at it
+    while(this->busyWorkers.load(std::memory_order_acquire) != 0)
+        std::this_thread::yield();
+
+    std::lock_guard<std::mutex> lock(this->wakeMutex);
+    this->currentJob = nullptr;
+}
+
+void TaskScheduler::WorkerLoop(unsigned int queueIndex)
+{
+    Debug::TraceRecorder::SetThreadName("Task worker " + std::to_string(queueIndex));
+
+    uint64_t seenGeneration = 0;
+    while(true){
+        Job *job = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(this->wakeMutex);
+            this->wakeUp.wait(lock, [&]{ return this->stopping || this->jobGeneration != seenGeneration; });
+            if(this->stopping) return;
+
+            seenGeneration = this->jobGeneration;
+            job = this->currentJob;
+        }
+
+        if(job) this->Work(*job, queueIndex);
+        this->busyWorkers.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+void TaskScheduler::Work(Job &job, unsigned int queueIndex)
+{
+    uint32_t task;
+    while(job.remaining.load(std::memory_order_acquire) != 0){
+        if(this->TryPop(queueIndex, task)) this->Execute(job, task, queueIndex);
+        // tasks still running may release new ones any moment
+        else std::this_thread::yield();
+    }
+}
+
+void TaskScheduler::Execute(Job &job, uint32_t task, unsigned int queueIndex)
+{
+    thread_local std::vector<uint32_t> inlineTasks;
+    inlineTasks.push_back(task);
+
+    while(!inlineTasks.empty()){
+        uint32_t current = inlineTasks.back();
+        inlineTasks.pop_back();
+
+        (*job.task)(current);
+
+        for(uint32_t successor : job.graph->successors[current]){
+            if(job.dependencyCounts[successor].fetch_sub(1, std::memory_order_acq_rel) != 1) continue;
+
+            if(job.graph->inlineTasks[successor]) inlineTasks.push_back(successor);
+            else this->Push(queueIndex, successor);
+        }
+
+        job.remaining.fetch_sub(1, std::memory_order_release);
+    }
+}
+
+bool TaskScheduler::TryPop(unsigned int queueIndex, uint32_t &task)
+{
+    const unsigned int queueCount = static_cast<unsigned int>(this->workers.size()) + 1;
+
+    // own queue first, newest task
+    {
+        TaskQueue &own = this->queues[queueIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if(!own.tasks.empty()){
+            task = own.tasks.back();
+            own.tasks.pop_back();
+            return true;
+        }
+    }
+
+    // steal the oldest task of the next worker that has one
+    for(unsigned int offset = 1; offset < queueCount; ++offset){
+        TaskQueue &victim = this->queues[(queueIndex + offset) % queueCount];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if(!victim.tasks.empty()){
+            task = victim.tasks.front();
+            victim.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskScheduler::Push(unsigned int queueIndex, uint32_t task)
+{
+    TaskQueue &queue = this->queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(task);
+}
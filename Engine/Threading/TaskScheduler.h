@@ -0,0 +1,91 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Threading
+{
+	/// @brief Tasks (indices 0..N-1) and the order some of them have to run in
+	/// @note Meant to be rebuilt every run, `Reset` keeps the allocations
+	class TaskGraph {
+	public:
+		void Reset(size_t taskCount);
+		size_t GetTaskCount() const { return dependencyCounts.size(); }
+
+		/// @brief `after` starts only once `before` has finished
+		void AddDependency(uint32_t before, uint32_t after);
+		/// @brief Cheap tasks never get queued, the thread that releases them runs them right away
+		void SetInline(uint32_t task, bool isInline) { inlineTasks[task] = isInline; }
+
+		friend class TaskScheduler;
+	private:
+		std::vector<uint32_t> dependencyCounts;
+		std::vector<std::vector<uint32_t>> successors;
+		std::vector<uint8_t> inlineTasks;	// not std::vector<bool>, written from multiple threads while building
+	};
+
+	/// @brief Work stealing thread pool. Every worker owns a queue, runs its newest task first and
+	/// steals the oldest tasks of the other workers when it runs out
+	/// @note One run at a time, the calling thread helps until the run is done. Tasks must not start
+	/// another run on the same scheduler
+	class TaskScheduler {
+	public:
+		/// @param workerCount threads besides the calling one, 0 picks one less than the hardware threads
+		explicit TaskScheduler(unsigned int workerCount = 0);
+		~TaskScheduler();
+
+		// disable copy
+		TaskScheduler(const TaskScheduler&) = delete;
+		TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+		/// @brief Runs every task of the graph, each one as soon as its dependencies finished
+		void Run(const TaskGraph &graph, const std::function<void(uint32_t)> &task);
+		/// @brief Runs `task(i)` for every i in [0, count) in any order
+		void ParallelFor(uint32_t count, const std::function<void(uint32_t)> &task);
+
+		/// @brief Workers plus the calling thread
+		unsigned int GetThreadCount() const { return static_cast<unsigned int>(workers.size()) + 1; }
+	private:
+		struct alignas(64) TaskQueue {
+			std::mutex mutex;
+			std::deque<uint32_t> tasks;
+		};
+
+		struct Job {
+			const TaskGraph *graph;
+			const std::function<void(uint32_t)> *task;
+			std::unique_ptr<std::atomic<uint32_t>[]> dependencyCounts;
+			std::atomic<size_t> remaining;
+		};
+
+		void RunLocked(const TaskGraph &graph, const std::function<void(uint32_t)> &task);
+		void WorkerLoop(unsigned int queueIndex);
+		/// @brief Runs tasks until the job has none left
+		void Work(Job &job, unsigned int queueIndex);
+		/// @brief Runs the task and everything inline it releases, queues the released regular tasks
+		void Execute(Job &job, uint32_t task, unsigned int queueIndex);
+		bool TryPop(unsigned int queueIndex, uint32_t &task);
+		void Push(unsigned int queueIndex, uint32_t task);
+
+		std::vector<std::thread> workers;
+		std::unique_ptr<TaskQueue[]> queues;	// one per worker, the last one belongs to the calling thread
+
+		std::mutex runMutex;	// one run at a time
+
+		std::mutex wakeMutex;
+		std::condition_variable wakeUp;
+		Job *currentJob = nullptr;
+		uint64_t jobGeneration = 0;
+		std::atomic<unsigned int> busyWorkers = 0;
+		bool stopping = false;
+
+		TaskGraph parallelForGraph;
+	};
+}
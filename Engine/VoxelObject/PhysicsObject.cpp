@@ -132,6 +132,15 @@ void PhysicsObject::UpdatePhysicPosition(b2WorldId worldId)
     this->UpdateBoundingBox();
 }
 
+Vec2f PhysicsObject::GetLinearVelocity() const
+{
+    if (!b2Body_IsValid(m_physicsBody) || !b2Body_IsEnabled(m_physicsBody))
+        return Vec2f(0, 0);
+
+    b2Vec2 linearVelocity = b2Body_GetLinearVelocity(m_physicsBody);
+    return Vec2f(linearVelocity.x, linearVelocity.y);
+}
+
 void PhysicsObject::DestroyPhysicsBody()
 {
     if (b2Body_IsValid(m_physicsBody)) {
@@ -21,6 +21,8 @@ public:
     PhysicsObject& operator=(const PhysicsObject&) = delete;
     PhysicsObject& operator=(PhysicsObject&&) = delete;
 
+    PhysicsObject* AsPhysicsObject() override { return this; }
+
     void UpdatePhysicsEffects(ChunkMatrix& chunkMatrix, float deltaTime);
 
     bool SetVoxelAt(const Vec2i& worldPos, Volume::VoxelElement* voxel, bool noDelete = false) override;
@@ -28,6 +30,8 @@ public:
     virtual bool CanBreakIntoParts() const { return true; }
 
     b2BodyId GetPhysicsBodyId() const { return m_physicsBody; }
+    /// @brief Linear velocity in voxels per second, zero while the body is disabled (e.g. noclip)
+    Vec2f GetLinearVelocity() const;
 
     bool dirtyColliders = true;
 	virtual void UpdateColliders(std::vector<Triangle> &triangles, std::vector<b2Vec2> &edges, b2WorldId worldId);
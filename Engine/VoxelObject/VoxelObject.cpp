@@ -6,6 +6,7 @@
 #include "World/Voxel.h"
 #include "Shader/GLVertexArray.h"
 
+#include <cmath>
 #include <iostream>
 #include <algorithm>
 
@@ -20,7 +21,7 @@ VoxelObject::VoxelObject(Vec2f position, std::vector<std::vector<Registry::Voxel
         this->voxels[y].resize(voxelData[y].size());
         for (size_t x = 0; x < voxelData[y].size(); ++x) {
             const auto &data = voxelData[y][x];
-            if (data.id.empty()) {
+            if (data.id == Volume::INVALID_MATERIAL_ID) {
                 this->voxels[y][x] = nullptr; // Empty voxel
             } else {
                 this->voxels[y][x] = CreateVoxelElement(
@@ -30,7 +31,7 @@ VoxelObject::VoxelObject(Vec2f position, std::vector<std::vector<Registry::Voxel
                     Volume::Temperature(21.0f), 
                     true
                 );
-                this->voxels[y][x]->partOfObject = true;
+                this->voxels[y][x]->SetPartOfObject(true);
                 this->voxels[y][x]->color = data.color;
             }
         }
@@ -42,19 +43,9 @@ VoxelObject::VoxelObject(Vec2f position, std::vector<std::vector<Registry::Voxel
 
     this->enabled = true;
 
-    // Create VAO and VBO for rendering
-    renderVoxelArray = Shader::GLVertexArray("VoxelObject VAO");
-    renderVoxelArray.Bind();
-
-    renderVoxelArray.AddAttribute<glm::vec2>(0, 2, *GameEngine::renderer->quadBuffer, GL_FALSE, 0, 0);                           // location 0: vec2 texCoord
-
-    renderVoxelBuffer = Shader::GLBuffer<Volume::VoxelRenderData, GL_ARRAY_BUFFER>("VoxelObject VBO");
-    renderVoxelArray.AddIntAttribute<glm::ivec2>(1, 2, renderVoxelBuffer, offsetof(Volume::VoxelRenderData, position), 1);      // location 1: vec2 worldPos
-    renderVoxelArray.AddAttribute<glm::vec4>(2, 4, renderVoxelBuffer, GL_FALSE, offsetof(Volume::VoxelRenderData, color), 1);   // location 2: vec4 color
-
-    renderVoxelArray.Unbind();
-
     this->UpdateRotatedVoxelBuffer();
+
+    // drawn by the renderer from the render snapshots, objects own no GL objects
     this->UpdateCPURenderData();
 }
 
@@ -84,7 +75,7 @@ bool VoxelObject::Update(ChunkMatrix& chunkMatrix)
 
     if(calculateHeat) maxHeatTransfer = 0.0f;
 
-    PhysicsObject* thisPhys = dynamic_cast<PhysicsObject*>(this);
+    PhysicsObject* thisPhys = this->AsPhysicsObject();
 
     bool foundVoxel = false;
 
@@ -99,8 +90,8 @@ bool VoxelObject::Update(ChunkMatrix& chunkMatrix)
                 
                 // heat transfer between voxels
                 if(calculateHeat){
-                    std::string transitionId = voxel->ShouldTransitionToID();
-                    if(!transitionId.empty()){
+                    Volume::MaterialID transitionId = voxel->ShouldTransitionToID();
+                    if(transitionId != Volume::INVALID_MATERIAL_ID){
                         float amount = voxel->amount;
                         Volume::Temperature temp = voxel->temperature;
                         delete this->voxels[y][x];
@@ -218,8 +209,8 @@ bool VoxelObject::Update(ChunkMatrix& chunkMatrix)
 
 void VoxelObject::UpdateCPURenderData()
 {
-    std::lock_guard<std::mutex> lock(GameEngine::instance->openGLMutex);
-    
+    if(!GameEngine::renderer) return;
+
     this->renderData.clear();
 
     Vec2f offset = this->position - Vec2f((rotatedVoxelBuffer[0].size()) / 2.0f, (rotatedVoxelBuffer.size()) / 2.0f);
@@ -241,12 +232,6 @@ void VoxelObject::UpdateCPURenderData()
     }
 }
 
-unsigned int VoxelObject::UpdateGPURenderBuffer()
-{
-    renderVoxelBuffer.SetData(renderData, GL_DYNAMIC_DRAW);
-    return renderData.size();
-}
-
 Volume::VoxelElement *VoxelObject::GetVoxelAt(const Vec2i &worldPos) const
 {
     // True center of the buffer
@@ -305,7 +290,7 @@ bool VoxelObject::SetVoxelAt(const Vec2i &worldPos, Volume::VoxelElement *voxel,
         delete this->voxels[localPos.y][localPos.x];
     }
 
-    voxel->partOfObject = true;
+    voxel->SetPartOfObject(true);
     this->voxels[localPos.y][localPos.x] = voxel;
     this->rotatedVoxelBuffer[iy][ix] = voxel;
 
@@ -7,12 +7,15 @@
 #include "Math/AABB.h"
 #include "World/Chunk.h"
 
+#include <cmath>
 #include <iostream>
 
 namespace Registry {
     struct VoxelData;
 }
 
+class PhysicsObject;
+
 class VoxelObject{
 public:
     VoxelObject() = default;
@@ -30,9 +33,13 @@ public:
 
     virtual bool Update(ChunkMatrix& chunkMatrix);
 
+    /// @brief Returns this object as a PhysicsObject or nullptr if it is not one (avoids dynamic_cast)
+    virtual PhysicsObject* AsPhysicsObject() { return nullptr; }
+
     virtual bool ShouldRender() const { return true; };
     virtual void UpdateCPURenderData();
-    virtual unsigned int UpdateGPURenderBuffer();
+    /// @brief Voxels to draw, copied into the render snapshot after every simulation tick
+    const std::vector<Volume::VoxelRenderData>& GetRenderData() const { return renderData; }
 
     Vec2f GetPosition() const   { return position; }
     // Get rotation in radians
@@ -60,8 +67,6 @@ public:
 
     std::string GetName() const { return name; }
 
-    Shader::GLVertexArray renderVoxelArray;
-
     std::vector<std::vector<Volume::VoxelElement*>> voxels;
     // VoxelElement buffer for rotated voxels
     // Includes empty pointers for empty voxels
@@ -81,8 +86,6 @@ protected:
 
     bool dirtyRotation = true;
     float bufferRotation = 0.0f;
-
-    Shader::GLBuffer<Volume::VoxelRenderData, GL_ARRAY_BUFFER> renderVoxelBuffer;
 private:
     static constexpr float ROTATION_BUFFER_THRESHOLD = M_PI_2 * 0.03f; // 1.5 degrees
 
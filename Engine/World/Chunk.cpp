@@ -4,64 +4,146 @@
 #include <cmath>
 #include <iostream>
 #include <algorithm>
+#include <bit>
 #include <cstring>
 
 #include "GameEngine.h"
+#include "Debug/Stats.h"
 #include "World/Particles/SolidFallingParticle.h"
 #include "Physics/Physics.h"
 
 
 using namespace Volume; 
 
-void DirtyRect::Include(Vec2i pos)
+namespace {
+    glm::vec4 UnpackRenderColor(uint32_t color)
+    {
+        constexpr float scale = 1.0f / 255.0f;
+        return glm::vec4(
+            static_cast<float>(color & 0xFF) * scale,
+            static_cast<float>((color >> 8) & 0xFF) * scale,
+            static_cast<float>((color >> 16) & 0xFF) * scale,
+            static_cast<float>((color >> 24) & 0xFF) * scale
+        );
+    }
+}
+
+static_assert(DirtyTiles::TILE_SIZE * DirtyTiles::TILES_PER_ROW == Chunk::CHUNK_SIZE, "dirty tiles have to cover the chunk");
+
+void DirtyTiles::Include(Vec2i pos)
 {
-    m_startW.x = std::min(m_startW.x, pos.x);
-    m_startW.y = std::min(m_startW.y, pos.y);
-    m_endW.x = std::max(m_endW.x, pos.x);
-    m_endW.y = std::max(m_endW.y, pos.y);
+    const int tile = TileIndex(pos.x, pos.y);
+    const uint8_t x = static_cast<uint8_t>(pos.x);
+    const uint8_t y = static_cast<uint8_t>(pos.y);
+
+    TileBounds &tileBounds = m_boundsW[tile];
+    if(!((m_maskW >> tile) & 1)){
+        m_maskW |= uint64_t(1) << tile;
+        tileBounds = { x, y, x, y };
+        return;
+    }
+
+    tileBounds.startX = std::min(tileBounds.startX, x);
+    tileBounds.startY = std::min(tileBounds.startY, y);
+    tileBounds.endX = std::max(tileBounds.endX, x);
+    tileBounds.endY = std::max(tileBounds.endY, y);
 }
 
-void DirtyRect::Update()
+void DirtyTiles::Update()
 {
-    this->start = m_startW-Vec2i(DIRTY_RECT_PADDING, DIRTY_RECT_PADDING);  
-    this->end = m_endW+Vec2i(DIRTY_RECT_PADDING*2, DIRTY_RECT_PADDING*2);
+    constexpr int LAST = Chunk::CHUNK_SIZE - 1;
+
+    uint64_t newMask = 0;
+    for(uint64_t working = m_maskW; working != 0; working &= working - 1){
+        const TileBounds &tileBounds = m_boundsW[std::countr_zero(working)];
+
+        const int startX = std::max(tileBounds.startX - DIRTY_RECT_PADDING, 0);
+        const int startY = std::max(tileBounds.startY - DIRTY_RECT_PADDING, 0);
+        const int endX = std::min(tileBounds.endX + DIRTY_RECT_PADDING*2, LAST);
+        const int endY = std::min(tileBounds.endY + DIRTY_RECT_PADDING*2, LAST);
+
+        // the padded box can reach into the tiles around, every one of them gets its part
+        for(int ty = startY / TILE_SIZE; ty <= endY / TILE_SIZE; ++ty){
+            for(int tx = startX / TILE_SIZE; tx <= endX / TILE_SIZE; ++tx){
+                const int tile = ty * TILES_PER_ROW + tx;
+                const TileBounds clipped = {
+                    static_cast<uint8_t>(std::max(startX, tx * TILE_SIZE)),
+                    static_cast<uint8_t>(std::max(startY, ty * TILE_SIZE)),
+                    static_cast<uint8_t>(std::min(endX, tx * TILE_SIZE + TILE_SIZE - 1)),
+                    static_cast<uint8_t>(std::min(endY, ty * TILE_SIZE + TILE_SIZE - 1))
+                };
+
+                TileBounds &target = this->bounds[tile];
+                if(!((newMask >> tile) & 1)){
+                    newMask |= uint64_t(1) << tile;
+                    target = clipped;
+                    continue;
+                }
+                target.startX = std::min(target.startX, clipped.startX);
+                target.startY = std::min(target.startY, clipped.startY);
+                target.endX = std::max(target.endX, clipped.endX);
+                target.endY = std::max(target.endY, clipped.endY);
+            }
+        }
+    }
 
-    this->start.x = std::max(this->start.x, 0);
-    this->start.y = std::max(this->start.y, 0);
-    this->end.x = std::min(this->end.x, static_cast<int>(Chunk::CHUNK_SIZE));
-    this->end.y = std::min(this->end.y, static_cast<int>(Chunk::CHUNK_SIZE));
+    this->mask = newMask;
+    m_maskW = 0;
+}
 
-    m_startW = Vec2i(INT_MAX, INT_MAX);
-    m_endW = Vec2i(INT_MIN, INT_MIN);
+uint32_t DirtyTiles::GetArea() const
+{
+    uint32_t area = 0;
+    for(uint64_t tiles = this->mask; tiles != 0; tiles &= tiles - 1){
+        const TileBounds &tileBounds = this->bounds[std::countr_zero(tiles)];
+        area += (tileBounds.endX - tileBounds.startX + 1) * (tileBounds.endY - tileBounds.startY + 1);
+    }
+    return area;
 }
 
-bool DirtyRect::IsEmpty() const
+const Vec2i Volume::Chunk::NEIGHBOR_OFFSETS[static_cast<uint8_t>(ChunkNeighbor::Count)] = {
+    vector::UP,
+    vector::DOWN,
+    vector::LEFT,
+    vector::RIGHT,
+    vector::UP + vector::LEFT,
+    vector::UP + vector::RIGHT,
+    vector::DOWN + vector::LEFT,
+    vector::DOWN + vector::RIGHT,
+};
+
+ChunkNeighbor Volume::Chunk::OppositeNeighbor(ChunkNeighbor direction)
 {
-    return this->start.x == INT_MAX-DIRTY_RECT_PADDING;
+    switch (direction)
+    {
+    case ChunkNeighbor::Up:         return ChunkNeighbor::Down;
+    case ChunkNeighbor::Down:       return ChunkNeighbor::Up;
+    case ChunkNeighbor::Left:       return ChunkNeighbor::Right;
+    case ChunkNeighbor::Right:      return ChunkNeighbor::Left;
+    case ChunkNeighbor::UpLeft:     return ChunkNeighbor::DownRight;
+    case ChunkNeighbor::UpRight:    return ChunkNeighbor::DownLeft;
+    case ChunkNeighbor::DownLeft:   return ChunkNeighbor::UpRight;
+    case ChunkNeighbor::DownRight:  return ChunkNeighbor::UpLeft;
+    default:                        return ChunkNeighbor::Count;
+    }
 }
 
 Volume::Chunk::Chunk(const Vec2i &pos) : m_x(pos.x), m_y(pos.y)
 {
-    Vec2i chunkWorldPos = Vec2i(m_x * CHUNK_SIZE, m_y * CHUNK_SIZE);
-    for(uint8_t y = 0; y < CHUNK_SIZE; y++){
-        for(uint8_t x = 0; x < CHUNK_SIZE; x++){
-            renderData[y][x].position = glm::ivec2(
-                (chunkWorldPos.x + x),
-                (chunkWorldPos.y + y)
-            );
-            renderData[y][x].color = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f); // default color purple TODO: idk fix
-        }
+    this->voxelStorage = std::make_unique<ChunkVoxelStorage>();
 
-        this->updatePressureBuffer = true;
-        this->updateTemperatureBuffer = true;
-        this->updateRenderTemperatureBuffer = true;
-        this->updateVoxelBuffer = true;
-        this->updateRenderData = true;
-    }
+    this->updatePressureBuffer = true;
+    this->updateTemperatureBuffer = true;
+    this->updateRenderTemperatureBuffer = true;
+    this->updateVoxelBuffer = true;
+    this->updateRenderData = true;
 }
 
 Volume::Chunk::~Chunk()
 {
+    // compressed chunks hold no voxels
+    if(this->IsCompressed()) return;
+
     for (unsigned short int i = 0; i < Chunk::CHUNK_SIZE; i++)
     {
         for (unsigned short int  j = 0; j < Chunk::CHUNK_SIZE; j++)
@@ -71,6 +153,31 @@ Volume::Chunk::~Chunk()
     }
 }
 
+/// @brief Returns render data that can be overwritten, a new array if a render snapshot still holds the current one
+VoxelRenderData *Volume::Chunk::AcquireWritableRenderData()
+{
+    if(this->renderData && this->renderData.use_count() == 1){
+        // pairs with the release of the last snapshot that dropped it
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return this->renderData.get();
+    }
+
+    this->renderData = std::make_shared<VoxelRenderData[]>(CHUNK_SIZE_SQUARED);
+
+    Vec2i chunkWorldPos = Vec2i(m_x * CHUNK_SIZE, m_y * CHUNK_SIZE);
+    for(uint8_t y = 0; y < CHUNK_SIZE; y++){
+        for(uint8_t x = 0; x < CHUNK_SIZE; x++){
+            VoxelRenderData &data = this->renderData[ChunkVoxelStorage::Index(x, y)];
+            data.position = glm::ivec2(
+                (chunkWorldPos.x + x),
+                (chunkWorldPos.y + y)
+            );
+            data.color = glm::vec4(1.0f, 0.0f, 1.0f, 1.0f); // default color purple TODO: idk fix
+        }
+    }
+    return this->renderData.get();
+}
+
 /// @brief Initializes the buffers for the chunk
 /// @warning Only run on the main thread. Should by called by the engine in most cases
 void Volume::Chunk::InitializeBuffers()
@@ -110,14 +217,11 @@ void Volume::Chunk::InitializeBuffers()
 
     heatRenderingVAO.Unbind();
     // --------------
-
-    // Update the instance VBO with the new render data
-    renderVBO.SetData(*renderData, CHUNK_SIZE_SQUARED, GL_DYNAMIC_DRAW);
 }
 bool Volume::Chunk::ShouldChunkDelete(AABB Camera) const
 {
     if(lastCheckedCountDown > 0) return false;
-    if(!this->dirtyRect.IsEmpty()) return false;
+    if(!this->dirtyTiles.IsEmpty()) return false;
     if(Camera.Expand(Chunk::CHUNK_SIZE/2).Overlaps(this->GetAABB())) return false;
 
     return true;
@@ -149,25 +253,27 @@ void Volume::Chunk::UpdateComputeGPUBuffers(
         return;
     }
     
-    if(updatePressureBuffer){
-        float pressureBufferData[CHUNK_SIZE_SQUARED];
-        for (int y = 0; y < CHUNK_SIZE; ++y) {
-            for (int x = 0; x < CHUNK_SIZE; ++x) {
-                pressureBufferData[y * CHUNK_SIZE + x] = voxels[y][x]->amount;
-            }
+    // compressed chunks are decoded into a temporary storage for the upload
+    std::unique_ptr<ChunkVoxelStorage> decoded;
+    if(this->IsCompressed()){
+        decoded = std::make_unique<ChunkVoxelStorage>();
+        for(uint16_t i = 0; i < CHUNK_SIZE_SQUARED; ++i){
+            const ChunkPaletteEntry &entry = palette->Get(i);
+            decoded->materialId[i] = static_cast<uint16_t>(entry.material);
+            decoded->temperature[i] = entry.temperature;
+            decoded->amount[i] = entry.amount;
         }
-        pressureBuffer.SetData(this->bufferTicket, pressureBufferData);
+    }
+    const ChunkVoxelStorage &storage = decoded ? *decoded : *voxelStorage;
+
+    // amount and temperature are already laid out the way the GPU expects them
+    if(updatePressureBuffer){
+        pressureBuffer.SetData(this->bufferTicket, storage.amount);
         updatePressureBuffer = false;
     }
 
     if(updateTemperatureBuffer){
-        float temperatureBufferData[CHUNK_SIZE_SQUARED];
-        for (int y = 0; y < CHUNK_SIZE; ++y) {
-            for (int x = 0; x < CHUNK_SIZE; ++x) {
-                temperatureBufferData[y * CHUNK_SIZE + x] = voxels[y][x]->temperature.GetCelsius();
-            }
-        }
-        temperatureBuffer.SetData(this->bufferTicket, temperatureBufferData);
+        temperatureBuffer.SetData(this->bufferTicket, storage.temperature);
         updateTemperatureBuffer = false;
     }
 
@@ -176,12 +282,13 @@ void Volume::Chunk::UpdateComputeGPUBuffers(
         float heatCapacityData[CHUNK_SIZE_SQUARED];
         float heatConductivityData[CHUNK_SIZE_SQUARED];
 
-        for(int y = 0; y < CHUNK_SIZE; ++y) {
-            for(int x = 0; x < CHUNK_SIZE; ++x) {
-                idBufferData[y * CHUNK_SIZE + x] = voxels[y][x]->properties->id;
-                heatCapacityData[y * CHUNK_SIZE + x] = voxels[y][x]->properties->heatCapacity;
-                heatConductivityData[y * CHUNK_SIZE + x] = voxels[y][x]->properties->heatConductivity;
-            }
+        const Registry::MaterialTable &materials = Registry::VoxelRegistry::GetMaterialTable();
+        for(int i = 0; i < CHUNK_SIZE_SQUARED; ++i) {
+            uint16_t id = storage.materialId[i];
+
+            idBufferData[i] = id;
+            heatCapacityData[i] = materials.heatCapacity[id];
+            heatConductivityData[i] = materials.heatConductivity[id];
         }
         idBuffer.SetData(this->bufferTicket, idBufferData);
         heatCapacityBuffer.SetData(this->bufferTicket, heatCapacityData);
@@ -190,34 +297,57 @@ void Volume::Chunk::UpdateComputeGPUBuffers(
     }
 }
 
+/// @brief Rebuilds the colors for the next render snapshot
+/// @note Simulation thread, runs without the renderer ever waiting for it
 void Volume::Chunk::UpdateRenderCPUData()
 {
-    if(!renderVBO.IsInitialized()) return;
-    
     if(updateRenderData){
-        for(uint8_t y = 0; y < CHUNK_SIZE; ++y) {
-            for(uint8_t x = 0; x < CHUNK_SIZE; ++x) {
-                this->renderData[y][x].color = voxels[y][x]->color.getGLMVec4();
-            }
+        VoxelRenderData *data = this->AcquireWritableRenderData();
+        if(this->IsCompressed()){
+            this->FillRenderColors(data);
+        }else{
+            for(int i = 0; i < CHUNK_SIZE_SQUARED; ++i)
+                data[i].color = UnpackRenderColor(voxelStorage->packedColor[i]);
         }
 
         this->updateRenderData = false;
-        this->updateRenderBuffer = true;
-
-        this->initializedRenderData = true;
+        this->renderVersion++;
     }
 }
-void Volume::Chunk::UpdateRenderGPUBuffers()
+void Volume::Chunk::UploadRenderData(const VoxelRenderData *data, uint64_t version)
 {
-    if(!updateRenderBuffer) return;
+    if(!data || uploadedRenderVersion.load(std::memory_order_relaxed) == version) return;
 
 	renderVBO.SetData(
-        &this->renderData[0][0],
+        data,
         CHUNK_SIZE_SQUARED,
         GL_DYNAMIC_DRAW
     );
 
-    updateRenderBuffer = false;
+    uploadedRenderVersion.store(version, std::memory_order_release);
+}
+void Volume::Chunk::ReleaseUploadedRenderData()
+{
+    // the staging data is rebuilt when the chunk changes again
+    if(this->renderData && this->IsCompressed() && this->IsRenderDataUploaded())
+        this->renderData.reset();
+}
+
+/// @brief Recomputes the colors of a compressed chunk from its palette
+/// @note Voxel colors only depend on the material and position (`VoxelElement::GetDefaultColor`)
+void Volume::Chunk::FillRenderColors(VoxelRenderData *data) const
+{
+    const std::vector<ChunkPaletteEntry> &entries = palette->GetEntries();
+    Vec2i chunkWorldPos = Vec2i(m_x * CHUNK_SIZE, m_y * CHUNK_SIZE);
+
+    for(uint16_t y = 0; y < CHUNK_SIZE; ++y){
+        for(uint16_t x = 0; x < CHUNK_SIZE; ++x){
+            uint16_t index = ChunkVoxelStorage::Index(x, y);
+            const VoxelProperty *properties = Registry::VoxelRegistry::GetProperties(entries[palette->GetIndex(index)].material);
+            RGBA color = VoxelElement::GetDefaultColor(properties, chunkWorldPos + Vec2i(x, y));
+            data[index].color = UnpackRenderColor(ChunkVoxelStorage::PackColor(color));
+        }
+    }
 }
 void Volume::Chunk::SetTemperatureAt(Vec2i pos, Temperature temperature)
 {
@@ -225,8 +355,11 @@ void Volume::Chunk::SetTemperatureAt(Vec2i pos, Temperature temperature)
     pos.x = pos.x % CHUNK_SIZE;
     pos.y = pos.y % CHUNK_SIZE;
 
+    this->EnsureExpanded();
+
     // set the temperature
     voxels[pos.y][pos.x]->temperature = temperature;
+    voxelStorage->temperature[ChunkVoxelStorage::Index(pos.x, pos.y)] = temperature.GetCelsius();
 
     updateTemperatureBuffer = true;
     updateRenderTemperatureBuffer = true;
@@ -237,8 +370,11 @@ void Volume::Chunk::SetPressureAt(Vec2i pos, float pressure)
     pos.x = pos.x % CHUNK_SIZE;
     pos.y = pos.y % CHUNK_SIZE;
 
+    this->EnsureExpanded();
+
     // set the pressure
     voxels[pos.y][pos.x]->amount = pressure;
+    voxelStorage->amount[ChunkVoxelStorage::Index(pos.x, pos.y)] = pressure;
 
     updatePressureBuffer = true;
 }
@@ -250,6 +386,9 @@ void Volume::Chunk::UpdatedVoxelAt(Vec2i pos)
     pos.x = pos.x % CHUNK_SIZE;
     pos.y = pos.y % CHUNK_SIZE;
 
+    this->EnsureExpanded();
+    this->SyncVoxelStorageAt(pos);
+
     // Update range
     updatePressureBuffer = true;
     updateTemperatureBuffer = true;
@@ -257,52 +396,119 @@ void Volume::Chunk::UpdatedVoxelAt(Vec2i pos)
     updateRenderData = true;
 }
 
-/// @brief Preforms cellular automata step for all voxels in the chunk
-void Volume::Chunk::UpdateVoxels(ChunkMatrix *matrix)
+/// @brief Rebuilds `voxelObjectInChunk`
+/// @note Objects move during the physics step, call with the voxel mutex locked exclusively
+void Volume::Chunk::UpdateVoxelObjectsInChunk(const std::list<VoxelObject*> &voxelObjects)
 {
-    // update vector of objects in chunk
     this->voxelObjectInChunk.clear();
-    for(VoxelObject* obj : matrix->voxelObjects)
+    for(VoxelObject* obj : voxelObjects)
     {
         if(obj->GetBoundingBox().Overlaps(this->GetAABB()))
         {
             this->voxelObjectInChunk.push_back(obj);
         }
     }
+}
+
+/// @brief Preforms cellular automata step for all voxels in the chunk
+void Volume::Chunk::UpdateVoxels(ChunkMatrix *matrix)
+{
+    if(dirtyTiles.IsEmpty()){
+        if(idleTicks < UINT16_MAX) idleTicks++;
+        Debug::Stats::Add(Debug::StatCounter::ChunksSleeping);
+        return;
+    }
+    idleTicks = 0;
+
+    // summed locally, the stats are shared by every simulation thread
+    uint64_t voxelsStepped = 0;
+    uint64_t voxelsMoved = 0;
+    const uint64_t dirtyArea = dirtyTiles.GetArea();
+
+    // a neighbour woke this chunk up
+    this->EnsureExpanded();
+
+    // the chunk gets the same random numbers no matter which thread runs it
+    matrix->SeedVoxelRandom((static_cast<uint64_t>(static_cast<uint32_t>(m_x)) << 32) | static_cast<uint32_t>(m_y));
 
-    if(dirtyRect.IsEmpty()) return;
+    // columns go right to left and top to bottom, the same order as a single rect over the
+    // whole chunk, only the voxels outside of the dirty tiles are skipped
+    constexpr uint64_t TILE_COLUMN_MASK = 0x0101010101010101ull;
+    static_assert(DirtyTiles::TILES_PER_ROW == 8, "TILE_COLUMN_MASK expects 8 tiles per row");
+    const uint64_t dirtyMask = dirtyTiles.GetMask();
 
-    for (int x = dirtyRect.end.x; x >= dirtyRect.start.x; --x)
+    for (int x = CHUNK_SIZE - 1; x >= 0; --x)
     {
-        //for (int y = dirtyRect.end.y; y >= dirtyRect.start.y; --y) -> better gasses, worse solids
-        for (int y = dirtyRect.start.y; y <= dirtyRect.end.y; ++y) //better solids, worse gasses
+        const int tileX = x / DirtyTiles::TILE_SIZE;
+        if ((dirtyMask & (TILE_COLUMN_MASK << tileX)) == 0) continue;
+
+        for (int tileY = 0; tileY < DirtyTiles::TILES_PER_ROW; ++tileY)
         {
-            if(x < 0 || x >= CHUNK_SIZE || y < 0 || y >= CHUNK_SIZE) continue;
-    		if (voxels[y][x]->Step(matrix)) {
-                //add to dirty rect
-                dirtyRect.Include(Vec2i(x, y));
+            const int tile = tileY * DirtyTiles::TILES_PER_ROW + tileX;
+            if (!dirtyTiles.IsTileDirty(tile)) continue;
 
-                //if voxel is at the edge of chunk, update neighbour chunk
-    			if (x == 0) { // left
-                    Chunk* c = matrix->GetChunkAtChunkPosition(Vec2i(m_x - 1, m_y));
-                    if(c)c->dirtyRect.Include(Vec2i(CHUNK_SIZE - 1, y));
-    			}
-    			else if (x == CHUNK_SIZE - 1) { // right
-                    Chunk* c = matrix->GetChunkAtChunkPosition(Vec2i(m_x + 1, m_y));
-                    if(c)c->dirtyRect.Include(Vec2i(0, y));
-    			}
-    			if (y == 0) { // top
-                    Chunk* c = matrix->GetChunkAtChunkPosition(Vec2i(m_x, m_y - 1));
-                    if(c)c->dirtyRect.Include(Vec2i(x, CHUNK_SIZE - 1));
-    			}
-    			else if (y == CHUNK_SIZE - 1) { // bottom
-                    Chunk* c = matrix->GetChunkAtChunkPosition(Vec2i(m_x, m_y + 1));
-                    if(c)c->dirtyRect.Include(Vec2i(x, 0));
-    			}
-    		}
+            const DirtyTiles::TileBounds &bounds = dirtyTiles.GetTileBounds(tile);
+            if (x < bounds.startX || x > bounds.endX) continue;
+
+            //for (int y = bounds.endY; y >= bounds.startY; --y) -> better gasses, worse solids
+            for (int y = bounds.startY; y <= bounds.endY; ++y) //better solids, worse gasses
+            {
+                voxelsStepped++;
+                if (!voxels[y][x]->Step(matrix)) continue;
 
+                voxelsMoved++;
+                //add to dirty tiles
+                dirtyTiles.Include(Vec2i(x, y));
+
+                //if voxel is at the edge of chunk, update neighbour chunk
+                if (x == 0) { // left
+                    Chunk* c = this->GetNeighbor(ChunkNeighbor::Left);
+                    if(c)c->dirtyTiles.Include(Vec2i(CHUNK_SIZE - 1, y));
+                }
+                else if (x == CHUNK_SIZE - 1) { // right
+                    Chunk* c = this->GetNeighbor(ChunkNeighbor::Right);
+                    if(c)c->dirtyTiles.Include(Vec2i(0, y));
+                }
+                if (y == 0) { // top
+                    Chunk* c = this->GetNeighbor(ChunkNeighbor::Up);
+                    if(c)c->dirtyTiles.Include(Vec2i(x, CHUNK_SIZE - 1));
+                }
+                else if (y == CHUNK_SIZE - 1) { // bottom
+                    Chunk* c = this->GetNeighbor(ChunkNeighbor::Down);
+                    if(c)c->dirtyTiles.Include(Vec2i(x, 0));
+                }
+
+                // corners can also move diagonally into the corner chunk
+                if ((x == 0 || x == CHUNK_SIZE - 1) && (y == 0 || y == CHUNK_SIZE - 1)) {
+                    ChunkNeighbor corner = y == 0 ?
+                        (x == 0 ? ChunkNeighbor::UpLeft : ChunkNeighbor::UpRight) :
+                        (x == 0 ? ChunkNeighbor::DownLeft : ChunkNeighbor::DownRight);
+
+                    Chunk* c = this->GetNeighbor(corner);
+                    if(c)c->dirtyTiles.Include(Vec2i(CHUNK_SIZE - 1 - x, CHUNK_SIZE - 1 - y));
+                }
+            }
         }
     }
+
+    Debug::Stats::Add(Debug::StatCounter::ChunksActive);
+    Debug::Stats::Add(Debug::StatCounter::DirtyArea, dirtyArea);
+    Debug::Stats::Add(Debug::StatCounter::VoxelsStepped, voxelsStepped);
+    Debug::Stats::Add(Debug::StatCounter::VoxelsMoved, voxelsMoved);
+
+    // voxels change their temperature, amount, color and falling state in place while stepping,
+    // the material was already written with every swap
+    for (uint64_t tiles = dirtyMask; tiles != 0; tiles &= tiles - 1)
+    {
+        const DirtyTiles::TileBounds &bounds = dirtyTiles.GetTileBounds(std::countr_zero(tiles));
+        int startX = std::max(bounds.startX - 1, 0);
+        int startY = std::max(bounds.startY - 1, 0);
+        int endX = std::min(bounds.endX + 1, CHUNK_SIZE - 1);
+        int endY = std::min(bounds.endY + 1, CHUNK_SIZE - 1);
+        for (int y = startY; y <= endY; ++y)
+            for (int x = startX; x <= endX; ++x)
+                voxelStorage->Refresh(ChunkVoxelStorage::Index(x, y), voxels[y][x]);
+    }
 }
 
 void Volume::Chunk::UpdateColliders(std::vector<Triangle> &triangles, std::vector<b2Vec2> &edges, b2WorldId worldId)
@@ -335,19 +541,232 @@ void Volume::Chunk::UpdateColliders(std::vector<Triangle> &triangles, std::vecto
     m_edges.assign(edges.begin(), edges.end());
 }
 
-/// @brief Resets the voxel update data for the chunk
-/// @warning do not call without locking the voxel mutex
-/// @note main use only for simulation thread (called automatically)
-void Volume::Chunk::SIM_ResetVoxelUpdateData()
+/// @brief Rebuilds the whole dense storage from the voxel pointers
+/// @note Needed after writing into `voxels` directly (e.g. in chunk generators)
+void Volume::Chunk::SyncVoxelStorage()
 {
-    #pragma omp parallel for collapse(2)
+    if(this->IsCompressed()) return;
+
     for (int y = 0; y < CHUNK_SIZE; ++y)
-    {
         for (int x = 0; x < CHUNK_SIZE; ++x)
-        {
-            voxels[y][x]->updatedThisFrame = false;
+            voxelStorage->Write(ChunkVoxelStorage::Index(x, y), voxels[y][x]);
+}
+
+/// @brief Copies a single voxel into the dense storage
+/// @param localPos local position of the voxel inside the chunk
+void Volume::Chunk::SyncVoxelStorageAt(Vec2i localPos)
+{
+    voxelStorage->Write(ChunkVoxelStorage::Index(localPos.x, localPos.y), voxels[localPos.y][localPos.x]);
+}
+
+uint8_t Volume::Chunk::GetVoxelFlags(uint16_t index) const
+{
+    if(this->IsCompressed()) return palette->Get(index).flags;
+    return voxelStorage->flags[index];
+}
+
+/// @brief Returns true if the voxel can be recreated from a palette entry without losing anything
+bool Volume::Chunk::CanBeCompressed(const VoxelElement *voxel, Vec2i worldPos)
+{
+    if(!voxel) return false;
+    // custom voxels may carry state the palette does not know about
+    if(voxel->properties->Constructor == Registry::DefaultVoxelConstructor::Custom) return false;
+    if(voxel->IsPartOfObject() || voxel->IsFalling()) return false;
+    if(voxel->position != worldPos) return false;
+    if(const VoxelSolid *solid = voxel->AsSolid(); solid && solid->XVelocity != 0) return false;
+
+    return ChunkVoxelStorage::PackColor(voxel->color)
+        == ChunkVoxelStorage::PackColor(VoxelElement::GetDefaultColor(voxel->properties, worldPos));
+}
+
+/// @brief Replaces the voxels of an idle chunk with a palette
+/// @return true if the chunk got compressed
+/// @warning do not call without locking the voxel mutex
+bool Volume::Chunk::TryCompress()
+{
+    if(this->IsCompressed()) return false;
+    if(!dirtyTiles.IsEmpty() || !voxelObjectInChunk.empty()) return false;
+    if(updateRenderData || !IsRenderDataUploaded()) return false;
+
+    auto compressed = std::make_unique<ChunkPalette>();
+    uint8_t rawIndices[CHUNK_SIZE_SQUARED];
+    Vec2i chunkWorldPos = Vec2i(m_x * CHUNK_SIZE, m_y * CHUNK_SIZE);
+
+    for(uint16_t y = 0; y < CHUNK_SIZE; ++y){
+        for(uint16_t x = 0; x < CHUNK_SIZE; ++x){
+            const VoxelElement *voxel = voxels[y][x];
+            int index = -1;
+            if(CanBeCompressed(voxel, chunkWorldPos + Vec2i(x, y))){
+                index = compressed->FindOrAdd(ChunkPaletteEntry{
+                    voxel->properties->id,
+                    voxel->temperature.GetCelsius(),
+                    voxel->amount,
+                    ChunkVoxelStorage::FlagsOf(voxel)
+                });
+            }
+
+            if(index < 0){
+                // try again after another idle period
+                idleTicks = 0;
+                return false;
+            }
+            rawIndices[ChunkVoxelStorage::Index(x, y)] = static_cast<uint8_t>(index);
+        }
+    }
+    compressed->SetIndices(rawIndices, CHUNK_SIZE_SQUARED);
+
+    for(uint16_t y = 0; y < CHUNK_SIZE; ++y){
+        for(uint16_t x = 0; x < CHUNK_SIZE; ++x){
+            delete voxels[y][x];
+            voxels[y][x] = nullptr;
+        }
+    }
+
+    this->voxelStorage.reset();
+    this->renderData.reset();
+    this->representation.store(
+        compressed->IsUniform() ? ChunkRepresentation::Uniform : ChunkRepresentation::Palette,
+        std::memory_order_release);
+    this->palette = std::move(compressed);
+
+    return true;
+}
+
+/// @brief Recreates the voxels of a compressed chunk
+/// @note Safe to call from multiple threads, only the first caller does the work
+void Volume::Chunk::Expand()
+{
+    std::lock_guard<std::mutex> lock(this->expandMutex);
+    if(!this->IsCompressed()) return;
+
+    this->voxelStorage = std::make_unique<ChunkVoxelStorage>();
+    Vec2i chunkWorldPos = Vec2i(m_x * CHUNK_SIZE, m_y * CHUNK_SIZE);
+
+    for(uint16_t y = 0; y < CHUNK_SIZE; ++y){
+        for(uint16_t x = 0; x < CHUNK_SIZE; ++x){
+            uint16_t index = ChunkVoxelStorage::Index(x, y);
+            const ChunkPaletteEntry &entry = palette->Get(index);
+
+            voxels[y][x] = CreateVoxelElement(
+                entry.material,
+                chunkWorldPos + Vec2i(x, y),
+                entry.amount,
+                Temperature(entry.temperature),
+                (entry.flags & VoxelFlags::STATIC) != 0
+            );
+            voxelStorage->Write(index, voxels[y][x]);
+        }
+    }
+
+    this->palette.reset();
+    this->idleTicks = 0;
+    this->representation.store(ChunkRepresentation::Full, std::memory_order_release);
+}
+
+/// @brief Fills a freshly created chunk with a single material without allocating any voxels
+/// @return false if the material can not be stored compressed, the caller has to fill the chunk itself
+bool Volume::Chunk::FillUniform(MaterialID material, Temperature temperature, float amount, bool unmovable)
+{
+    const VoxelProperty *properties = Registry::VoxelRegistry::GetProperties(material);
+    if(properties->Constructor == Registry::DefaultVoxelConstructor::Custom) return false;
+
+    const Registry::MaterialTable &materials = Registry::VoxelRegistry::GetMaterialTable();
+    State state = materials.state[material];
+
+    // same flags a voxel created by CreateVoxelElement would end up with
+    uint8_t flags = static_cast<uint8_t>(state) & VoxelFlags::STATE_MASK;
+    if(state == State::Solid){
+        if(unmovable) flags |= VoxelFlags::STATIC;
+        flags |= VoxelFlags::SOLID_COLLIDER;
+    }
+
+    auto compressed = std::make_unique<ChunkPalette>();
+    compressed->FindOrAdd(ChunkPaletteEntry{ material, temperature.GetCelsius(), amount, flags });
+    compressed->SetIndices(nullptr, 0);
+
+    for(uint16_t y = 0; y < CHUNK_SIZE; ++y)
+        for(uint16_t x = 0; x < CHUNK_SIZE; ++x)
+            voxels[y][x] = nullptr;
+
+    this->voxelStorage.reset();
+    this->palette = std::move(compressed);
+    this->representation.store(ChunkRepresentation::Uniform, std::memory_order_release);
+
+    this->updatePressureBuffer = true;
+    this->updateTemperatureBuffer = true;
+    this->updateVoxelBuffer = true;
+    this->updateRenderData = true;
+    return true;
+}
+
+/// @brief Checks the heat and pressure simulation output of a compressed chunk against its palette
+/// @param temperatures simulated temperatures in Celsius, indexed like `ChunkVoxelStorage`. nullptr if heat was not simulated
+/// @param amounts simulated amounts (pressure), indexed like `ChunkVoxelStorage`. nullptr if pressure was not simulated
+bool Volume::Chunk::MatchesSimulationOutput(const float *temperatures, const float *amounts) const
+{
+    const std::vector<ChunkPaletteEntry> &entries = palette->GetEntries();
+    for(const ChunkPaletteEntry &entry : entries){
+        const VoxelProperty *properties = Registry::VoxelRegistry::GetProperties(entry.material);
+        if(VoxelElement::GetTransitionID(properties, Temperature(entry.temperature)) != INVALID_MATERIAL_ID)
+            return false;
+    }
+
+    // exact comparison, any change expands the chunk so compression never loses simulation output
+    for(uint16_t i = 0; i < CHUNK_SIZE_SQUARED; ++i){
+        const ChunkPaletteEntry &entry = entries[palette->GetIndex(i)];
+        if(temperatures && temperatures[i] != entry.temperature) return false;
+        if(amounts && amounts[i] != entry.amount) return false;
+    }
+    return true;
+}
+
+/// @brief Approximate heap memory held by the voxels of this chunk
+size_t Volume::Chunk::GetMemoryUsage() const
+{
+    size_t usage = sizeof(Chunk);
+    if(this->renderData) usage += sizeof(VoxelRenderData) * CHUNK_SIZE_SQUARED;
+
+    if(this->IsCompressed())
+        return usage + palette->GetMemoryUsage();
+
+    usage += sizeof(ChunkVoxelStorage);
+    for(uint16_t y = 0; y < CHUNK_SIZE; ++y)
+        for(uint16_t x = 0; x < CHUNK_SIZE; ++x)
+            if(voxels[y][x]) usage += VoxelAllocator::BlockSizeOf(voxels[y][x]);
+    return usage;
+}
+
+uint64_t Volume::Chunk::ComputeChecksum() const
+{
+    auto mix = [](uint64_t hash, uint64_t value) {
+        hash ^= value * 0x87C37B91114253D5ull;
+        hash = (hash << 31) | (hash >> 33);
+        return hash * 0x4CF5AD432745937Full;
+    };
+    auto bitsOf = [](float value) {
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return static_cast<uint64_t>(bits);
+    };
+
+    uint64_t hash = (static_cast<uint64_t>(static_cast<uint32_t>(m_x)) << 32) | static_cast<uint32_t>(m_y);
+    for(uint16_t index = 0; index < CHUNK_SIZE_SQUARED; ++index){
+        uint64_t material, temperature, amount;
+        if(this->IsCompressed()){
+            const ChunkPaletteEntry &entry = this->palette->Get(index);
+            material = entry.material;
+            temperature = bitsOf(entry.temperature);
+            amount = bitsOf(entry.amount);
+        }else{
+            const VoxelElement *voxel = this->voxels[index / CHUNK_SIZE][index % CHUNK_SIZE];
+            material = voxel->properties->id;
+            temperature = bitsOf(voxel->temperature.GetCelsius());
+            amount = bitsOf(voxel->amount);
         }
+        hash = mix(hash, (material << 32) | temperature);
+        hash = mix(hash, amount);
     }
+    return hash;
 }
 
 Vec2i Volume::Chunk::GetPos() const
@@ -2,6 +2,9 @@
 
 #include <SDL.h>
 #include <array>
+#include <atomic>
+#include <list>
+#include <memory>
 #include <mutex>
 #include <vector>
 #include <GL/glew.h>
@@ -14,28 +17,56 @@
 
 #include "Math/Math.h"
 
+#include "Debug/TraceRecorder.h"
+
 #include "Shader/Buffer/GLGroupStorageBuffer.h"
 
 #include "World/Voxel.h"
+#include "World/ChunkVoxelStorage.h"
+#include "World/ChunkPalette.h"
 #include "World/Particle.h"
 #include "World/ParticleGenerator.h"
 
 class VoxelObject;
 
-class DirtyRect{
+/// @brief Parts of a chunk that have to be simulated, kept as a grid of tiles with a bitmask
+/// and one bounding box per tile. Separate active areas do not make the whole chunk dirty
+class DirtyTiles{
 public:
-	Vec2i start;
-	Vec2i end;
-	DirtyRect(Vec2i start, Vec2i end) : start(start), end(end) {};
-	DirtyRect() : start(Vec2i(INT_MAX, INT_MAX)), end(Vec2i(INT_MIN, INT_MIN)) {};
+	static constexpr int TILE_SIZE = 8;
+	static constexpr int TILES_PER_ROW = 8; // Chunk::CHUNK_SIZE / TILE_SIZE
+	static constexpr int TILE_COUNT = TILES_PER_ROW * TILES_PER_ROW;
+
+	/// @brief Inclusive local voxel bounds of a tile
+	struct TileBounds{
+		uint8_t startX, startY;
+		uint8_t endX, endY;
+	};
+
 	//Takes in local voxel position
 	void Include(Vec2i pos);
+	/// @brief Pads the tiles included since the last update and makes them the current ones
+	/// @note Padding that reaches past a tile wakes up the tile next to it
 	void Update();
-	bool IsEmpty() const;
+	bool IsEmpty() const { return mask == 0; }
+
+	/// @brief Bit `ty * TILES_PER_ROW + tx` is set for every dirty tile
+	uint64_t GetMask() const { return mask; }
+	bool IsTileDirty(int tileIndex) const { return (mask >> tileIndex) & 1; }
+	const TileBounds& GetTileBounds(int tileIndex) const { return bounds[tileIndex]; }
+	/// @brief Voxels covered by the dirty tiles
+	uint32_t GetArea() const;
+
+	static int TileIndex(int x, int y) { return (y / TILE_SIZE) * TILES_PER_ROW + x / TILE_SIZE; }
 private:
 	static constexpr int DIRTY_RECT_PADDING = 1;
-	Vec2i m_startW = Vec2i(INT_MAX, INT_MAX); // working dirty rect
-	Vec2i m_endW = Vec2i(INT_MIN, INT_MIN);
+	static_assert(TILE_COUNT <= 64, "dirty tiles have to fit the bitmask");
+
+	uint64_t mask = 0;
+	TileBounds bounds[TILE_COUNT];
+
+	uint64_t m_maskW = 0; // working tiles
+	TileBounds m_boundsW[TILE_COUNT];
 };
 
 namespace Volume
@@ -44,6 +75,18 @@ namespace Volume
 		glm::ivec2 position; // position in chunk
 		glm::vec4 color; 	// RGBA color
 	};
+	/// @brief Direction of a neighbouring chunk, indexes `Chunk::NEIGHBOR_OFFSETS`
+	enum class ChunkNeighbor : uint8_t {
+		Up, Down, Left, Right,
+		UpLeft, UpRight, DownLeft, DownRight,
+		Count
+	};
+	/// @brief How the voxels of a chunk are currently stored
+	enum class ChunkRepresentation : uint8_t {
+		Full,		// heap voxels in `Chunk::voxels` plus the dense storage
+		Uniform,	// a single palette entry, no voxels allocated
+		Palette,	// up to 256 palette entries with 4 or 8 bit indices, no voxels allocated
+	};
 	struct ChunkConnectivityData{
 		int32_t chunk;
 		int32_t chunkUp;
@@ -57,14 +100,51 @@ namespace Volume
     	static const unsigned short int CHUNK_SIZE = 64; // 64
 		static const unsigned short int CHUNK_SIZE_SQUARED = CHUNK_SIZE * CHUNK_SIZE; // 4096
     	
+		static_assert(CHUNK_SIZE == ChunkVoxelStorage::SIZE, "ChunkVoxelStorage must match the chunk size");
+    	
 		VoxelElement* voxels[CHUNK_SIZE][CHUNK_SIZE];
 		std::vector<VoxelObject*> voxelObjectInChunk;
 
+		// Neighbour links, maintained by ChunkMatrix::GenerateChunk and ChunkMatrix::DeleteChunk
+		static const Vec2i NEIGHBOR_OFFSETS[static_cast<uint8_t>(ChunkNeighbor::Count)];
+		static ChunkNeighbor OppositeNeighbor(ChunkNeighbor direction);
+		Chunk* GetNeighbor(ChunkNeighbor direction) const { return neighbors[static_cast<uint8_t>(direction)].load(std::memory_order_acquire); }
+		void SetNeighbor(ChunkNeighbor direction, Chunk *chunk) { neighbors[static_cast<uint8_t>(direction)].store(chunk, std::memory_order_release); }
+
+		// Dense storage, only exists while the chunk is not compressed
+		const ChunkVoxelStorage &GetVoxelStorage() const { return *voxelStorage; }
+		VoxelHandle GetVoxelHandle(Vec2i localPos) { return VoxelHandle(voxelStorage.get(), ChunkVoxelStorage::Index(localPos.x, localPos.y)); }
+		void SyncVoxelStorage();
+		void SyncVoxelStorageAt(Vec2i localPos);
+		/// @brief Storage flags (`Volume::VoxelFlags`) of a voxel, works for compressed chunks too
+		uint8_t GetVoxelFlags(uint16_t index) const;
+
+		// Compression
+		/// @brief Compressed chunks keep every `voxels` entry null until they are expanded
+		bool IsCompressed() const { return representation.load(std::memory_order_acquire) != ChunkRepresentation::Full; }
+		ChunkRepresentation GetRepresentation() const { return representation.load(std::memory_order_acquire); }
+		/// @brief Must be called before touching `voxels` of a chunk that may be compressed
+		void EnsureExpanded() { if(IsCompressed()) [[unlikely]] Expand(); }
+		void Expand();
+		bool TryCompress();
+		bool FillUniform(MaterialID material, Temperature temperature, float amount, bool unmovable);
+		/// @brief Palette of a compressed chunk, nullptr while the chunk is expanded
+		const ChunkPalette* GetPalette() const { return IsCompressed() ? palette.get() : nullptr; }
+		/// @brief Returns true if the GPU simulation output would not change any voxel of a compressed chunk
+		bool MatchesSimulationOutput(const float *temperatures, const float *amounts) const;
+		size_t GetMemoryUsage() const;
+		/// @brief Hash of material, temperature and amount of every voxel, equal for compressed and expanded chunks
+		uint64_t ComputeChecksum() const;
+
+		// simulation steps in a row without anything moving, chunks get compressed after COMPRESS_AFTER_IDLE_TICKS
+		uint16_t idleTicks = 0;
+		static constexpr uint16_t COMPRESS_AFTER_IDLE_TICKS = 120;
+
     	Chunk(const Vec2i& pos);
     	~Chunk();
 
 		void InitializeBuffers();
-		bool IsInitialized() const { return this->renderTemperatureVBO.IsInitialized() && this->initializedRenderData; };
+		bool IsInitialized() const { return this->renderTemperatureVBO.IsInitialized(); };
 
 		bool ShouldChunkDelete(AABB Camera) const;
 		bool ShouldChunkCalculateHeat() const;
@@ -78,13 +158,23 @@ namespace Volume
 			Shader::GLGroupStorageBuffer<float> 	&heatConductivityBuffer
 		);
 		void UpdateRenderCPUData();
-		void UpdateRenderGPUBuffers();
+		/// @brief Uploads colors of a render snapshot, skipped if this version is already on the GPU
+		/// @warning Only run on the main thread
+		void UploadRenderData(const VoxelRenderData *data, uint64_t version);
+
+		/// @brief Colors as of `GetRenderVersion`, never changed once a render snapshot holds them
+		std::shared_ptr<const VoxelRenderData[]> GetRenderData() const { return renderData; }
+		uint64_t GetRenderVersion() const { return renderVersion; }
+		bool IsRenderDataUploaded() const { return uploadedRenderVersion.load(std::memory_order_acquire) == renderVersion; }
+		/// @brief Compressed chunks rarely change, their colors are freed once the renderer has them
+		void ReleaseUploadedRenderData();
 
 		void SetTemperatureAt(Vec2i pos, Temperature temperature);
 		void SetPressureAt(Vec2i pos, float pressure);
 		void UpdatedVoxelAt(Vec2i pos);
 
     	void UpdateVoxels(ChunkMatrix* matrix);
+		void UpdateVoxelObjectsInChunk(const std::list<VoxelObject*> &voxelObjects);
 
 		// Physics
 		bool dirtyColliders = true;
@@ -93,12 +183,16 @@ namespace Volume
 		std::vector<Triangle> &GetColliders() { return m_triangleColliders; }
 		std::vector<b2Vec2> &GetEdges() { return m_edges; }
 
-    	void SIM_ResetVoxelUpdateData();
 		Vec2i GetPos() const;
 		AABB GetAABB() const;
 
 		uint8_t lastCheckedCountDown = 20;
-		DirtyRect dirtyRect = DirtyRect();
+		// created from the chunk store instead of the generator function
+		bool loadedFromStore = false;
+		DirtyTiles dirtyTiles;
+
+		// Locking, see `ChunkLockGuard`
+		Debug::TracedSharedMutex voxelLock{"Wait chunk lock", Debug::StatCounter::ChunkLockWaits, Debug::StatCounter::ChunkLockWaitMicros};
 
 		// connectivity data
 		Shader::GLVertexArray renderVoxelVAO;
@@ -111,6 +205,8 @@ namespace Volume
     	short int m_x;
     	short int m_y;	
 
+		std::atomic<Chunk*> neighbors[static_cast<uint8_t>(ChunkNeighbor::Count)] = {};
+
 		b2BodyId m_physicsBody = b2_nullBodyId;
 		std::vector<Triangle> m_triangleColliders;
 		std::vector<b2Vec2> m_edges;
@@ -118,14 +214,24 @@ namespace Volume
 		void DestroyPhysicsBody();
 		void CreatePhysicsBody(b2WorldId worldId);
 
-		bool initializedRenderData = false;
+		std::unique_ptr<ChunkVoxelStorage> voxelStorage;
+
+		std::atomic<ChunkRepresentation> representation = ChunkRepresentation::Full;
+		std::unique_ptr<ChunkPalette> palette;
+		std::mutex expandMutex;
+
+		static bool CanBeCompressed(const VoxelElement *voxel, Vec2i worldPos);
+		void FillRenderColors(VoxelRenderData *data) const;
+		VoxelRenderData* AcquireWritableRenderData();
 
-		// rendering data
-		VoxelRenderData renderData[CHUNK_SIZE][CHUNK_SIZE];
+		// rendering data, indexed like `ChunkVoxelStorage`. Render snapshots share it, so a new version
+		// gets a new array unless nobody else holds the old one
+		std::shared_ptr<VoxelRenderData[]> renderData;
+		uint64_t renderVersion = 0;
+		std::atomic<uint64_t> uploadedRenderVersion = 0;	// written by the renderer
 		Shader::GLBuffer<VoxelRenderData, GL_ARRAY_BUFFER> renderVBO;
 
 		bool updateRenderData;
-		bool updateRenderBuffer = false;
 
 		bool updateVoxelBuffer;
 		bool updateTemperatureBuffer;
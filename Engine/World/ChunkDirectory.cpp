@@ -0,0 +1,93 @@
+#include "World/ChunkDirectory.h"
+
+using namespace Volume;
+
+ChunkDirectory::~ChunkDirectory()
+{
+    this->Clear();
+}
+
+/// @brief Returns the chunk at the given chunk position or nullptr if it is not loaded
+Chunk *ChunkDirectory::Find(const Vec2i &chunkPos) const
+{
+    if(!IsInPageTable(chunkPos)){
+        std::shared_lock<std::shared_mutex> lock(this->overflowMutex);
+
+        auto it = this->overflow.find(OverflowKey(chunkPos));
+        return it != this->overflow.end() ? it->second : nullptr;
+    }
+
+    const Page *page = this->pages[
+        (chunkPos.y / PAGE_SIZE) * PAGE_TABLE_SIZE + (chunkPos.x / PAGE_SIZE)
+    ].load(std::memory_order_acquire);
+    if(!page) return nullptr;
+
+    return page->chunks[
+        (chunkPos.y % PAGE_SIZE) * PAGE_SIZE + (chunkPos.x % PAGE_SIZE)
+    ].load(std::memory_order_acquire);
+}
+
+void ChunkDirectory::Insert(const Vec2i &chunkPos, Chunk *chunk)
+{
+    if(!IsInPageTable(chunkPos)){
+        std::unique_lock<std::shared_mutex> lock(this->overflowMutex);
+        this->overflow[OverflowKey(chunkPos)] = chunk;
+        return;
+    }
+
+    std::atomic<Page*> &pageSlot = this->pages[
+        (chunkPos.y / PAGE_SIZE) * PAGE_TABLE_SIZE + (chunkPos.x / PAGE_SIZE)
+    ];
+
+    Page *page = pageSlot.load(std::memory_order_acquire);
+    if(!page){
+        page = new Page();
+        pageSlot.store(page, std::memory_order_release);
+    }
+
+    page->chunks[
+        (chunkPos.y % PAGE_SIZE) * PAGE_SIZE + (chunkPos.x % PAGE_SIZE)
+    ].store(chunk, std::memory_order_release);
+}
+
+void ChunkDirectory::Remove(const Vec2i &chunkPos)
+{
+    if(!IsInPageTable(chunkPos)){
+        std::unique_lock<std::shared_mutex> lock(this->overflowMutex);
+        this->overflow.erase(OverflowKey(chunkPos));
+        return;
+    }
+
+    Page *page = this->pages[
+        (chunkPos.y / PAGE_SIZE) * PAGE_TABLE_SIZE + (chunkPos.x / PAGE_SIZE)
+    ].load(std::memory_order_acquire);
+    if(!page) return;
+
+    // the page itself is kept, other threads may still be reading from it
+    page->chunks[
+        (chunkPos.y % PAGE_SIZE) * PAGE_SIZE + (chunkPos.x % PAGE_SIZE)
+    ].store(nullptr, std::memory_order_release);
+}
+
+/// @brief Forgets all chunks and frees the pages. Does not delete the chunks themselves
+void ChunkDirectory::Clear()
+{
+    for(std::atomic<Page*> &pageSlot : this->pages){
+        delete pageSlot.exchange(nullptr, std::memory_order_acq_rel);
+    }
+
+    std::unique_lock<std::shared_mutex> lock(this->overflowMutex);
+    this->overflow.clear();
+}
+
+bool ChunkDirectory::IsInPageTable(const Vec2i &chunkPos)
+{
+    return chunkPos.x >= 0 && chunkPos.y >= 0 &&
+        chunkPos.x < PAGE_SIZE * PAGE_TABLE_SIZE &&
+        chunkPos.y < PAGE_SIZE * PAGE_TABLE_SIZE;
+}
+
+uint64_t ChunkDirectory::OverflowKey(const Vec2i &chunkPos)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkPos.x)) << 32) | static_cast<uint32_t>(chunkPos.y);
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include "Math/Vector.h"
+
+namespace Volume
+{
+	class Chunk;
+
+	/// @brief Sparse 2D directory mapping chunk positions to chunks in O(1)
+	/// @note Positions are split into fixed size pages that are allocated on first insert and kept
+	/// until `Clear`, so lookups never take a lock. Positions outside the page table fall back to a
+	/// hash map guarded by a shared mutex. Inserting and removing is expected to happen under
+	/// `ChunkMatrix::chunkCreationMutex`
+	class ChunkDirectory {
+	public:
+		ChunkDirectory() = default;
+		~ChunkDirectory();
+
+		// disable copy
+		ChunkDirectory(const ChunkDirectory&) = delete;
+		ChunkDirectory& operator=(const ChunkDirectory&) = delete;
+
+		Chunk* Find(const Vec2i &chunkPos) const;
+		void Insert(const Vec2i &chunkPos, Chunk *chunk);
+		void Remove(const Vec2i &chunkPos);
+		void Clear();
+
+		static constexpr int PAGE_SIZE = 32;			// chunks per page side
+		static constexpr int PAGE_TABLE_SIZE = 128;		// pages per page table side
+	private:
+		struct Page {
+			std::atomic<Chunk*> chunks[PAGE_SIZE * PAGE_SIZE] = {};
+		};
+
+		static bool IsInPageTable(const Vec2i &chunkPos);
+		static uint64_t OverflowKey(const Vec2i &chunkPos);
+
+		std::atomic<Page*> pages[PAGE_TABLE_SIZE * PAGE_TABLE_SIZE] = {};
+
+		mutable std::shared_mutex overflowMutex;
+		std::unordered_map<uint64_t, Chunk*> overflow;
+	};
+}
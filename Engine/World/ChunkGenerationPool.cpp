@@ -0,0 +1,167 @@
+#include "World/ChunkGenerationPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "Debug/Logger.h"
+#include "Debug/Profiler.h"
+#include "World/ChunkMatrix.h"
+
+using namespace Volume;
+
+ChunkGenerationPool::ChunkGenerationPool(ChunkMatrix *matrix, unsigned int workerCount)
+    : matrix(matrix), workerCount(std::max(1u, workerCount))
+{
+}
+
+ChunkGenerationPool::~ChunkGenerationPool()
+{
+    this->Stop();
+}
+
+uint64_t ChunkGenerationPool::Key(const Vec2i &chunkPos)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkPos.x)) << 32) | static_cast<uint32_t>(chunkPos.y);
+}
+
+bool ChunkGenerationPool::Request(const Vec2i &chunkPos, ChunkGenerationPriority priority)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    if(this->stopping) return false;
+
+    auto it = this->pending.find(Key(chunkPos));
+    if(it != this->pending.end()){
+        // the stale queue entry is skipped by the workers
+        if(it->second.state == RequestState::Queued && priority < it->second.priority){
+            it->second.priority = priority;
+            this->queue.push(QueuedRequest{ priority, this->nextSequence++, chunkPos });
+        }
+        return false;
+    }
+
+    if(this->workers.empty()) this->StartWorkers();
+
+    this->pending[Key(chunkPos)] = PendingRequest{ RequestState::Queued, priority };
+    this->queue.push(QueuedRequest{ priority, this->nextSequence++, chunkPos });
+    this->wakeUp.notify_one();
+    return true;
+}
+
+bool ChunkGenerationPool::IsPending(const Vec2i &chunkPos) const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->pending.contains(Key(chunkPos));
+}
+
+std::vector<Chunk*> ChunkGenerationPool::TakeFinished(size_t maxChunks)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+
+    std::vector<Chunk*> taken;
+    if(this->finished.size() <= maxChunks){
+        taken.swap(this->finished);
+        return taken;
+    }
+
+    taken.assign(this->finished.begin(), this->finished.begin() + maxChunks);
+    this->finished.erase(this->finished.begin(), this->finished.begin() + maxChunks);
+    return taken;
+}
+
+void ChunkGenerationPool::Release(const Vec2i &chunkPos)
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    this->pending.erase(Key(chunkPos));
+}
+
+size_t ChunkGenerationPool::GetPendingCount() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->pending.size();
+}
+
+size_t ChunkGenerationPool::GetFinishedCount() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex);
+    return this->finished.size();
+}
+
+void ChunkGenerationPool::WaitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(this->mutex);
+    this->requestDone.wait(lock, [this]{
+        if(this->stopping) return true;
+        return std::none_of(this->pending.begin(), this->pending.end(), [](const auto &request) {
+            return request.second.state != RequestState::Finished;
+        });
+    });
+}
+
+void ChunkGenerationPool::Stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex);
+        this->stopping = true;
+    }
+    this->wakeUp.notify_all();
+    this->requestDone.notify_all();
+
+    for(std::thread &worker : this->workers)
+        if(worker.joinable()) worker.join();
+    this->workers.clear();
+
+    std::lock_guard<std::mutex> lock(this->mutex);
+    for(Chunk *chunk : this->finished)
+        delete chunk;
+    this->finished.clear();
+    this->pending.clear();
+    this->queue = {};
+}
+
+/// @warning call with `mutex` locked
+void ChunkGenerationPool::StartWorkers()
+{
+    for(unsigned int i = 0; i < this->workerCount; ++i)
+        this->workers.emplace_back(&ChunkGenerationPool::WorkerLoop, this);
+}
+
+void ChunkGenerationPool::WorkerLoop()
+{
+    Debug::TraceRecorder::SetThreadName("Chunk generation");
+
+    std::unique_lock<std::mutex> lock(this->mutex);
+    while(true){
+        this->wakeUp.wait(lock, [this]{ return this->stopping || !this->queue.empty(); });
+        if(this->stopping) return;
+
+        QueuedRequest request = this->queue.top();
+        this->queue.pop();
+
+        // skip requests that were raised in priority or dropped in the meantime
+        auto it = this->pending.find(Key(request.position));
+        if(it == this->pending.end() || it->second.state != RequestState::Queued || it->second.priority != request.priority)
+            continue;
+        it->second.state = RequestState::Generating;
+
+        lock.unlock();
+        Chunk *chunk = nullptr;
+        try{
+            TRACE_SCOPE("Generate chunk");
+            chunk = this->matrix->LoadOrGenerateChunk(request.position);
+        }catch(const std::exception &e){
+            Debug::LogError("Failed to generate chunk (" + std::to_string(request.position.x) + ", " + std::to_string(request.position.y) + "): " + e.what());
+        }
+        lock.lock();
+
+        if(!chunk || this->stopping){
+            delete chunk;
+            this->pending.erase(Key(request.position));
+            this->requestDone.notify_all();
+            continue;
+        }
+
+        this->pending[Key(request.position)].state = RequestState::Finished;
+        this->finished.push_back(chunk);
+        this->requestDone.notify_all();
+    }
+}
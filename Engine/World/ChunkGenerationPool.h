@@ -0,0 +1,97 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Math/Vector.h"
+
+class ChunkMatrix;
+
+namespace Volume
+{
+	class Chunk;
+
+	/// @brief Lower values are generated first
+	enum class ChunkGenerationPriority : uint8_t {
+		Visible = 0,	// inside (or right next to) the camera
+		Event = 1,		// touched by the simulation, particles, objects...
+		Background = 2,	// speculative loads
+	};
+
+	/// @brief Background workers running `ChunkMatrix::LoadOrGenerateChunk`
+	/// @note Requests are de-duplicated by chunk position. Finished chunks are not visible to
+	/// anyone until the owning `ChunkMatrix` commits them (`ChunkMatrix::CommitGeneratedChunks`)
+	class ChunkGenerationPool {
+	public:
+		ChunkGenerationPool(ChunkMatrix *matrix, unsigned int workerCount = DEFAULT_WORKER_COUNT);
+		~ChunkGenerationPool();
+
+		// disable copy
+		ChunkGenerationPool(const ChunkGenerationPool&) = delete;
+		ChunkGenerationPool& operator=(const ChunkGenerationPool&) = delete;
+
+		/// @brief Queues a chunk for generation. Re-requesting a queued chunk only raises its priority
+		/// @return false if the chunk is already queued, being generated or waiting for commit
+		bool Request(const Vec2i &chunkPos, ChunkGenerationPriority priority);
+		bool IsPending(const Vec2i &chunkPos) const;
+
+		/// @brief Hands out up to `maxChunks` finished chunks, the caller owns them
+		std::vector<Chunk*> TakeFinished(size_t maxChunks);
+		/// @brief Must be called once a chunk from `TakeFinished` is committed (or dropped)
+		void Release(const Vec2i &chunkPos);
+
+		size_t GetPendingCount() const;
+		/// @brief Chunks waiting for `TakeFinished`
+		size_t GetFinishedCount() const;
+		/// @brief Blocks until every queued request is finished (or failed)
+		void WaitUntilIdle();
+
+		/// @brief Stops and joins all workers, unfinished requests are dropped
+		void Stop();
+
+		static constexpr unsigned int DEFAULT_WORKER_COUNT = 2;
+	private:
+		struct QueuedRequest {
+			ChunkGenerationPriority priority;
+			uint64_t sequence;	// FIFO order inside the same priority
+			Vec2i position;
+
+			bool operator<(const QueuedRequest &other) const
+			{
+				// std::priority_queue pops the largest element
+				if(priority != other.priority) return priority > other.priority;
+				return sequence > other.sequence;
+			}
+		};
+		enum class RequestState : uint8_t { Queued, Generating, Finished };
+		struct PendingRequest {
+			RequestState state;
+			ChunkGenerationPriority priority;
+		};
+
+		static uint64_t Key(const Vec2i &chunkPos);
+
+		void StartWorkers();
+		void WorkerLoop();
+
+		ChunkMatrix *matrix;
+		unsigned int workerCount;
+
+		mutable std::mutex mutex;
+		std::condition_variable wakeUp;
+		std::condition_variable requestDone;
+		bool stopping = false;
+
+		std::priority_queue<QueuedRequest> queue;
+		std::unordered_map<uint64_t, PendingRequest> pending;
+		std::vector<Chunk*> finished;
+		uint64_t nextSequence = 0;
+
+		std::vector<std::thread> workers;
+	};
+}
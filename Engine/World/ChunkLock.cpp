@@ -0,0 +1,80 @@
+#include "World/ChunkLock.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+#include "World/Chunk.h"
+
+using namespace Volume;
+
+ChunkLockGuard::ChunkLockGuard(ChunkLockGuard &&other) noexcept
+    : entries(std::move(other.entries)), locked(other.locked)
+{
+    other.entries.clear();
+    other.locked = false;
+}
+
+ChunkLockGuard &ChunkLockGuard::operator=(ChunkLockGuard &&other) noexcept
+{
+    if(this == &other) return *this;
+
+    this->Unlock();
+    this->entries = std::move(other.entries);
+    this->locked = other.locked;
+    other.entries.clear();
+    other.locked = false;
+    return *this;
+}
+
+void ChunkLockGuard::AddExclusive(Chunk *chunk)
+{
+    if(this->locked) throw std::runtime_error("Cannot add chunks to a locked ChunkLockGuard");
+    this->entries.push_back({ chunk, true });
+}
+
+void ChunkLockGuard::AddShared(Chunk *chunk)
+{
+    if(this->locked) throw std::runtime_error("Cannot add chunks to a locked ChunkLockGuard");
+    this->entries.push_back({ chunk, false });
+}
+
+void ChunkLockGuard::Lock()
+{
+    if(this->locked) return;
+
+    // every guard locks in the same order, loaded chunks never share a position
+    std::sort(this->entries.begin(), this->entries.end(), [](const Entry &a, const Entry &b) {
+        Vec2i posA = a.chunk->GetPos(), posB = b.chunk->GetPos();
+        return posA.y != posB.y ? posA.y < posB.y : posA.x < posB.x;
+    });
+
+    // a chunk added twice is locked once, exclusive if any of them was
+    size_t unique = 0;
+    for(size_t i = 0; i < this->entries.size(); ++i){
+        if(unique > 0 && this->entries[unique - 1].chunk == this->entries[i].chunk){
+            this->entries[unique - 1].exclusive |= this->entries[i].exclusive;
+            continue;
+        }
+        this->entries[unique++] = this->entries[i];
+    }
+    this->entries.resize(unique);
+
+    for(const Entry &entry : this->entries){
+        if(entry.exclusive) entry.chunk->voxelLock.lock();
+        else entry.chunk->voxelLock.lock_shared();
+    }
+    this->locked = true;
+}
+
+void ChunkLockGuard::Unlock()
+{
+    if(!this->locked) return;
+
+    for(auto it = this->entries.rbegin(); it != this->entries.rend(); ++it){
+        if(it->exclusive) it->chunk->voxelLock.unlock();
+        else it->chunk->voxelLock.unlock_shared();
+    }
+    this->entries.clear();
+    this->locked = false;
+}
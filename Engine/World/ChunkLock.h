@@ -0,0 +1,42 @@
+#pragma once
+
+#include <vector>
+
+namespace Volume
+{
+	class Chunk;
+
+	/// @brief Locks of a set of chunks, taken in one go in chunk position order, so two guards
+	/// never deadlock each other
+	/// @warning Only lock chunks while holding `ChunkMatrix::voxelMutex` shared, and never hold two
+	/// guards on the same thread. The exclusive voxel mutex already excludes every chunk lock
+	class ChunkLockGuard{
+	public:
+		ChunkLockGuard() = default;
+		~ChunkLockGuard() { Unlock(); }
+
+		ChunkLockGuard(ChunkLockGuard &&other) noexcept;
+		ChunkLockGuard& operator=(ChunkLockGuard &&other) noexcept;
+		// disable copy
+		ChunkLockGuard(const ChunkLockGuard&) = delete;
+		ChunkLockGuard& operator=(const ChunkLockGuard&) = delete;
+
+		/// @brief Anything reading or writing the voxels of the chunk
+		void AddExclusive(Chunk *chunk);
+		/// @brief Voxel simulation tasks reaching into a neighbour, the task graph already keeps them
+		/// apart from each other, the lock only keeps everyone else out
+		void AddShared(Chunk *chunk);
+
+		void Lock();
+		void Unlock();
+		bool IsLocked() const { return locked; }
+	private:
+		struct Entry{
+			Chunk *chunk;
+			bool exclusive;
+		};
+
+		std::vector<Entry> entries;
+		bool locked = false;
+	};
+}
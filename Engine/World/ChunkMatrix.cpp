@@ -1,13 +1,34 @@
 #include "World/ChunkMatrix.h"
 #include "GameEngine.h"
+#include "Debug/Stats.h"
 #include "World/Particles/SolidFallingParticle.h"
 #include "ChunkMatrix.h"
 
+#include <algorithm>
+#include <cmath>
+
 using namespace Volume;
+
+namespace {
+    std::atomic<uint32_t> nextMatrixInstanceID = 1;
+
+    /// @brief Last chunk looked up by this thread, voxels mostly look at neighbours in the same chunk
+    struct LastChunkCache {
+        uint32_t matrixID = 0;
+        uint32_t generation = 0;
+        int x = 0, y = 0;
+        Volume::Chunk *chunk = nullptr;
+    };
+    thread_local LastChunkCache lastChunkCache;
+}
+
 ChunkMatrix::ChunkMatrix()
+    : instanceID(nextMatrixInstanceID.fetch_add(1, std::memory_order_relaxed))
 {
     this->particleGenerators.reserve(15);
     this->particles.reserve(200);
+    Random seedSource;
+    this->simulationSeed = (static_cast<uint64_t>(seedSource.GetUInt()) << 32) | seedSource.GetUInt();
 
     this->ChunkGeneratorFunction = [](const Vec2i& pos, ChunkMatrix& chunkMatrix) -> Volume::Chunk* {
         throw std::runtime_error("ChunkGenerator function for chunkMatrix not set!");
@@ -35,15 +56,28 @@ void ChunkMatrix::cleanup()
     if(cleaned) return;
     cleaned = true;
 
+    // workers read the generator function and the matrix, stop them before anything is freed
+    generationPool.Stop();
+
     for(uint8_t i = 0; i < 4; ++i)
     {
         GridSegmented[i].clear();
     }
+    chunkDirectory.Clear();
+    directoryGeneration.fetch_add(1, std::memory_order_release);
     for(int16_t i = Grid.size() - 1; i >= 0; --i)
     {
+        if(chunkStore) chunkStore->Save(*Grid[i]);
         delete Grid[i];
     }
     Grid.clear();
+
+    for(auto &[tick, chunk] : retiredChunks)
+        delete chunk;
+    retiredChunks.clear();
+
+    // waits for the writer to finish
+    chunkStore.reset();
     
     for (auto& particle : particles) {
     	delete particle;
@@ -93,47 +127,57 @@ void ChunkMatrix::AddParticle(Particle::VoxelParticle *particle)
 
 Volume::Chunk *ChunkMatrix::GetChunkAtWorldPosition(const Vec2f &pos)
 {
-    Vec2i chunkPos = WorldToChunkPosition(pos);
-	if (!IsValidChunkPosition(chunkPos)) return nullptr;
-
-    uint8_t AssignedGridPass = 0;
-    if (chunkPos.x % 2 != 0) AssignedGridPass += 1;
-    if (chunkPos.y % 2 != 0) AssignedGridPass += 2;
-
-    for (size_t i = 0; i < this->GridSegmented[AssignedGridPass].size(); i++)
-    {
-        if(this->GridSegmented[AssignedGridPass][i]->GetPos() == chunkPos)
-        {
-            return this->GridSegmented[AssignedGridPass][i];
-        }
-    }
-
-	return nullptr;
+    return GetChunkAtChunkPosition(WorldToChunkPosition(pos));
 }
 
 Volume::Chunk *ChunkMatrix::GetChunkAtChunkPosition(const Vec2i &pos)
 {
+    LastChunkCache &cache = lastChunkCache;
+    const uint32_t generation = this->directoryGeneration.load(std::memory_order_acquire);
+
+    if(cache.x == pos.x && cache.y == pos.y && cache.matrixID == this->instanceID && cache.generation == generation)
+        return cache.chunk;
+
     if (!IsValidChunkPosition(pos)) return nullptr;
 
-    uint8_t AssignedGridPass = 0;
-    if (pos.x % 2 != 0) AssignedGridPass += 1;
-    if (pos.y % 2 != 0) AssignedGridPass += 2;
+    Volume::Chunk *chunk = this->chunkDirectory.Find(pos);
+    if(chunk){
+        cache.matrixID = this->instanceID;
+        cache.generation = generation;
+        cache.x = pos.x;
+        cache.y = pos.y;
+        cache.chunk = chunk;
+    }
 
+    return chunk;
+}
 
-    for (size_t i = 0; i < this->GridSegmented[AssignedGridPass].size(); i++)
-    {
-        if(this->GridSegmented[AssignedGridPass][i]->GetPos() == pos)
-        {
-            return this->GridSegmented[AssignedGridPass][i];
+Volume::ChunkLockGuard ChunkMatrix::LockChunksInArea(const AABB &area)
+{
+    Vec2i start = WorldToChunkPosition(area.corner);
+    Vec2i end = WorldToChunkPosition(area.corner + area.size);
+
+    Volume::ChunkLockGuard guard;
+    for(int y = start.y; y <= end.y; ++y){
+        for(int x = start.x; x <= end.x; ++x){
+            // chunks only get inserted under the exclusive voxel mutex, missing ones stay missing
+            if(Chunk *chunk = this->GetChunkAtChunkPosition(Vec2i(x, y)))
+                guard.AddExclusive(chunk);
         }
     }
+    guard.Lock();
+    return guard;
+}
 
-    return nullptr;
+Volume::ChunkLockGuard ChunkMatrix::LockChunksAround(const Vec2i &pos, int radius)
+{
+    const float reach = static_cast<float>(radius + EDIT_LOCK_MARGIN);
+    return this->LockChunksInArea(AABB(pos.x - reach, pos.y - reach, reach * 2 + 1, reach * 2 + 1));
 }
 
 /// @brief Places multiple voxels at the mouse position in a square shape
 /// @param pos 
-/// @param id 
+/// @param id string id of the material, resolved once for the whole square
 /// @param offset 
 /// @param temp 
 /// @param unmovable 
@@ -148,12 +192,13 @@ std::vector<Volume::VoxelElement*> ChunkMatrix::PlaceVoxelsAtMousePosition(const
     if(!IsValidWorldPosition(MouseWorldPos)) return {};
 
     std::vector<Volume::VoxelElement*> placedVoxels(size * size * 4 + 1);
+    Volume::MaterialID materialID = Registry::VoxelRegistry::GetMaterialID(id);
 
     for (int x = -size; x <= size; x++)
     {
         for (int y = -size; y <= size; y++)
         {
-            placedVoxels.push_back(PlaceVoxelAt(MouseWorldPosI + Vec2i(x, y), id, temp, unmovable, amount, false));
+            placedVoxels.push_back(PlaceVoxelAt(MouseWorldPosI + Vec2i(x, y), materialID, temp, unmovable, amount, false));
         }
     }
     return placedVoxels;
@@ -171,44 +216,145 @@ void ChunkMatrix::ExplodeAtMousePosition(const Vec2f &pos, short int radius, Vec
 
 /// @brief Loads and generates a chunk at the specified chunk position and adds it to the world
 /// @param chunkPos position in chunk coordinates
-/// @return pointer to the loaded chunk or nullptr if failed
+/// @return pointer to the chunk at the position (already loaded or just generated), nullptr if the position is invalid
 Volume::Chunk* ChunkMatrix::GenerateChunk(const Vec2i &chunkPos)
 {
     if(!this->IsValidChunkPosition(chunkPos)) return nullptr;
-    if(this->GetChunkAtChunkPosition(chunkPos)) return nullptr;
+    if(Volume::Chunk* existing = this->GetChunkAtChunkPosition(chunkPos)) return existing;
 
     this->chunkCreationMutex.lock();
     if(this->ChunkGeneratorFunction == nullptr) {
         this->chunkCreationMutex.unlock();
         throw std::runtime_error("ChunkGenerator function for chunkMatrix not set!");
     }
+    // another thread may have generated it while we were waiting for the lock
+    if(Volume::Chunk* existing = this->chunkDirectory.Find(chunkPos)) {
+        this->chunkCreationMutex.unlock();
+        return existing;
+    }
+
+    Volume::Chunk* chunk = this->LoadOrGenerateChunk(chunkPos);
+
+    this->InsertChunk(chunk);
+
+    this->chunkCreationMutex.unlock();
+
+    return chunk;
+}
+
+/// @brief Creates the chunk from the chunk store or, if it was never stored, the generator function
+/// @note Does not insert the chunk into the matrix. Called by the generation workers
+Volume::Chunk* ChunkMatrix::LoadOrGenerateChunk(const Vec2i &chunkPos)
+{
+    // voxels created by the generator (or the store) roll the same numbers on any thread
+    Volume::voxelRandomGenerator.SetSeed(Random::Mix(this->simulationSeed, (static_cast<uint64_t>(static_cast<uint32_t>(chunkPos.x)) << 32) | static_cast<uint32_t>(chunkPos.y)));
+
+    Volume::Chunk *chunk = nullptr;
+    if(this->chunkStore){
+        chunk = this->chunkStore->Load(chunkPos);
+        if(chunk) chunk->loadedFromStore = true;
+    }
+
+    if(!chunk)
+        chunk = this->ChunkGeneratorFunction(chunkPos, *this);
+
+    chunk->SyncVoxelStorage();
+    return chunk;
+}
+
+/// @brief Queues a chunk for generation on the background workers
+/// @return false if the chunk is already loaded, queued or the position is invalid
+/// @note The chunk shows up in the matrix after the next `CommitGeneratedChunks`
+bool ChunkMatrix::RequestChunk(const Vec2i &chunkPos, Volume::ChunkGenerationPriority priority)
+{
+    if(!this->IsValidChunkPosition(chunkPos)) return false;
+    if(this->GetChunkAtChunkPosition(chunkPos)) return false;
+
+    return this->generationPool.Request(chunkPos, priority);
+}
+
+/// @brief Inserts chunks finished by the background workers into the matrix
+/// @param maxChunks upper limit of chunks inserted in one call, spreads collider generation over multiple frames
+/// @return number of inserted chunks
+/// @warning do not call without locking the voxel mutex exclusively
+size_t ChunkMatrix::CommitGeneratedChunks(size_t maxChunks)
+{
+    // deterministic worlds must not depend on how fast the workers are
+    if(this->deterministic){
+        this->generationPool.WaitUntilIdle();
+        maxChunks = SIZE_MAX;
+    }
+
+    std::vector<Volume::Chunk*> generated = this->generationPool.TakeFinished(maxChunks);
+    if(this->deterministic){
+        std::sort(generated.begin(), generated.end(), [](const Volume::Chunk *a, const Volume::Chunk *b) {
+            Vec2i posA = a->GetPos(), posB = b->GetPos();
+            return posA.x != posB.x ? posA.x < posB.x : posA.y < posB.y;
+        });
+    }
+    size_t committed = 0;
+
+    for(Volume::Chunk *chunk : generated){
+        Vec2i chunkPos = chunk->GetPos();
+
+        this->chunkCreationMutex.lock();
+        // GenerateChunk may have created it synchronously in the meantime
+        if(this->chunkDirectory.Find(chunkPos)){
+            delete chunk;
+        }else{
+            this->InsertChunk(chunk);
+            committed++;
+        }
+        this->chunkCreationMutex.unlock();
 
-    Volume::Chunk* chunk = this->ChunkGeneratorFunction(chunkPos, *this);
+        this->generationPool.Release(chunkPos);
+    }
+    return committed;
+}
+
+/// @brief Makes a generated chunk part of the matrix
+/// @warning do not call without locking the chunk creation mutex
+void ChunkMatrix::InsertChunk(Volume::Chunk *chunk)
+{
+    Vec2i chunkPos = chunk->GetPos();
 
     if(this->chunkShaderManager)
         chunk->bufferTicket = this->chunkShaderManager->GenerateChunkTicket();
 
     chunk->lastCheckedCountDown = 20;
 
+    // counted here, chunks generated twice get dropped before they are inserted
+    Debug::Stats::Add(chunk->loadedFromStore ? Debug::StatCounter::ChunksLoaded : Debug::StatCounter::ChunksGenerated);
+
     uint8_t AssignedGridPass = 0;
     if (chunkPos.x % 2 != 0) AssignedGridPass += 1;
     if (chunkPos.y % 2 != 0) AssignedGridPass += 2;
 
     this->GridSegmented[AssignedGridPass].push_back(chunk);
     this->Grid.push_back(chunk);
+    this->chunkDirectory.Insert(chunkPos, chunk);
+    this->LinkChunkNeighbors(chunk);
     this->newUninitializedChunks.push(chunk);
 
     // Set chunks colliders
     GameEngine::physics->Generate2DCollidersForChunk(chunk);
-
-    this->chunkCreationMutex.unlock();
-
-    return chunk;
 }
 
 void ChunkMatrix::DeleteChunk(const Vec2i &pos)
 {
     this->chunkCreationMutex.lock();
+
+    // invalidate every thread's last-chunk cache before the chunk is freed
+    if(Chunk *removedChunk = this->chunkDirectory.Find(pos)){
+        // keep whatever happened to the chunk instead of regenerating it later. Queued before the
+        // chunk leaves the directory, so a new request for it always sees this copy
+        if(this->chunkStore)
+            this->chunkStore->Save(*removedChunk);
+        this->UnlinkChunkNeighbors(removedChunk);
+    }
+    this->chunkDirectory.Remove(pos);
+    this->directoryGeneration.fetch_add(1, std::memory_order_release);
+
     uint8_t AssignedGridPass = 0;
     if (pos.x % 2 != 0) AssignedGridPass += 1;
     if (pos.y % 2 != 0) AssignedGridPass += 2;
@@ -232,7 +378,10 @@ void ChunkMatrix::DeleteChunk(const Vec2i &pos)
                 this->chunkShaderManager->DiscardChunkTicket(c->bufferTicket);
 
             this->Grid.erase(this->Grid.begin() + i);
-            delete c;
+            // the renderer draws from snapshots without the voxel mutex, they may still hold the chunk
+            if(GameEngine::renderer) this->retiredChunks.emplace_back(this->simulationTick, c);
+            else delete c;
+            Debug::Stats::Add(Debug::StatCounter::ChunksDeleted);
             
             this->chunkCreationMutex.unlock();
             return;
@@ -241,6 +390,107 @@ void ChunkMatrix::DeleteChunk(const Vec2i &pos)
     this->chunkCreationMutex.unlock();
 }
 
+void ChunkMatrix::FreeRetiredChunks(uint64_t renderedTick)
+{
+    std::lock_guard<Debug::TracedMutex> lock(this->chunkCreationMutex);
+
+    // snapshots are published after the tick counter moved past the deletion
+    std::erase_if(this->retiredChunks, [renderedTick](const std::pair<uint64_t, Chunk*> &retired) {
+        if(retired.first >= renderedTick) return false;
+        delete retired.second;
+        return true;
+    });
+}
+
+/// @brief Reseeds `Volume::voxelRandomGenerator` of the calling thread for this tick
+/// @param stream chunk position key (see `Volume::Chunk::UpdateVoxels`) or one of the `*_RANDOM_STREAM` constants
+void ChunkMatrix::SeedVoxelRandom(uint64_t stream) const
+{
+    Volume::voxelRandomGenerator.SetSeed(Random::Mix(Random::Mix(this->simulationSeed, this->simulationTick), stream));
+}
+
+/// @param seed seed of every random stream used by the simulation
+/// @note Simulation results only repeat if the ticks, GPU simulations and chunk loads are driven in the same order
+/// @warning call before the simulation starts
+void ChunkMatrix::EnableDeterministicSimulation(uint64_t seed)
+{
+    this->deterministic = true;
+    this->simulationSeed = seed;
+}
+
+uint64_t ChunkMatrix::ComputeWorldChecksum() const
+{
+    std::vector<std::pair<uint64_t, uint64_t>> chunkChecksums(this->Grid.size());
+
+    #pragma omp parallel for
+    for(size_t i = 0; i < this->Grid.size(); ++i){
+        TRACE_SCOPE("Chunk checksum");
+        Vec2i pos = this->Grid[i]->GetPos();
+        uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(pos.x)) << 32) | static_cast<uint32_t>(pos.y);
+        chunkChecksums[i] = { key, this->Grid[i]->ComputeChecksum() };
+    }
+
+    // Grid order depends on when chunks were loaded, the checksum must not
+    std::sort(chunkChecksums.begin(), chunkChecksums.end());
+
+    uint64_t checksum = chunkChecksums.size();
+    for(const auto &[key, chunkChecksum] : chunkChecksums)
+        checksum = Random::Mix(checksum, chunkChecksum);
+    return checksum;
+}
+
+/// @brief Enables saving evicted chunks to disk and loading them back instead of regenerating them
+/// @param directory save directory of this world, created if missing
+/// @warning call before any chunk gets generated
+void ChunkMatrix::EnableChunkStore(const std::filesystem::path &directory)
+{
+    if(this->chunkStore){
+        Debug::LogWarn("Chunk store already enabled (" + this->chunkStore->GetDirectory().string() + ")");
+        return;
+    }
+    this->chunkStore = std::make_unique<Volume::ChunkStore>(directory);
+}
+
+/// @brief Writes every loaded chunk to the chunk store and waits until they are on disk
+/// @return number of saved chunks, 0 if the chunk store is not enabled
+/// @warning the voxel mutex must be held exclusively, the saved chunks have to be from the same moment
+size_t ChunkMatrix::SaveWorld()
+{
+    if(!this->chunkStore) return 0;
+
+    for(Volume::Chunk *chunk : this->Grid)
+        this->chunkStore->Save(*chunk);
+    this->chunkStore->Flush();
+
+    return this->Grid.size();
+}
+
+/// @brief Connects the chunk with all 8 of its loaded neighbours (both ways)
+void ChunkMatrix::LinkChunkNeighbors(Volume::Chunk *chunk)
+{
+    for(uint8_t i = 0; i < static_cast<uint8_t>(ChunkNeighbor::Count); ++i){
+        ChunkNeighbor direction = static_cast<ChunkNeighbor>(i);
+        Chunk *neighbor = this->chunkDirectory.Find(chunk->GetPos() + Chunk::NEIGHBOR_OFFSETS[i]);
+
+        chunk->SetNeighbor(direction, neighbor);
+        if(neighbor)
+            neighbor->SetNeighbor(Chunk::OppositeNeighbor(direction), chunk);
+    }
+}
+
+/// @brief Removes all links pointing to the chunk from its neighbours
+void ChunkMatrix::UnlinkChunkNeighbors(Volume::Chunk *chunk)
+{
+    for(uint8_t i = 0; i < static_cast<uint8_t>(ChunkNeighbor::Count); ++i){
+        ChunkNeighbor direction = static_cast<ChunkNeighbor>(i);
+        Chunk *neighbor = chunk->GetNeighbor(direction);
+
+        if(neighbor)
+            neighbor->SetNeighbor(Chunk::OppositeNeighbor(direction), nullptr);
+        chunk->SetNeighbor(direction, nullptr);
+    }
+}
+
 Volume::VoxelElement* ChunkMatrix::VirtualGetAt(const Vec2i &pos, bool includeObjects)
 {
     Vec2i chunkPos = WorldToChunkPosition(Vec2f(pos));
@@ -249,12 +499,13 @@ Volume::VoxelElement* ChunkMatrix::VirtualGetAt(const Vec2i &pos, bool includeOb
 
     Chunk *chunk = GetChunkAtChunkPosition(chunkPos);
     if(!chunk){
-        if(!GameEngine::instance->automaticLoadingOfChunksFromEvents)
-            return nullptr;
-            
-        chunk = GenerateChunk(chunkPos);
+        // not loaded yet, the workers generate it in the background
+        if(GameEngine::instance->automaticLoadingOfChunksFromEvents)
+            RequestChunk(chunkPos, ChunkGenerationPriority::Event);
+        return nullptr;
     }
 
+    chunk->EnsureExpanded();
     Volume::VoxelElement *voxel = chunk->voxels[abs(pos.y % Chunk::CHUNK_SIZE)][abs(pos.x % Chunk::CHUNK_SIZE)];
 
     if(includeObjects && (!voxel || voxel->GetState() != State::Solid)){
@@ -288,6 +539,7 @@ Volume::VoxelElement* ChunkMatrix::VirtualGetAt_NoLoad(const Vec2i &pos, bool in
         return nullptr;
     }
 
+    chunk->EnsureExpanded();
     Volume::VoxelElement *voxel = chunk->voxels[abs(pos.y % Chunk::CHUNK_SIZE)][abs(pos.x % Chunk::CHUNK_SIZE)];
 
     if(includeObjects && (!voxel || voxel->GetState() != State::Solid)){
@@ -317,6 +569,7 @@ void ChunkMatrix::VirtualSetAt(Volume::VoxelElement *voxel, bool includeObjects)
 
     // Check if chunkPos is within bounds of the Grid
     if (!IsValidWorldPosition(voxel->position)) {
+        delete voxel;
         return;
     }
 
@@ -344,11 +597,15 @@ void ChunkMatrix::VirtualSetAt(Volume::VoxelElement *voxel, bool includeObjects)
     Chunk *chunk = GetChunkAtChunkPosition(chunkPos);
 
     if (!chunk) {
-        if(!GameEngine::instance->automaticLoadingOfChunksFromEvents)
-            return;
-        chunk = GenerateChunk(chunkPos);
+        // the write is dropped, the voxel is owned by the matrix from here on
+        if(GameEngine::instance->automaticLoadingOfChunksFromEvents)
+            RequestChunk(chunkPos, ChunkGenerationPriority::Event);
+        delete voxel;
+        return;
     }
 
+    chunk->EnsureExpanded();
+
     // update physics if changing a solid voxel
     if(voxel->ShouldTriggerDirtyColliders() || chunk->voxels[localPos.y][localPos.x]->ShouldTriggerDirtyColliders())
         chunk->dirtyColliders = true;
@@ -359,20 +616,21 @@ void ChunkMatrix::VirtualSetAt(Volume::VoxelElement *voxel, bool includeObjects)
     }
 
     // Set the new voxel and mark for update
-    voxel->partOfObject = false;
+    voxel->SetPartOfObject(false);
     chunk->voxels[localPos.y][localPos.x] = voxel;
 
-    chunk->dirtyRect.Include(localPos);
+    chunk->dirtyTiles.Include(localPos);
     chunk->UpdatedVoxelAt(localPos);
 }
 // Same as VirtualSetAt but does not delete the old voxel
-void ChunkMatrix::VirtualSetAt_NoDelete(Volume::VoxelElement *voxel, bool includeObjects)
+// Returns false if the voxel was not placed (invalid position or chunk not loaded), the caller still owns it
+bool ChunkMatrix::VirtualSetAt_NoDelete(Volume::VoxelElement *voxel, bool includeObjects)
 {
-    if (!voxel) return; // Check for null pointer
+    if (!voxel) return false; // Check for null pointer
 
     // Check if chunkPos is within bounds of the Grid
     if (!IsValidWorldPosition(voxel->position)) {
-        return;
+        return false;
     }
 
     // Calculate positions in the chunk and local position
@@ -389,7 +647,7 @@ void ChunkMatrix::VirtualSetAt_NoDelete(Volume::VoxelElement *voxel, bool includ
             {
                 // If the voxel is part of a VoxelObject, set it there
                 if(obj->SetVoxelAt(voxel->position, voxel, true))
-                    return;
+                    return true;
             }
         }
     }
@@ -397,30 +655,28 @@ void ChunkMatrix::VirtualSetAt_NoDelete(Volume::VoxelElement *voxel, bool includ
     Chunk *chunk = GetChunkAtChunkPosition(chunkPos);
 
     if (!chunk) {
-        if(!GameEngine::instance->automaticLoadingOfChunksFromEvents)
-            return;
-        chunk = GenerateChunk(chunkPos);
+        if(GameEngine::instance->automaticLoadingOfChunksFromEvents)
+            RequestChunk(chunkPos, ChunkGenerationPriority::Event);
+        return false;
     }
 
+    chunk->EnsureExpanded();
+
     // update physics if changing a solid voxel
     if(voxel->ShouldTriggerDirtyColliders() || chunk->voxels[localPos.y][localPos.x]->ShouldTriggerDirtyColliders())
         chunk->dirtyColliders = true;
 
     // Set the new voxel and mark for update
-    voxel->partOfObject = false;
+    voxel->SetPartOfObject(false);
     chunk->voxels[localPos.y][localPos.x] = voxel;
 
-    chunk->dirtyRect.Include(localPos);
+    chunk->dirtyTiles.Include(localPos);
     chunk->UpdatedVoxelAt(localPos);
-}
 
-Volume::VoxelElement* ChunkMatrix::PlaceVoxelAt(const Vec2i &pos, std::string id, Temperature temp, 
-    bool placeUnmovableSolids, float amount, bool destructive, bool includeObjects)
-{
-    Volume::VoxelElement *voxel = CreateVoxelElement(id, pos, amount, temp, placeUnmovableSolids);
-    return PlaceVoxelAt(voxel, destructive, includeObjects);
+    return true;
 }
-Volume::VoxelElement* ChunkMatrix::PlaceVoxelAt(const Vec2i &pos, uint32_t id, Volume::Temperature temp, bool placeUnmovableSolids, float amount, bool destructive, bool includeObjects)
+
+Volume::VoxelElement* ChunkMatrix::PlaceVoxelAt(const Vec2i &pos, Volume::MaterialID id, Volume::Temperature temp, bool placeUnmovableSolids, float amount, bool destructive, bool includeObjects)
 {
     Volume::VoxelElement *voxel = CreateVoxelElement(id, pos, amount, temp, placeUnmovableSolids);
     return PlaceVoxelAt(voxel, destructive, includeObjects);
@@ -429,6 +685,14 @@ Volume::VoxelElement* ChunkMatrix::PlaceVoxelAt(Volume::VoxelElement *voxel, boo
 {
     if(!voxel) return nullptr; // Check for null pointer
 
+    // chunk not loaded yet, VirtualSetAt would drop the voxel
+    if(!includeObjects && !this->GetChunkAtWorldPosition(Vec2f(voxel->position))){
+        if(GameEngine::instance->automaticLoadingOfChunksFromEvents && this->IsValidWorldPosition(voxel->position))
+            RequestChunk(WorldToChunkPosition(Vec2f(voxel->position)), ChunkGenerationPriority::Event);
+        delete voxel;
+        return nullptr;
+    }
+
     if(!destructive){
         Volume::VoxelElement* replacedVoxel = this->VirtualGetAt(voxel->position, includeObjects);
 
@@ -510,13 +774,13 @@ void ChunkMatrix::SetFireAt(const Vec2i &pos, std::optional<Volume::Temperature>
     VoxelElement *ingitedVoxel = this->VirtualGetAt(pos);
     if(!ingitedVoxel) return;
 
-    std::string fireId;
+    MaterialID fireId;
     if(ingitedVoxel->GetState() == State::Solid)
-        fireId = "Fire_Solid";
+        fireId = Materials::FireSolid;
     else if(ingitedVoxel->GetState() == State::Liquid)
-        fireId = "Fire_Liquid";
+        fireId = Materials::FireLiquid;
     else
-        fireId = "Fire";
+        fireId = Materials::Fire;
     
     if(temp == std::nullopt){
         temp = ingitedVoxel->temperature;
@@ -528,7 +792,7 @@ void ChunkMatrix::SetFireAt(const Vec2i &pos, std::optional<Volume::Temperature>
     bool placeAsUnmovableSolid = ingitedVoxel->IsUnmoveableSolid();
     if(placeAsUnmovableSolid){
         // 15% chance of fire becoming movable
-        if(this->randomGenerator.GetInt(0, 100) < 15){
+        if(Volume::voxelRandomGenerator.GetInt(0, 100) < 15){
             placeAsUnmovableSolid = false;
         }
     }
@@ -538,10 +802,10 @@ void ChunkMatrix::SetFireAt(const Vec2i &pos, std::optional<Volume::Temperature>
     this->PlaceVoxelAt(fireVoxel, true);
 }
 
-bool ChunkMatrix::TryToDisplaceGas(const Vec2i &pos, std::string id, Volume::Temperature temp, float amount, bool placeUnmovableSolids)
+bool ChunkMatrix::TryToDisplaceGas(const Vec2i &pos, Volume::MaterialID id, Volume::Temperature temp, float amount, bool placeUnmovableSolids)
 {
     Volume::VoxelElement *displacedGas = this->VirtualGetAt(pos);
-    if(!displacedGas || displacedGas->GetState() != State::Gas || displacedGas->id == "Empty") return false;
+    if(!displacedGas || displacedGas->GetState() != State::Gas || displacedGas->id == Materials::Empty) return false;
 
     Volume::VoxelElement *voxel = CreateVoxelElement(id, pos, amount, temp, placeUnmovableSolids);
 
@@ -613,17 +877,17 @@ void ChunkMatrix::ExplodeAt(const Vec2i &pos, short int radius)
     		if (voxel == nullptr) continue;
 
     		if (j < radius * 0.2f) {
-                PlaceVoxelAt(currentPos, "Fire", Temperature(std::min(300, radius * 70)), false, 5.0f, true, true);
+                PlaceVoxelAt(currentPos, Materials::Fire, Temperature(std::min(300, radius * 70)), false, 5.0f, true, true);
             }
             else if(j <= radius) {
                 //destroy gas and immovable solids.. create particles for other
-    			if (voxel->GetState() == State::Gas || voxel->IsUnmoveableSolid() || voxel->partOfObject) 
+    			if (voxel->GetState() == State::Gas || voxel->IsUnmoveableSolid() || voxel->IsPartOfObject()) 
                 {
-                    PlaceVoxelAt(currentPos, "Fire", Temperature(radius * 100), false, 1.3f, true, true);
+                    PlaceVoxelAt(currentPos, Materials::Fire, Temperature(radius * 100), false, 1.3f, true, true);
                 }
                 else {
                     // +- 0.05 degrees radian
-                    double smallAngleDeviation = this->randomGenerator.GetFloat(-0.05f, 0.05f);
+                    double smallAngleDeviation = Volume::voxelRandomGenerator.GetFloat(-0.05f, 0.05f);
                     
                     voxel->position = Vec2f(currentPos);
                     Particle::SolidFallingParticle* particle = new Particle::SolidFallingParticle(
@@ -634,10 +898,11 @@ void ChunkMatrix::ExplodeAt(const Vec2i &pos, short int radius)
                     particle->precision = false;
                     this->AddParticle(particle);
 
-                    VoxelElement *fireVoxel = CreateVoxelElement("Fire", currentPos, 1.3f, Temperature(radius * 100), false);
+                    VoxelElement *fireVoxel = CreateVoxelElement(Materials::Fire, currentPos, 1.3f, Temperature(radius * 100), false);
                     
                     // false, because all voxels in voxelobjects should be unmovable, thus no condition should result in getting here
-                    VirtualSetAt_NoDelete(fireVoxel, false); 
+                    if(!VirtualSetAt_NoDelete(fireVoxel, false))
+                        delete fireVoxel;
                 }
             }else{
                 // blacken out voxels around explosion
@@ -2,10 +2,17 @@
 
 #include <GL/glew.h>
 
+#include <filesystem>
 #include <list>
+#include <memory>
 #include <queue>
 
+#include "Debug/TraceRecorder.h"
 #include "World/Chunk.h"
+#include "World/ChunkDirectory.h"
+#include "World/ChunkGenerationPool.h"
+#include "World/ChunkLock.h"
+#include "World/ChunkStore.h"
 #include "Shader/ChunkShader.h"
 #include "VoxelObject/PhysicsObject.h"
 
@@ -25,12 +32,15 @@ public:
 	// cleans the chunkMatrix
 	void cleanup();
 
-	// mutex for changing voxels
-	std::mutex voxelMutex;
+	// Exclusive: changing the chunk set or voxel objects. Particles and colliders (Box2D) need it on any thread but the main thread.
+	// Shared: voxel access through chunk locks (`LockChunksInArea`), the voxel pass of the simulation.
+	// The main thread (input, physics) also adds particles and touches Box2D under a shared lock. That is only safe
+	// because the voxel pass never does either, and everything else that does runs under the exclusive lock
+	Debug::TracedSharedMutex voxelMutex{"Wait voxelMutex", Debug::StatCounter::WorldLockWaits, Debug::StatCounter::WorldLockWaitMicros};
 
 	// mutex for creating/deleting chunks
-	std::mutex chunkCreationMutex;
-	//not precomputed array of chunks
+	Debug::TracedMutex chunkCreationMutex{"Wait chunkCreationMutex"};
+	//not precomputed array of chunks, use GetChunkAtChunkPosition for lookups
 	std::vector<Volume::Chunk*> Grid;
 	//precomputed grids for simulation passing -> 0 - 3 passees
 	std::vector<Volume::Chunk*> GridSegmented[4];
@@ -45,31 +55,54 @@ public:
 	Volume::Chunk* GetChunkAtWorldPosition(const Vec2f& pos);
 	Volume::Chunk* GetChunkAtChunkPosition(const Vec2i& pos);
 
+	/// @brief Locks every loaded chunk overlapping `area` (world voxels) exclusively
+	/// @note Chunks that are not loaded are skipped. Chunks only get committed under the exclusive
+	/// `voxelMutex`, so none can appear in `area` unlocked while the shared lock is held
+	/// @warning Hold `voxelMutex` shared while the guard lives
+	Volume::ChunkLockGuard LockChunksInArea(const AABB& area);
+	/// @brief Locks the chunks an edit of `radius` around `pos` can reach, voxels it pushes aside included
+	Volume::ChunkLockGuard LockChunksAround(const Vec2i& pos, int radius);
+	// non destructive placement pushes voxels upwards, possibly several times
+	static constexpr int EDIT_LOCK_MARGIN = Volume::Chunk::CHUNK_SIZE / 2;
+
 	std::vector<Volume::VoxelElement*> PlaceVoxelsAtMousePosition(const Vec2f &pos, std::string id, Vec2f offset, Volume::Temperature temp, bool unmovable, int size, int amount);
 	void ExplodeAtMousePosition(const Vec2f& pos, short int radius, Vec2f offset);
 
+	// may be called from chunk generation workers, must not touch the chunk matrix
 	Volume::Chunk* (*ChunkGeneratorFunction)(const Vec2i&, ChunkMatrix&) = nullptr;
 	Volume::Chunk* GenerateChunk(const Vec2i& chunkPos);
+	Volume::Chunk* LoadOrGenerateChunk(const Vec2i& chunkPos);
+	bool RequestChunk(const Vec2i& chunkPos, Volume::ChunkGenerationPriority priority);
+	size_t CommitGeneratedChunks(size_t maxChunks = MAX_COMMITTED_CHUNKS_PER_UPDATE);
+	size_t GetPendingChunkCount() const { return generationPool.GetPendingCount(); }
+	/// @brief Chunks `CommitGeneratedChunks` would insert, the engine skips the exclusive lock without any
+	size_t GetGeneratedChunkCount() const { return generationPool.GetFinishedCount(); }
+	static constexpr size_t MAX_COMMITTED_CHUNKS_PER_UPDATE = 8;
 	std::queue<Volume::Chunk*> newUninitializedChunks = {};
 	void DeleteChunk(const Vec2i& pos);
+	/// @brief Frees deleted chunks that no render snapshot of `renderedTick` or later can reference
+	/// @note Called by the engine on the main thread, after it picked the render snapshot of the frame
+	void FreeRetiredChunks(uint64_t renderedTick);
+
+	/// @brief Evicted chunks get saved to and loaded from region files in the directory
+	void EnableChunkStore(const std::filesystem::path &directory);
+	Volume::ChunkStore* GetChunkStore() const { return chunkStore.get(); }
+	size_t SaveWorld();
 
 	//Virtual setter / getter
 	//Accesses a virtual 2D array that ignores chunks
 	Volume::VoxelElement* VirtualGetAt(const Vec2i& pos, bool includeObjects = false);
 	Volume::VoxelElement* VirtualGetAt_NoLoad(const Vec2i& pos, bool includeObjects = false);
 	void VirtualSetAt(Volume::VoxelElement *voxel, bool includeObjects = false);
-	void VirtualSetAt_NoDelete(Volume::VoxelElement *voxel, bool includeObjects = false);
+	bool VirtualSetAt_NoDelete(Volume::VoxelElement *voxel, bool includeObjects = false);
 
-	Volume::VoxelElement* PlaceVoxelAt(const Vec2i &pos, std::string id, Volume::Temperature temp, 
-		bool placeUnmovableSolids, float amount, bool destructive, bool includeObjects = false);
-
-	Volume::VoxelElement* PlaceVoxelAt(const Vec2i &pos, uint32_t id, Volume::Temperature temp, 
+	Volume::VoxelElement* PlaceVoxelAt(const Vec2i &pos, Volume::MaterialID id, Volume::Temperature temp, 
 		bool placeUnmovableSolids, float amount, bool destructive, bool includeObjects = false);
 
 	Volume::VoxelElement* PlaceVoxelAt(Volume::VoxelElement *voxel, bool destructive, bool includeObjects = false);
 	void SetFireAt(const Vec2i &pos, std::optional<Volume::Temperature> temp = std::nullopt);
 	// returns true if the gas was displaced. False if no change accured
-	bool TryToDisplaceGas(const Vec2i& pos, std::string id, Volume::Temperature temp, float amount, bool placeUnmovableSolids);
+	bool TryToDisplaceGas(const Vec2i& pos, Volume::MaterialID id, Volume::Temperature temp, float amount, bool placeUnmovableSolids);
 
 	void GetVoxelsInChunkAtWorldPosition(const Vec2f& pos);
 	void GetVoxelsInCubeAtWorldPosition(const Vec2f& start, const Vec2f& end);
@@ -90,12 +123,53 @@ public:
 	static Vec2f MousePosToWorldPos(const Vec2f& mousePos, const Vec2f &cameraOffset);
 
 	bool isActive = false;
+
+	// voxel random streams are derived from the seed, the tick and the simulated chunk
+	uint64_t simulationSeed;
+	// finished voxel simulation steps
+	uint64_t simulationTick = 0;
+	void SeedVoxelRandom(uint64_t stream) const;
+	static constexpr uint64_t OBJECT_RANDOM_STREAM = 0;
+	static constexpr uint64_t PARTICLE_RANDOM_STREAM = 1;
+	static constexpr uint64_t GPU_RANDOM_STREAM = 2;
+	// world edits of the main thread: input, physics and game updates
+	static constexpr uint64_t INPUT_RANDOM_STREAM = 3;
+
+	/// @brief Fixed seed, fixed chunk order and single threaded voxel updates (`EngineConfig::deterministicSimulation`)
+	void EnableDeterministicSimulation(uint64_t seed);
+	bool IsDeterministic() const { return deterministic; }
+
+	/// @brief Order independent hash of every loaded chunk
+	/// @warning the voxel mutex must be held
+	uint64_t ComputeWorldChecksum() const;
+	// filled every tick when `EngineConfig::worldChecksums` is set
+	uint64_t worldChecksum = 0;		// world after the last tick
+	uint64_t rollingChecksum = 0;	// every tick so far
 private:
-	Random randomGenerator;
 	bool cleaned = false;
+	bool deterministic = false;
+
+	// O(1) position -> chunk lookup, kept in sync with Grid by GenerateChunk and DeleteChunk
+	Volume::ChunkDirectory chunkDirectory;
+	// bumped whenever a chunk leaves the directory, invalidates the per-thread last-chunk caches
+	std::atomic<uint32_t> directoryGeneration = 0;
+	const uint32_t instanceID;
 
 	std::vector<Particle::VoxelParticle*> newParticles;
 
+	// chunks deleted while a render snapshot may still draw them, with the tick they were deleted in.
+	// Guarded by chunkCreationMutex
+	std::vector<std::pair<uint64_t, Volume::Chunk*>> retiredChunks;
+
+	// persistent storage for evicted chunks, nullptr if chunks are simply regenerated
+	std::unique_ptr<Volume::ChunkStore> chunkStore;
+	// background chunk generation, finished chunks are inserted by CommitGeneratedChunks
+	Volume::ChunkGenerationPool generationPool{this};
+
+	void InsertChunk(Volume::Chunk *chunk);
+	void LinkChunkNeighbors(Volume::Chunk *chunk);
+	void UnlinkChunkNeighbors(Volume::Chunk *chunk);
+
 	// Chunk shader manager for handling chunk-related shaders
 	Shader::ChunkShaderManager *chunkShaderManager = nullptr;
 };
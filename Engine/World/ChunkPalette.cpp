@@ -0,0 +1,43 @@
+#include "World/ChunkPalette.h"
+
+using namespace Volume;
+
+int ChunkPalette::FindOrAdd(const ChunkPaletteEntry &entry)
+{
+    // chunks are made of long runs of the same voxel, check the newest entries first
+    for(size_t i = entries.size(); i-- > 0;){
+        if(entries[i] == entry) return static_cast<int>(i);
+    }
+
+    if(entries.size() >= MAX_ENTRIES) return -1;
+
+    entries.push_back(entry);
+    return static_cast<int>(entries.size() - 1);
+}
+
+void ChunkPalette::SetIndices(const uint8_t *rawIndices, uint16_t count)
+{
+    indices.clear();
+
+    if(entries.size() <= 1){
+        bitsPerIndex = 0;
+    }
+    else if(entries.size() <= 16){
+        bitsPerIndex = 4;
+        indices.assign((count + 1) / 2, 0);
+        for(uint16_t i = 0; i < count; ++i)
+            indices[i >> 1] |= (rawIndices[i] & 0x0F) << ((i & 1) * 4);
+    }
+    else{
+        bitsPerIndex = 8;
+        indices.assign(rawIndices, rawIndices + count);
+    }
+
+    indices.shrink_to_fit();
+    entries.shrink_to_fit();
+}
+
+size_t ChunkPalette::GetMemoryUsage() const
+{
+    return sizeof(ChunkPalette) + entries.capacity() * sizeof(ChunkPaletteEntry) + indices.capacity();
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Registry/VoxelRegistry.h"
+
+namespace Volume
+{
+	/// @brief One distinct voxel state of a compressed chunk
+	struct ChunkPaletteEntry {
+		MaterialID material;
+		float temperature;	// Celsius
+		float amount;
+		uint8_t flags;		// storage flags, see Volume::VoxelFlags
+
+		bool operator==(const ChunkPaletteEntry &other) const = default;
+	};
+
+	/// @brief Palette compressed voxels of a chunk
+	/// @note A single entry (uniform chunk) stores no indices at all, up to 16 entries use 4 bit
+	/// indices and up to 256 entries use 8 bit indices
+	class ChunkPalette {
+	public:
+		static constexpr size_t MAX_ENTRIES = 256;
+
+		/// @brief Returns the palette index of the entry, adding it if needed. -1 if the palette is full
+		int FindOrAdd(const ChunkPaletteEntry &entry);
+		/// @brief Stores the palette index of every voxel, packed as tightly as the entry count allows
+		void SetIndices(const uint8_t *rawIndices, uint16_t count);
+
+		uint8_t GetIndex(uint16_t voxelIndex) const
+		{
+			if(bitsPerIndex == 0) return 0;
+			if(bitsPerIndex == 8) return indices[voxelIndex];
+			return (indices[voxelIndex >> 1] >> ((voxelIndex & 1) * 4)) & 0x0F;
+		}
+		const ChunkPaletteEntry& Get(uint16_t voxelIndex) const { return entries[GetIndex(voxelIndex)]; }
+
+		const std::vector<ChunkPaletteEntry>& GetEntries() const { return entries; }
+		bool IsUniform() const { return entries.size() == 1; }
+
+		size_t GetMemoryUsage() const;
+	private:
+		std::vector<ChunkPaletteEntry> entries;
+		std::vector<uint8_t> indices;
+		uint8_t bitsPerIndex = 0;
+	};
+}
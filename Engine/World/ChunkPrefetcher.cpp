@@ -0,0 +1,83 @@
+#include "World/ChunkPrefetcher.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "World/ChunkMatrix.h"
+
+using namespace Volume;
+
+/// @brief Chunk positions overlapping the area, padded by half a chunk like `GameRenderer::SetCameraPosition`
+ChunkPrefetcher::ChunkRange ChunkPrefetcher::RangeOf(const AABB &area)
+{
+    constexpr float halfChunk = Chunk::CHUNK_SIZE / 2.0f;
+    return ChunkRange{
+        ChunkMatrix::WorldToChunkPosition(area.corner - Vec2f(halfChunk, halfChunk)),
+        ChunkMatrix::WorldToChunkPosition(area.corner + area.size + Vec2f(halfChunk, halfChunk))
+    };
+}
+
+void ChunkPrefetcher::Update(ChunkMatrix &matrix, const AABB &camera, Vec2f velocity, float deltaTime)
+{
+    ChunkRange visible = RangeOf(camera);
+    Vec2f center = camera.GetCenter();
+
+    // a new matrix starts with a clean slate, nothing entered the view yet
+    if(this->lastMatrix != &matrix){
+        this->lastMatrix = &matrix;
+        this->lastVisible = visible;
+        this->lastCenter = center;
+        return;
+    }
+
+    this->CountNewlyVisible(matrix, visible);
+    this->lastVisible = visible;
+
+    // noclip and scripted cameras move without a physics velocity
+    if(velocity.LengthSquared() < 1e-4f && deltaTime > 0)
+        velocity = (center - this->lastCenter) / deltaTime;
+    this->lastCenter = center;
+
+    if(!this->enabled) return;
+
+    Vec2f lookahead = velocity * (deltaTime * this->lookaheadFrames);
+    float distance = lookahead.Length();
+    if(distance < 1.0f) return;
+
+    // sweep the camera in half chunk steps so chunks closer to the camera get requested first
+    int steps = static_cast<int>(std::ceil(distance / (Chunk::CHUNK_SIZE / 2.0f)));
+    uint16_t issued = 0;
+    for(int step = 1; step <= steps && issued < MAX_REQUESTS_PER_UPDATE; ++step){
+        AABB predicted(camera.corner + lookahead * (static_cast<float>(step) / steps), camera.size);
+        ChunkRange range = RangeOf(predicted);
+
+        for(int x = range.min.x; x <= range.max.x && issued < MAX_REQUESTS_PER_UPDATE; ++x){
+            for(int y = range.min.y; y <= range.max.y && issued < MAX_REQUESTS_PER_UPDATE; ++y){
+                // visible chunks are requested by the renderer with a higher priority
+                if(visible.Contains(Vec2i(x, y))) continue;
+
+                if(matrix.RequestChunk(Vec2i(x, y), ChunkGenerationPriority::Background)){
+                    issued++;
+                    this->stats.requests++;
+                }
+            }
+        }
+    }
+}
+
+/// @brief Counts chunks that entered the view as hits (already loaded) or misses (still missing)
+void ChunkPrefetcher::CountNewlyVisible(ChunkMatrix &matrix, const ChunkRange &visible)
+{
+    for(int x = visible.min.x; x <= visible.max.x; ++x){
+        for(int y = visible.min.y; y <= visible.max.y; ++y){
+            Vec2i pos(x, y);
+            if(this->lastVisible.Contains(pos)) continue;
+            if(!matrix.IsValidChunkPosition(pos)) continue;
+
+            if(matrix.GetChunkAtChunkPosition(pos))
+                this->stats.hits++;
+            else
+                this->stats.misses++;
+        }
+    }
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Math/AABB.h"
+#include "Math/Vector.h"
+
+class ChunkMatrix;
+
+namespace Volume
+{
+	struct ChunkPrefetchStats {
+		uint64_t requests = 0;	// background generation requests issued by the prefetcher
+		uint64_t hits = 0;		// chunks that were already loaded when they entered the view
+		uint64_t misses = 0;	// chunks that still had to be generated when they entered the view
+
+		float GetHitRate() const
+		{
+			uint64_t total = hits + misses;
+			return total == 0 ? 1.0f : static_cast<float>(hits) / static_cast<float>(total);
+		}
+	};
+
+	/// @brief Requests chunks the camera is about to reach before they are visible
+	/// @note The camera rectangle is swept along the velocity for `lookaheadFrames` frames and every chunk
+	/// it passes gets a background priority request. Faster movement reaches further ahead
+	class ChunkPrefetcher {
+	public:
+		/// @param camera current camera rectangle in world coordinates
+		/// @param velocity velocity of the followed object in voxels per second, zero to use the measured camera movement
+		void Update(ChunkMatrix &matrix, const AABB &camera, Vec2f velocity, float deltaTime);
+
+		const ChunkPrefetchStats& GetStats() const { return stats; }
+		void ResetStats() { stats = {}; }
+
+		bool enabled = true;
+		uint16_t lookaheadFrames = 30;
+		static constexpr uint16_t MAX_REQUESTS_PER_UPDATE = 16;
+	private:
+		/// @brief Inclusive range of chunk positions
+		struct ChunkRange {
+			Vec2i min;
+			Vec2i max;
+
+			bool Contains(const Vec2i &pos) const { return pos.x >= min.x && pos.x <= max.x && pos.y >= min.y && pos.y <= max.y; }
+		};
+		static ChunkRange RangeOf(const AABB &area);
+
+		void CountNewlyVisible(ChunkMatrix &matrix, const ChunkRange &visible);
+
+		ChunkPrefetchStats stats;
+
+		const ChunkMatrix *lastMatrix = nullptr;
+		ChunkRange lastVisible;
+		Vec2f lastCenter;
+	};
+}
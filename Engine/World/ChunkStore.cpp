@@ -0,0 +1,441 @@
+#include "World/ChunkStore.h"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+
+#include "Debug/Logger.h"
+#include "Debug/Profiler.h"
+#include "World/Chunk.h"
+
+using namespace Volume;
+
+namespace {
+    // chunk and region data is stored in the native (little endian) byte order
+    class ByteWriter {
+    public:
+        explicit ByteWriter(std::vector<uint8_t> &out) : out(out) {}
+
+        template<typename T>
+        void Write(const T &value) { WriteBytes(&value, sizeof(T)); }
+        void WriteBytes(const void *data, size_t size)
+        {
+            const uint8_t *bytes = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), bytes, bytes + size);
+        }
+    private:
+        std::vector<uint8_t> &out;
+    };
+
+    class ByteReader {
+    public:
+        explicit ByteReader(const std::vector<uint8_t> &in) : in(in) {}
+
+        template<typename T>
+        T Read()
+        {
+            T value;
+            ReadBytes(&value, sizeof(T));
+            return value;
+        }
+        void ReadBytes(void *data, size_t size)
+        {
+            if(position + size > in.size())
+                throw std::runtime_error("Chunk data is truncated");
+            std::memcpy(data, in.data() + position, size);
+            position += size;
+        }
+    private:
+        const std::vector<uint8_t> &in;
+        size_t position = 0;
+    };
+
+    /// @brief Gravity state of built-in solids and liquids (and classes deriving from them), nullptr for everything else
+    IGravity *GravityOf(VoxelElement *voxel)
+    {
+        if(VoxelSolid *solid = voxel->AsSolid()) return solid;
+
+        constexpr uint8_t builtinLiquid = VoxelFlags::BUILTIN_CLASS | static_cast<uint8_t>(State::Liquid);
+        if((voxel->GetFlags() & (VoxelFlags::BUILTIN_CLASS | VoxelFlags::STATE_MASK)) == builtinLiquid)
+            return static_cast<VoxelLiquid*>(voxel);
+        return nullptr;
+    }
+
+    /// @brief Motion of a voxel that differs from a freshly created one
+    struct StoredMotion {
+        uint16_t index;
+        int16_t acceleration;
+        uint16_t xVelocity;
+    };
+
+    int FloorDiv(int value, int divisor)
+    {
+        return value >= 0 ? value / divisor : (value - divisor + 1) / divisor;
+    }
+}
+
+ChunkStore::ChunkStore(const std::filesystem::path &directory)
+    : directory(directory)
+{
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    if(error)
+        throw std::runtime_error("Failed to create chunk store directory " + directory.string() + ": " + error.message());
+
+    this->writer = std::thread(&ChunkStore::WriterLoop, this);
+}
+
+ChunkStore::~ChunkStore()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->queueMutex);
+        this->stopping = true;
+    }
+    this->queueChanged.notify_all();
+
+    // the writer drains the queue before it exits
+    if(this->writer.joinable()) this->writer.join();
+}
+
+void ChunkStore::Save(const Chunk &chunk)
+{
+    Blob data = std::make_shared<const std::vector<uint8_t>>(Serialize(chunk));
+
+    std::lock_guard<std::mutex> lock(this->queueMutex);
+    this->unwritten[Key(chunk.GetPos())] = data;
+    this->writeQueue.emplace_back(chunk.GetPos(), data);
+    this->queueChanged.notify_all();
+}
+
+Chunk *ChunkStore::Load(const Vec2i &chunkPos)
+{
+    try{
+        Blob pending;
+        {
+            std::lock_guard<std::mutex> lock(this->queueMutex);
+            auto it = this->unwritten.find(Key(chunkPos));
+            if(it != this->unwritten.end()) pending = it->second;
+        }
+        if(pending) return Deserialize(*pending, chunkPos);
+
+        std::vector<uint8_t> data;
+        if(!this->ReadFromRegion(chunkPos, data)) return nullptr;
+
+        return Deserialize(data, chunkPos);
+    }catch(const std::exception &e){
+        Debug::LogError("Failed to load chunk (" + std::to_string(chunkPos.x) + ", " + std::to_string(chunkPos.y) + ") from the chunk store: " + e.what());
+        return nullptr;
+    }
+}
+
+void ChunkStore::Flush()
+{
+    std::unique_lock<std::mutex> lock(this->queueMutex);
+    this->queueChanged.wait(lock, [this]{ return this->writeQueue.empty() && !this->writing; });
+}
+
+/// @brief Chunk format: header, material names, per voxel material index, temperature, amount and flags,
+/// followed by the voxels whose color differs from `VoxelElement::GetDefaultColor` and (since version 2)
+/// the solids and liquids whose acceleration or sideways velocity differs from a new voxel
+std::vector<uint8_t> ChunkStore::Serialize(const Chunk &chunk)
+{
+    constexpr uint16_t voxelCount = Chunk::CHUNK_SIZE_SQUARED;
+    const ChunkPalette *palette = chunk.GetPalette();
+    const Vec2i worldOrigin = chunk.GetPos() * Chunk::CHUNK_SIZE;
+
+    // material names are stored instead of IDs, IDs depend on the registration order
+    std::vector<MaterialID> materials;
+    std::unordered_map<MaterialID, uint16_t> materialIndices;
+    std::vector<uint16_t> indices(voxelCount);
+    std::vector<float> temperatures(voxelCount);
+    std::vector<float> amounts(voxelCount);
+    std::vector<uint8_t> flags(voxelCount);
+    std::vector<std::pair<uint16_t, uint32_t>> customColors;
+    std::vector<StoredMotion> motions;
+
+    for(uint16_t y = 0; y < Chunk::CHUNK_SIZE; ++y){
+        for(uint16_t x = 0; x < Chunk::CHUNK_SIZE; ++x){
+            uint16_t index = ChunkVoxelStorage::Index(x, y);
+            MaterialID material;
+
+            if(palette){
+                const ChunkPaletteEntry &entry = palette->Get(index);
+                material = entry.material;
+                temperatures[index] = entry.temperature;
+                amounts[index] = entry.amount;
+                flags[index] = entry.flags;
+            }else{
+                const VoxelElement *voxel = chunk.voxels[y][x];
+                if(!voxel)
+                    throw std::runtime_error("Cannot serialize chunk with missing voxels");
+
+                material = voxel->properties->id;
+                temperatures[index] = voxel->temperature.GetCelsius();
+                amounts[index] = voxel->amount;
+                flags[index] = ChunkVoxelStorage::FlagsOf(voxel);
+
+                uint32_t color = ChunkVoxelStorage::PackColor(voxel->color);
+                if(color != ChunkVoxelStorage::PackColor(VoxelElement::GetDefaultColor(voxel->properties, worldOrigin + Vec2i(x, y))))
+                    customColors.emplace_back(index, color);
+
+                if(const IGravity *gravity = GravityOf(chunk.voxels[y][x])){
+                    const VoxelSolid *solid = voxel->AsSolid();
+                    StoredMotion motion = { index, gravity->GetAcceleration(), solid ? solid->XVelocity : uint16_t(0) };
+                    if(motion.acceleration != 1 || motion.xVelocity != 0)
+                        motions.push_back(motion);
+                }
+            }
+
+            auto [it, inserted] = materialIndices.try_emplace(material, static_cast<uint16_t>(materials.size()));
+            if(inserted) materials.push_back(material);
+            indices[index] = it->second;
+        }
+    }
+
+    std::vector<uint8_t> data;
+    data.reserve(voxelCount * 10 + 64);
+    ByteWriter writer(data);
+
+    writer.Write(CHUNK_MAGIC);
+    writer.Write(FORMAT_VERSION);
+    writer.Write<int32_t>(chunk.GetPos().x);
+    writer.Write<int32_t>(chunk.GetPos().y);
+
+    writer.Write<uint16_t>(static_cast<uint16_t>(materials.size()));
+    for(MaterialID material : materials){
+        std::string name = Registry::VoxelRegistry::GetStringID(material);
+        writer.Write<uint16_t>(static_cast<uint16_t>(name.size()));
+        writer.WriteBytes(name.data(), name.size());
+    }
+
+    uint8_t indexBytes = materials.size() <= 256 ? 1 : 2;
+    writer.Write(indexBytes);
+    for(uint16_t index : indices){
+        if(indexBytes == 1) writer.Write<uint8_t>(static_cast<uint8_t>(index));
+        else                writer.Write<uint16_t>(index);
+    }
+
+    writer.WriteBytes(temperatures.data(), temperatures.size() * sizeof(float));
+    writer.WriteBytes(amounts.data(), amounts.size() * sizeof(float));
+    writer.WriteBytes(flags.data(), flags.size());
+
+    writer.Write<uint16_t>(static_cast<uint16_t>(customColors.size()));
+    for(const auto &[index, color] : customColors){
+        writer.Write(index);
+        writer.Write(color);
+    }
+
+    writer.Write<uint16_t>(static_cast<uint16_t>(motions.size()));
+    for(const StoredMotion &motion : motions){
+        writer.Write(motion.index);
+        writer.Write(motion.acceleration);
+        writer.Write(motion.xVelocity);
+    }
+
+    return data;
+}
+
+Chunk *ChunkStore::Deserialize(const std::vector<uint8_t> &data, const Vec2i &chunkPos)
+{
+    constexpr uint16_t voxelCount = Chunk::CHUNK_SIZE_SQUARED;
+    ByteReader reader(data);
+
+    if(reader.Read<uint32_t>() != CHUNK_MAGIC)
+        throw std::runtime_error("Not a chunk record");
+    uint16_t version = reader.Read<uint16_t>();
+    if(version == 0 || version > FORMAT_VERSION)
+        throw std::runtime_error("Unsupported chunk format version " + std::to_string(version));
+
+    Vec2i storedPos;
+    storedPos.x = reader.Read<int32_t>();
+    storedPos.y = reader.Read<int32_t>();
+    if(storedPos != chunkPos)
+        throw std::runtime_error("Chunk record belongs to a different position");
+
+    std::vector<MaterialID> materials(reader.Read<uint16_t>());
+    for(MaterialID &material : materials){
+        std::string name(reader.Read<uint16_t>(), '\0');
+        reader.ReadBytes(name.data(), name.size());
+        material = Registry::VoxelRegistry::GetMaterialID(name);
+    }
+
+    uint8_t indexBytes = reader.Read<uint8_t>();
+    if(indexBytes != 1 && indexBytes != 2)
+        throw std::runtime_error("Invalid material index size");
+
+    std::vector<uint16_t> indices(voxelCount);
+    for(uint16_t &index : indices){
+        index = indexBytes == 1 ? reader.Read<uint8_t>() : reader.Read<uint16_t>();
+        if(index >= materials.size())
+            throw std::runtime_error("Material index out of range");
+    }
+
+    std::vector<float> temperatures(voxelCount);
+    std::vector<float> amounts(voxelCount);
+    std::vector<uint8_t> flags(voxelCount);
+    reader.ReadBytes(temperatures.data(), temperatures.size() * sizeof(float));
+    reader.ReadBytes(amounts.data(), amounts.size() * sizeof(float));
+    reader.ReadBytes(flags.data(), flags.size());
+
+    std::vector<std::pair<uint16_t, uint32_t>> customColors(reader.Read<uint16_t>());
+    for(auto &[index, color] : customColors){
+        index = reader.Read<uint16_t>();
+        color = reader.Read<uint32_t>();
+        if(index >= voxelCount)
+            throw std::runtime_error("Voxel index out of range");
+    }
+
+    // version 1 chunks did not store motion, their voxels start at rest
+    std::vector<StoredMotion> motions(version >= 2 ? reader.Read<uint16_t>() : 0);
+    for(StoredMotion &motion : motions){
+        motion.index = reader.Read<uint16_t>();
+        motion.acceleration = reader.Read<int16_t>();
+        motion.xVelocity = reader.Read<uint16_t>();
+        if(motion.index >= voxelCount)
+            throw std::runtime_error("Voxel index out of range");
+    }
+
+    // the chunk deletes whatever got created if anything below throws
+    std::unique_ptr<Chunk> chunk = std::make_unique<Chunk>(chunkPos);
+    for(uint16_t y = 0; y < Chunk::CHUNK_SIZE; ++y)
+        for(uint16_t x = 0; x < Chunk::CHUNK_SIZE; ++x)
+            chunk->voxels[y][x] = nullptr;
+
+    const Vec2i worldOrigin = chunkPos * Chunk::CHUNK_SIZE;
+    for(uint16_t y = 0; y < Chunk::CHUNK_SIZE; ++y){
+        for(uint16_t x = 0; x < Chunk::CHUNK_SIZE; ++x){
+            uint16_t index = ChunkVoxelStorage::Index(x, y);
+
+            VoxelElement *voxel = CreateVoxelElement(
+                materials[indices[index]],
+                worldOrigin + Vec2i(x, y),
+                amounts[index],
+                Temperature(temperatures[index]),
+                (flags[index] & VoxelFlags::STATIC) != 0
+            );
+            chunk->voxels[y][x] = voxel;
+
+            // falling voxels continue where they stopped
+            if(flags[index] & VoxelFlags::FALLING){
+                voxel->SetFalling(true);
+                chunk->dirtyTiles.Include(Vec2i(x, y));
+            }
+        }
+    }
+
+    for(const auto &[index, color] : customColors)
+        chunk->voxels[index / Chunk::CHUNK_SIZE][index % Chunk::CHUNK_SIZE]->color = ChunkVoxelStorage::UnpackColor(color);
+
+    for(const StoredMotion &motion : motions){
+        VoxelElement *voxel = chunk->voxels[motion.index / Chunk::CHUNK_SIZE][motion.index % Chunk::CHUNK_SIZE];
+        // the material may have been registered with a different constructor since the chunk was saved
+        if(IGravity *gravity = GravityOf(voxel))
+            gravity->SetAcceleration(motion.acceleration);
+        if(VoxelSolid *solid = voxel->AsSolid())
+            solid->XVelocity = motion.xVelocity;
+    }
+
+    return chunk.release();
+}
+
+uint64_t ChunkStore::Key(const Vec2i &chunkPos)
+{
+    return (static_cast<uint64_t>(static_cast<uint32_t>(chunkPos.x)) << 32) | static_cast<uint32_t>(chunkPos.y);
+}
+
+Vec2i ChunkStore::RegionOf(const Vec2i &chunkPos)
+{
+    return Vec2i(FloorDiv(chunkPos.x, RegionFile::REGION_SIZE), FloorDiv(chunkPos.y, RegionFile::REGION_SIZE));
+}
+
+int ChunkStore::SlotOf(const Vec2i &chunkPos)
+{
+    Vec2i local = chunkPos - RegionOf(chunkPos) * RegionFile::REGION_SIZE;
+    return local.y * RegionFile::REGION_SIZE + local.x;
+}
+
+RegionFile &ChunkStore::GetRegion(const Vec2i &chunkPos)
+{
+    Vec2i region = RegionOf(chunkPos);
+    uint64_t key = Key(region);
+
+    auto it = this->regions.find(key);
+    if(it != this->regions.end()) return *it->second;
+
+    // unmapping everything is cheap compared to the page faults it saves later on
+    if(this->regions.size() >= MAX_OPEN_REGIONS)
+        this->regions.clear();
+
+    std::filesystem::path path = this->directory / ("r." + std::to_string(region.x) + "." + std::to_string(region.y) + RegionFile::EXTENSION);
+    return *this->regions.emplace(key, std::make_unique<RegionFile>(path)).first->second;
+}
+
+void ChunkStore::WriteToRegion(const Vec2i &chunkPos, const std::vector<uint8_t> &data)
+{
+    std::lock_guard<std::mutex> lock(this->fileMutex);
+    this->GetRegion(chunkPos).Write(SlotOf(chunkPos), data);
+}
+
+bool ChunkStore::ReadFromRegion(const Vec2i &chunkPos, std::vector<uint8_t> &data)
+{
+    std::lock_guard<std::mutex> lock(this->fileMutex);
+    return this->GetRegion(chunkPos).Read(SlotOf(chunkPos), data);
+}
+
+size_t ChunkStore::CompactRegions(float minFragmentation)
+{
+    std::lock_guard<std::mutex> lock(this->fileMutex);
+    // cached regions keep their mappings, drop them so compaction can replace the files
+    this->regions.clear();
+
+    size_t compacted = 0;
+    for(const auto &file : std::filesystem::directory_iterator(this->directory)){
+        if(!file.is_regular_file() || file.path().extension() != RegionFile::EXTENSION) continue;
+
+        try{
+            RegionFile region(file.path());
+            if(region.GetStats().GetFragmentation() < minFragmentation) continue;
+
+            uint32_t dropped = region.Compact();
+            if(dropped > 0)
+                Debug::LogWarn("Dropped " + std::to_string(dropped) + " corrupted chunks while compacting " + file.path().string());
+            compacted++;
+        }catch(const std::exception &e){
+            Debug::LogError("Failed to compact region file " + file.path().string() + ": " + e.what());
+        }
+    }
+    return compacted;
+}
+
+void ChunkStore::WriterLoop()
+{
+    Debug::TraceRecorder::SetThreadName("Chunk store writer");
+
+    std::unique_lock<std::mutex> lock(this->queueMutex);
+    while(true){
+        this->queueChanged.wait(lock, [this]{ return this->stopping || !this->writeQueue.empty(); });
+        if(this->writeQueue.empty()) return; // stopping and drained
+
+        auto [chunkPos, data] = this->writeQueue.front();
+        this->writeQueue.pop_front();
+        this->writing = true;
+
+        lock.unlock();
+        try{
+            TRACE_SCOPE("Write chunk");
+            this->WriteToRegion(chunkPos, *data);
+        }catch(const std::exception &e){
+            Debug::LogError("Failed to store chunk (" + std::to_string(chunkPos.x) + ", " + std::to_string(chunkPos.y) + "): " + e.what());
+        }
+        lock.lock();
+
+        this->writing = false;
+        // a newer copy may have been queued while this one was written
+        auto it = this->unwritten.find(Key(chunkPos));
+        if(it != this->unwritten.end() && it->second == data)
+            this->unwritten.erase(it);
+
+        this->queueChanged.notify_all();
+    }
+}
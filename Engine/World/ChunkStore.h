@@ -0,0 +1,86 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "Math/Vector.h"
+#include "World/Storage/RegionFile.h"
+
+namespace Volume
+{
+	class Chunk;
+
+	/// @brief Persists evicted chunks in region files under a save directory
+	/// @note Every region file holds `RegionFile::REGION_SIZE` x `RegionFile::REGION_SIZE` chunks and stays
+	/// mapped while it is in use. Chunks are serialized on the calling thread and written by a background
+	/// writer, `Load` sees chunks that are still waiting to be written. All methods are thread safe
+	/// @warning Voxels are recreated through `CreateVoxelElement` on load. Material, temperature, amount, flags,
+	/// color and the motion of built-in solids and liquids survive, state private to custom voxel classes
+	/// (e.g. the remaining lifetime of `FireVoxel`) starts over as if the voxel was just created
+	class ChunkStore {
+	public:
+		explicit ChunkStore(const std::filesystem::path &directory);
+		~ChunkStore();
+
+		// disable copy
+		ChunkStore(const ChunkStore&) = delete;
+		ChunkStore& operator=(const ChunkStore&) = delete;
+
+		/// @brief Serializes the chunk and queues it for writing, the chunk can be deleted right after
+		void Save(const Chunk &chunk);
+		/// @brief Loads a stored chunk
+		/// @return newly allocated chunk or nullptr if the chunk was never stored (or could not be read)
+		Chunk* Load(const Vec2i &chunkPos);
+		/// @brief Blocks until every queued chunk is written
+		void Flush();
+
+		const std::filesystem::path& GetDirectory() const { return directory; }
+
+		static std::vector<uint8_t> Serialize(const Chunk &chunk);
+		static Chunk* Deserialize(const std::vector<uint8_t> &data, const Vec2i &chunkPos);
+
+		/// @brief Compacts every region file with at least `minFragmentation` unused space
+		/// @return number of compacted region files
+		size_t CompactRegions(float minFragmentation = DEFAULT_COMPACT_FRAGMENTATION);
+
+		static constexpr uint32_t CHUNK_MAGIC = 0x4B435856;	// "VXCK"
+		static constexpr uint16_t FORMAT_VERSION = 2;
+		static constexpr float DEFAULT_COMPACT_FRAGMENTATION = 0.25f;
+		static constexpr size_t MAX_OPEN_REGIONS = 64;
+	private:
+		using Blob = std::shared_ptr<const std::vector<uint8_t>>;
+
+		static uint64_t Key(const Vec2i &chunkPos);
+		static Vec2i RegionOf(const Vec2i &chunkPos);
+		static int SlotOf(const Vec2i &chunkPos);
+		/// @brief Returns the cached (mapped) region file of a chunk, fileMutex must be held
+		RegionFile& GetRegion(const Vec2i &chunkPos);
+
+		void WriteToRegion(const Vec2i &chunkPos, const std::vector<uint8_t> &data);
+		bool ReadFromRegion(const Vec2i &chunkPos, std::vector<uint8_t> &data);
+
+		void WriterLoop();
+
+		std::filesystem::path directory;
+
+		// guards region file access, the writer and loading workers share files
+		std::mutex fileMutex;
+		std::unordered_map<uint64_t, std::unique_ptr<RegionFile>> regions;
+
+		std::mutex queueMutex;
+		std::condition_variable queueChanged;
+		std::deque<std::pair<Vec2i, Blob>> writeQueue;
+		std::unordered_map<uint64_t, Blob> unwritten;	// newest queued blob per chunk
+		bool writing = false;
+		bool stopping = false;
+
+		std::thread writer;
+	};
+}
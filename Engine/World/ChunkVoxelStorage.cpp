@@ -0,0 +1,66 @@
+#include "World/ChunkVoxelStorage.h"
+
+#include "World/Voxel.h"
+
+using namespace Volume;
+
+static_assert(MAX_MATERIAL_ID <= UINT16_MAX, "ChunkVoxelStorage::materialId has to hold every material id");
+
+/// @brief Copies the hot fields of a voxel into the storage arrays
+/// @param index index of the voxel (`ChunkVoxelStorage::Index`)
+/// @param voxel voxel to copy from, nullptr clears the slot
+void ChunkVoxelStorage::Write(uint16_t index, const VoxelElement *voxel)
+{
+    if(!voxel){
+        materialId[index] = 0;
+        temperature[index] = 0;
+        amount[index] = 0;
+        packedColor[index] = 0;
+        flags[index] = 0;
+        return;
+    }
+
+    materialId[index] = static_cast<uint16_t>(voxel->properties->id);
+    temperature[index] = voxel->temperature.GetCelsius();
+    amount[index] = voxel->amount;
+    packedColor[index] = PackColor(voxel->color);
+    flags[index] = FlagsOf(voxel);
+}
+
+/// @brief Copies temperature, amount, color and flags of the voxel already in the slot
+/// @param index index of the voxel (`ChunkVoxelStorage::Index`)
+void ChunkVoxelStorage::Refresh(uint16_t index, const VoxelElement *voxel)
+{
+    temperature[index] = voxel->temperature.GetCelsius();
+    amount[index] = voxel->amount;
+    packedColor[index] = PackColor(voxel->color);
+    flags[index] = FlagsOf(voxel);
+}
+
+/// @brief Returns the storage flags byte of a voxel (see `Volume::VoxelFlags`)
+uint8_t ChunkVoxelStorage::FlagsOf(const VoxelElement *voxel)
+{
+    // custom voxels may override GetState, so the state bits are not copied from the voxel
+    uint8_t voxelFlags = voxel->GetFlags() & (VoxelFlags::STATIC | VoxelFlags::PART_OF_OBJECT | VoxelFlags::FALLING);
+    voxelFlags |= static_cast<uint8_t>(voxel->GetState()) & VoxelFlags::STATE_MASK;
+    if(voxel->IsSolidCollider())    voxelFlags |= VoxelFlags::SOLID_COLLIDER;
+    return voxelFlags;
+}
+
+uint32_t ChunkVoxelStorage::PackColor(const RGBA &color)
+{
+    return static_cast<uint32_t>(color.r)
+        | (static_cast<uint32_t>(color.g) << 8)
+        | (static_cast<uint32_t>(color.b) << 16)
+        | (static_cast<uint32_t>(color.a) << 24);
+}
+
+RGBA ChunkVoxelStorage::UnpackColor(uint32_t color)
+{
+    return RGBA(
+        static_cast<uint8_t>(color & 0xFF),
+        static_cast<uint8_t>((color >> 8) & 0xFF),
+        static_cast<uint8_t>((color >> 16) & 0xFF),
+        static_cast<uint8_t>((color >> 24) & 0xFF)
+    );
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+
+#include "Math/Color.h"
+#include "Math/Vector.h"
+
+namespace Volume
+{
+	class VoxelElement;
+
+	/// @brief Dense structure-of-arrays storage of the hot voxel fields of a chunk
+	/// @note Indexed by `y * SIZE + x`. Material and state are written whenever a slot of `Chunk::voxels`
+	/// changes, so they are always exact and the simulation reads them from here (`VoxelNeighborhood::Probe`).
+	/// Temperature, amount, color and the dynamic flags change in place on the voxels and get refreshed
+	/// for the dirty tiles after every chunk update
+	/// @note This is a mirror next to `Chunk::voxels`, not a replacement. It costs 60 KiB per chunk on top of
+	/// the 32 KiB pointer array and 256-320 KiB of pooled voxels, in exchange the probes, the GPU upload and the
+	/// renderer never have to chase voxel pointers
+	struct ChunkVoxelStorage {
+		static constexpr uint16_t SIZE = 64;
+		static constexpr uint16_t SIZE_SQUARED = SIZE * SIZE;
+
+		uint16_t materialId[SIZE_SQUARED];	// fits every id, see Volume::MAX_MATERIAL_ID
+		float temperature[SIZE_SQUARED];	// Celsius
+		float amount[SIZE_SQUARED];
+		uint32_t packedColor[SIZE_SQUARED];	// RGBA, R in the lowest byte
+		uint8_t flags[SIZE_SQUARED];		// see Volume::VoxelFlags
+
+		static constexpr uint16_t Index(uint16_t x, uint16_t y) { return y * SIZE + x; }
+
+		void Write(uint16_t index, const VoxelElement *voxel);
+		/// @brief Copies only the fields voxels change in place, the material stays
+		void Refresh(uint16_t index, const VoxelElement *voxel);
+		static uint8_t FlagsOf(const VoxelElement *voxel);
+
+		static uint32_t PackColor(const RGBA &color);
+		static RGBA UnpackColor(uint32_t color);
+	};
+
+	/// @brief Thin read/write view of a single voxel inside a `ChunkVoxelStorage`
+	class VoxelHandle {
+	public:
+		VoxelHandle(ChunkVoxelStorage *storage, uint16_t index) : storage(storage), index(index) {};
+
+		uint16_t GetMaterialId() const { return storage->materialId[index]; }
+		float GetTemperature() const { return storage->temperature[index]; }
+		float GetAmount() const { return storage->amount[index]; }
+		uint32_t GetPackedColor() const { return storage->packedColor[index]; }
+		uint8_t GetFlags() const { return storage->flags[index]; }
+
+		void SetTemperature(float celsius) { storage->temperature[index] = celsius; }
+		void SetAmount(float amount) { storage->amount[index] = amount; }
+
+		bool HasFlag(uint8_t flag) const { return (storage->flags[index] & flag) != 0; }
+	private:
+		ChunkVoxelStorage *storage;
+		uint16_t index;
+	};
+}
@@ -0,0 +1,158 @@
+#include "World/Storage/BlobCompression.h"
+
+#include <array>
+#include <cstring>
+
+using namespace Volume;
+
+namespace {
+    constexpr size_t MIN_MATCH = 4;
+    constexpr size_t MAX_OFFSET = 0xFFFF;
+    constexpr int HASH_BITS = 12;
+
+    uint32_t Read32(const uint8_t *data)
+    {
+        uint32_t value;
+        std::memcpy(&value, data, sizeof(value));
+        return value;
+    }
+
+    uint32_t Hash(uint32_t sequence)
+    {
+        return (sequence * 2654435761u) >> (32 - HASH_BITS);
+    }
+
+    /// @brief Lengths that do not fit in a nibble continue in bytes of 255 until a smaller byte
+    void WriteLength(std::vector<uint8_t> &out, size_t length)
+    {
+        while(length >= 255){
+            out.push_back(255);
+            length -= 255;
+        }
+        out.push_back(static_cast<uint8_t>(length));
+    }
+
+    bool ReadLength(const uint8_t *&in, const uint8_t *end, size_t &length)
+    {
+        uint8_t byte;
+        do{
+            if(in >= end) return false;
+            byte = *in++;
+            length += byte;
+        }while(byte == 255);
+        return true;
+    }
+
+    void WriteSequence(std::vector<uint8_t> &out, const uint8_t *literals, size_t literalCount, size_t offset, size_t matchLength)
+    {
+        size_t matchExtra = matchLength ? matchLength - MIN_MATCH : 0;
+
+        uint8_t token = static_cast<uint8_t>((literalCount < 15 ? literalCount : 15) << 4);
+        token |= static_cast<uint8_t>(matchExtra < 15 ? matchExtra : 15);
+        out.push_back(token);
+
+        if(literalCount >= 15) WriteLength(out, literalCount - 15);
+        out.insert(out.end(), literals, literals + literalCount);
+
+        // the last sequence has no match
+        if(matchLength == 0) return;
+
+        out.push_back(static_cast<uint8_t>(offset & 0xFF));
+        out.push_back(static_cast<uint8_t>(offset >> 8));
+        if(matchExtra >= 15) WriteLength(out, matchExtra - 15);
+    }
+
+    std::array<uint32_t, 256> BuildCrcTable()
+    {
+        std::array<uint32_t, 256> table;
+        for(uint32_t i = 0; i < 256; ++i){
+            uint32_t crc = i;
+            for(int bit = 0; bit < 8; ++bit)
+                crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320u : crc >> 1;
+            table[i] = crc;
+        }
+        return table;
+    }
+}
+
+std::vector<uint8_t> BlobCompression::Compress(const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> out;
+    out.reserve(size / 2 + 16);
+
+    std::vector<int64_t> table(size_t(1) << HASH_BITS, -1);
+    size_t anchor = 0;
+    size_t position = 0;
+
+    while(position + MIN_MATCH <= size){
+        uint32_t sequence = Read32(data + position);
+        uint32_t hash = Hash(sequence);
+        int64_t candidate = table[hash];
+        table[hash] = static_cast<int64_t>(position);
+
+        if(candidate < 0 || position - candidate > MAX_OFFSET || Read32(data + candidate) != sequence){
+            position++;
+            continue;
+        }
+
+        size_t matchLength = MIN_MATCH;
+        while(position + matchLength < size && data[candidate + matchLength] == data[position + matchLength])
+            matchLength++;
+
+        WriteSequence(out, data + anchor, position - anchor, position - candidate, matchLength);
+        position += matchLength;
+        anchor = position;
+    }
+
+    WriteSequence(out, data + anchor, size - anchor, 0, 0);
+    return out;
+}
+
+bool BlobCompression::Decompress(const uint8_t *data, size_t size, uint8_t *out, size_t rawSize)
+{
+    const uint8_t *in = data;
+    const uint8_t *inEnd = data + size;
+    size_t written = 0;
+
+    while(in < inEnd){
+        uint8_t token = *in++;
+
+        size_t literalCount = token >> 4;
+        if(literalCount == 15 && !ReadLength(in, inEnd, literalCount)) return false;
+        if(literalCount > static_cast<size_t>(inEnd - in) || literalCount > rawSize - written) return false;
+
+        std::memcpy(out + written, in, literalCount);
+        in += literalCount;
+        written += literalCount;
+
+        if(written == rawSize) return in == inEnd;
+
+        if(inEnd - in < 2) return false;
+        size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+        in += 2;
+        if(offset == 0 || offset > written) return false;
+
+        size_t matchLength = (token & 0x0F);
+        if(matchLength == 15 && !ReadLength(in, inEnd, matchLength)) return false;
+        matchLength += MIN_MATCH;
+        if(matchLength > rawSize - written) return false;
+
+        // matches may overlap the bytes they produce, copy byte by byte
+        const uint8_t *match = out + written - offset;
+        for(size_t i = 0; i < matchLength; ++i)
+            out[written + i] = match[i];
+        written += matchLength;
+    }
+
+    return written == rawSize;
+}
+
+uint32_t BlobCompression::Crc32(const uint8_t *data, size_t size)
+{
+    static const std::array<uint32_t, 256> table = BuildCrcTable();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for(size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
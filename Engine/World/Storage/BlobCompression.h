@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Volume
+{
+	/// @brief LZ4 style compression for stored chunk blobs, tuned for speed over ratio
+	/// @note Sequences of (literal run, back reference) with 4 bit length nibbles and 16 bit offsets.
+	/// Not compatible with the real LZ4 block or frame format
+	class BlobCompression {
+	public:
+		static std::vector<uint8_t> Compress(const uint8_t *data, size_t size);
+		/// @brief Decompresses exactly `rawSize` bytes into `out`
+		/// @return false if the data is malformed or does not decompress to `rawSize` bytes
+		static bool Decompress(const uint8_t *data, size_t size, uint8_t *out, size_t rawSize);
+
+		/// @brief CRC-32 (IEEE 802.3 polynomial)
+		static uint32_t Crc32(const uint8_t *data, size_t size);
+	};
+}
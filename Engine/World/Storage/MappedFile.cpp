@@ -0,0 +1,109 @@
+#include "World/Storage/MappedFile.h"
+
+#include <stdexcept>
+#include <system_error>
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+using namespace Volume;
+
+MappedFile::~MappedFile()
+{
+    this->Close();
+}
+
+bool MappedFile::Open(const std::filesystem::path &path)
+{
+    this->Close();
+
+    std::error_code error;
+    if(!std::filesystem::exists(path, error)) return false;
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if(file == INVALID_HANDLE_VALUE)
+        throw std::runtime_error("Failed to open " + path.string() + " for mapping");
+
+    LARGE_INTEGER fileSize;
+    if(!GetFileSizeEx(file, &fileSize)){
+        CloseHandle(file);
+        throw std::runtime_error("Failed to read the size of " + path.string());
+    }
+    if(fileSize.QuadPart == 0){
+        // empty files cannot be mapped
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if(!mapping){
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map " + path.string());
+    }
+
+    void *view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if(!view){
+        CloseHandle(mapping);
+        CloseHandle(file);
+        throw std::runtime_error("Failed to map " + path.string());
+    }
+
+    this->fileHandle = file;
+    this->mappingHandle = mapping;
+    this->data = static_cast<const uint8_t*>(view);
+    this->size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int file = open(path.c_str(), O_RDONLY);
+    if(file < 0)
+        throw std::runtime_error("Failed to open " + path.string() + " for mapping");
+
+    struct stat fileStat;
+    if(fstat(file, &fileStat) != 0){
+        close(file);
+        throw std::runtime_error("Failed to read the size of " + path.string());
+    }
+    if(fileStat.st_size == 0){
+        // empty files cannot be mapped
+        close(file);
+        return false;
+    }
+
+    void *view = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, file, 0);
+    // the mapping stays valid after the descriptor is closed
+    close(file);
+    if(view == MAP_FAILED)
+        throw std::runtime_error("Failed to map " + path.string());
+
+    this->data = static_cast<const uint8_t*>(view);
+    this->size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if(!this->data) return;
+
+#ifdef _WIN32
+    UnmapViewOfFile(this->data);
+    CloseHandle(this->mappingHandle);
+    CloseHandle(this->fileHandle);
+    this->mappingHandle = nullptr;
+    this->fileHandle = nullptr;
+#else
+    munmap(const_cast<uint8_t*>(this->data), this->size);
+#endif
+
+    this->data = nullptr;
+    this->size = 0;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace Volume
+{
+	/// @brief Read-only memory mapping of a whole file
+	/// @note The mapping does not follow later writes to the file, close and reopen it after writing
+	class MappedFile {
+	public:
+		MappedFile() = default;
+		~MappedFile();
+
+		// disable copy
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		/// @return false if the file does not exist, throws if it exists but cannot be mapped
+		bool Open(const std::filesystem::path &path);
+		void Close();
+
+		bool IsOpen() const { return data != nullptr; }
+		const uint8_t* GetData() const { return data; }
+		size_t GetSize() const { return size; }
+	private:
+		const uint8_t *data = nullptr;
+		size_t size = 0;
+
+#ifdef _WIN32
+		void *fileHandle = nullptr;
+		void *mappingHandle = nullptr;
+#endif
+	};
+}
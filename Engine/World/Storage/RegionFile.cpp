@@ -0,0 +1,183 @@
+#include "World/Storage/RegionFile.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "World/Storage/BlobCompression.h"
+
+using namespace Volume;
+
+bool RegionFile::Read(int slot, std::vector<uint8_t> &data)
+{
+    if(!this->LoadTable()) return false;
+
+    const Entry &entry = this->table[slot];
+    if(entry.storedSize == 0) return false;
+    if(!IsValidEntry(entry))
+        throw std::runtime_error("Invalid table entry in region file " + this->path.string() + " slot " + std::to_string(slot));
+
+    const uint8_t *stored = this->MapRange(entry.offset, entry.storedSize);
+    if(BlobCompression::Crc32(stored, entry.storedSize) != entry.checksum)
+        throw std::runtime_error("Checksum mismatch in region file " + this->path.string() + " slot " + std::to_string(slot));
+
+    data.resize(entry.rawSize);
+    if(entry.storedSize == entry.rawSize){
+        std::memcpy(data.data(), stored, entry.rawSize);
+        return true;
+    }
+
+    if(!BlobCompression::Decompress(stored, entry.storedSize, data.data(), entry.rawSize))
+        throw std::runtime_error("Corrupted blob in region file " + this->path.string() + " slot " + std::to_string(slot));
+
+    return true;
+}
+
+void RegionFile::Write(int slot, const std::vector<uint8_t> &data)
+{
+    if(data.size() > MAX_BLOB_SIZE)
+        throw std::runtime_error("Blob of " + std::to_string(data.size()) + " bytes is too big for region file " + this->path.string());
+
+    bool exists = this->LoadTable();
+
+    std::vector<uint8_t> compressed = BlobCompression::Compress(data.data(), data.size());
+    // incompressible data is stored as is
+    const std::vector<uint8_t> &stored = compressed.size() < data.size() ? compressed : data;
+
+    Entry entry = {};
+    entry.storedSize = static_cast<uint32_t>(stored.size());
+    entry.rawSize = static_cast<uint32_t>(data.size());
+    entry.checksum = BlobCompression::Crc32(stored.data(), stored.size());
+
+    if(!exists){
+        std::ofstream create(this->path, std::ios::binary);
+        if(!create)
+            throw std::runtime_error("Failed to create region file " + this->path.string());
+
+        Header header = { MAGIC, VERSION, REGION_SIZE };
+        std::vector<uint8_t> start(DATA_OFFSET, 0);
+        std::memcpy(start.data(), &header, sizeof(header));
+        create.write(reinterpret_cast<const char*>(start.data()), start.size());
+        if(!create)
+            throw std::runtime_error("Failed to write region file " + this->path.string());
+        this->tableLoaded = true;
+    }
+
+    std::fstream file(this->path, std::ios::in | std::ios::out | std::ios::binary);
+    if(!file)
+        throw std::runtime_error("Failed to open region file " + this->path.string());
+
+    file.seekp(0, std::ios::end);
+    entry.offset = static_cast<uint64_t>(file.tellp());
+    file.write(reinterpret_cast<const char*>(stored.data()), stored.size());
+
+    // the table entry goes last, an interrupted write keeps the previous blob
+    file.seekp(TABLE_OFFSET + slot * sizeof(Entry));
+    file.write(reinterpret_cast<const char*>(&entry), sizeof(entry));
+
+    if(!file)
+        throw std::runtime_error("Failed to write region file " + this->path.string());
+
+    this->table[slot] = entry;
+}
+
+RegionFileStats RegionFile::GetStats()
+{
+    RegionFileStats stats;
+    if(!this->LoadTable()) return stats;
+
+    std::error_code error;
+    stats.fileSize = std::filesystem::file_size(this->path, error);
+    stats.liveBytes = DATA_OFFSET;
+    for(const Entry &entry : this->table){
+        if(entry.storedSize == 0) continue;
+        stats.chunkCount++;
+        stats.liveBytes += entry.storedSize;
+        stats.rawBytes += entry.rawSize;
+    }
+    return stats;
+}
+
+uint32_t RegionFile::Compact()
+{
+    if(!this->LoadTable()) return 0;
+
+    std::vector<uint8_t> compacted(DATA_OFFSET, 0);
+    Header header = { MAGIC, VERSION, REGION_SIZE };
+    std::memcpy(compacted.data(), &header, sizeof(header));
+
+    std::array<Entry, SLOT_COUNT> compactedTable = {};
+    uint32_t dropped = 0;
+    for(int slot = 0; slot < SLOT_COUNT; ++slot){
+        const Entry &entry = this->table[slot];
+        if(entry.storedSize == 0) continue;
+        if(!IsValidEntry(entry)){
+            dropped++;
+            continue;
+        }
+
+        const uint8_t *stored = this->MapRange(entry.offset, entry.storedSize);
+        if(BlobCompression::Crc32(stored, entry.storedSize) != entry.checksum){
+            dropped++;
+            continue;
+        }
+
+        compactedTable[slot] = entry;
+        compactedTable[slot].offset = compacted.size();
+        compacted.insert(compacted.end(), stored, stored + entry.storedSize);
+    }
+    std::memcpy(compacted.data() + TABLE_OFFSET, compactedTable.data(), sizeof(compactedTable));
+
+    std::filesystem::path temporaryPath = this->path;
+    temporaryPath += ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(compacted.data()), compacted.size());
+        if(!file)
+            throw std::runtime_error("Failed to write " + temporaryPath.string());
+    }
+
+    // the old file cannot be replaced while it is mapped on Windows
+    this->mapping.Close();
+    std::filesystem::rename(temporaryPath, this->path);
+    this->table = compactedTable;
+
+    return dropped;
+}
+
+/// @return false if the region file does not exist yet
+bool RegionFile::LoadTable()
+{
+    if(this->tableLoaded) return true;
+
+    if(!this->mapping.Open(this->path)){
+        if(std::filesystem::exists(this->path))
+            throw std::runtime_error("Region file " + this->path.string() + " is empty");
+        return false;
+    }
+
+    if(this->mapping.GetSize() < DATA_OFFSET)
+        throw std::runtime_error("Region file " + this->path.string() + " is truncated");
+
+    Header header;
+    std::memcpy(&header, this->mapping.GetData(), sizeof(header));
+    if(header.magic != MAGIC)
+        throw std::runtime_error(this->path.string() + " is not a region file");
+    if(header.version != VERSION || header.regionSize != REGION_SIZE)
+        throw std::runtime_error("Unsupported region file version " + std::to_string(header.version) + " in " + this->path.string());
+
+    std::memcpy(this->table.data(), this->mapping.GetData() + TABLE_OFFSET, sizeof(this->table));
+    this->tableLoaded = true;
+    return true;
+}
+
+const uint8_t *RegionFile::MapRange(uint64_t offset, uint32_t size)
+{
+    if(!this->mapping.IsOpen() || offset + size > this->mapping.GetSize()){
+        this->mapping.Open(this->path);
+        if(offset + size > this->mapping.GetSize())
+            throw std::runtime_error("Region file " + this->path.string() + " is truncated");
+    }
+    return this->mapping.GetData() + offset;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+#include "World/Storage/MappedFile.h"
+
+namespace Volume
+{
+	struct RegionFileStats {
+		uint32_t chunkCount = 0;
+		uint64_t fileSize = 0;
+		uint64_t liveBytes = 0;		// header, offset table and the blobs the table points at
+		uint64_t rawBytes = 0;		// stored blobs before compression
+
+		/// @brief Share of the file taken by blobs that were replaced by newer copies
+		float GetFragmentation() const { return fileSize ? 1.0f - static_cast<float>(liveBytes) / fileSize : 0.0f; }
+	};
+
+	/// @brief Memory-mapped file holding the compressed blobs of `REGION_SIZE` x `REGION_SIZE` chunks
+	/// @note Layout: header, offset table with one entry per chunk slot, then blobs. Blobs are only ever
+	/// appended, rewriting a slot leaves the old blob behind until the file is compacted.
+	/// Not thread safe
+	class RegionFile {
+	public:
+		explicit RegionFile(const std::filesystem::path &path) : path(path) {};
+
+		// disable copy
+		RegionFile(const RegionFile&) = delete;
+		RegionFile& operator=(const RegionFile&) = delete;
+
+		/// @brief Decompresses the blob of a slot into `data`, throws if the blob is corrupted
+		/// @return false if the slot (or the whole file) is empty
+		bool Read(int slot, std::vector<uint8_t> &data);
+		/// @brief Compresses and appends a blob, then points the slot at it
+		void Write(int slot, const std::vector<uint8_t> &data);
+
+		RegionFileStats GetStats();
+		/// @brief Rewrites the file with only the live blobs
+		/// @return number of corrupted blobs that were dropped
+		uint32_t Compact();
+
+		const std::filesystem::path& GetPath() const { return path; }
+
+		static constexpr int REGION_SIZE = 32;	// chunks per region side
+		static constexpr int SLOT_COUNT = REGION_SIZE * REGION_SIZE;
+		static constexpr uint32_t MAGIC = 0x47525856;	// "VXRG"
+		static constexpr uint16_t VERSION = 2;
+		static constexpr const char* EXTENSION = ".vxr";
+		/// @brief Largest blob `Write` accepts, `Read` rejects table entries claiming more.
+		/// A serialized chunk takes about 100 KiB plus its material names
+		static constexpr uint32_t MAX_BLOB_SIZE = 1024 * 1024;
+	private:
+		struct Header {
+			uint32_t magic;
+			uint16_t version;
+			uint16_t regionSize;
+		};
+		/// @brief Location and checksum of a blob, `storedSize == rawSize` marks an uncompressed blob
+		struct Entry {
+			uint64_t offset;
+			uint32_t storedSize;
+			uint32_t rawSize;
+			uint32_t checksum;	// CRC-32 of the stored bytes
+			uint32_t reserved;
+		};
+		static constexpr size_t TABLE_OFFSET = sizeof(Header);
+		static constexpr size_t DATA_OFFSET = TABLE_OFFSET + SLOT_COUNT * sizeof(Entry);
+
+		bool LoadTable();
+		/// @brief False for entries no `Write` could have produced, checked before anything is allocated for them
+		static bool IsValidEntry(const Entry &entry) { return entry.storedSize <= entry.rawSize && entry.rawSize <= MAX_BLOB_SIZE; }
+		/// @brief Makes sure the mapping covers the given byte range, remapping after appends
+		const uint8_t* MapRange(uint64_t offset, uint32_t size);
+
+		std::filesystem::path path;
+		MappedFile mapping;
+
+		// copy of the on-disk table, blobs are immutable so only the table changes under the mapping
+		std::array<Entry, SLOT_COUNT> table = {};
+		bool tableLoaded = false;
+	};
+}
@@ -1,5 +1,6 @@
 #include "World/Voxel.h"
 #include "World/ChunkMatrix.h"
+#include "World/VoxelNeighborhood.h"
 #include <algorithm>
 #include <cmath>
 #include <iostream>
@@ -7,134 +8,111 @@
 
 using namespace Volume;
 
-Random Volume::voxelRandomGenerator = Random();
+thread_local constinit Random Volume::voxelRandomGenerator{0};
+// starts above the stamp of new voxels
+std::atomic<uint32_t> VoxelElement::currentUpdateTick = 1;
 
 VoxelElement::VoxelElement()
-	:id("Oxygen")
+	:id(Materials::Oxygen)
 {
-	this->properties = Registry::VoxelRegistry::GetProperties("Oxygen");
+	this->properties = Registry::VoxelRegistry::GetProperties(this->id);
 	this->position = vector::ZERO;
 	this->temperature = Temperature(21);
 }
 
-VoxelElement::VoxelElement(std::string id, Vec2i position, Temperature temperature, float amount)
+VoxelElement::VoxelElement(MaterialID id, Vec2i position, Temperature temperature, float amount)
 	:id(id), position(position), amount(amount)
 {
 	this->properties = Registry::VoxelRegistry::GetProperties(id);
 	this->temperature = temperature;
 
-	this->color = this->properties->pColor;
-
-	if(this->properties->TextureMap){
-		RGBA tint = (*this->properties->TextureMap)(this->position.x, this->position.y);
-		if(tint.a == 0) tint = RGBA(255, 255, 255, 255);
+	this->color = VoxelElement::GetDefaultColor(this->properties, position);
+}
 
-		int8_t alpha = this->color.a;
-		this->color = this->color * tint;
-		this->color.a = alpha;
-	}
-	if(this->properties->RandomColorTints){
-		//tint the color factor 1 to 1.2
-		float factor = Volume::voxelRandomGenerator.GetFloat(1.0f, 1.2f);
-		this->color = RGBA(
-			std::clamp(static_cast<int>(this->color.r * factor), 0, 255),
-			std::clamp(static_cast<int>(this->color.g * factor), 0, 255),
-			std::clamp(static_cast<int>(this->color.b * factor), 0, 255),
-			std::clamp(static_cast<int>(this->color.a), 0, 255)
-		);
-	}
+VoxelElement::VoxelElement(MaterialID id, Vec2i position, Temperature temperature, float amount, State builtinState)
+	:VoxelElement(id, position, temperature, amount)
+{
+	this->flags = VoxelFlags::BUILTIN_CLASS | static_cast<uint8_t>(builtinState);
 }
 
 VoxelElement::~VoxelElement()
 {
 }
 
-std::string Volume::VoxelElement::ShouldTransitionToID()
+MaterialID Volume::VoxelElement::ShouldTransitionToID() const
+{
+	return VoxelElement::GetTransitionID(this->properties, this->temperature);
+}
+
+/// @brief Returns the id a material at the given temperature should transition to, INVALID_MATERIAL_ID if none
+MaterialID Volume::VoxelElement::GetTransitionID(const VoxelProperty *properties, Temperature temperature)
 {
-	float tempC = this->temperature.GetCelsius();
+	float tempC = temperature.GetCelsius();
 
-	if(this->properties->HeatedChange.has_value()){
-		const auto& heated = this->properties->HeatedChange.value();
+	if(properties->HeatedChange.has_value()){
+		const auto& heated = properties->HeatedChange.value();
 		if (tempC > heated.temperatureAt.GetCelsius() + Volume::TEMP_TRANSITION_THRESHOLD)
 		{
 			return heated.to;
 		}
 	}
 
-	if(this->properties->CooledChange.has_value()){
-		const auto& cooled = this->properties->CooledChange.value();
+	if(properties->CooledChange.has_value()){
+		const auto& cooled = properties->CooledChange.value();
 		if (tempC < cooled.temperatureAt.GetCelsius() - Volume::TEMP_TRANSITION_THRESHOLD)
 		{
 			return cooled.to;
 		}
 	}
 
-	return "";
+	return INVALID_MATERIAL_ID;
 }
 
-void VoxelElement::Swap(Vec2i &toSwapPos, ChunkMatrix &matrix)
+/// @brief Color a freshly created voxel of the material gets at the given world position
+/// @note Depends only on the material and position, so compressed chunks can recreate it exactly
+RGBA Volume::VoxelElement::GetDefaultColor(const VoxelProperty *properties, Vec2i position)
 {
-    // Get the pointer to the voxel at the swap position
-    VoxelElement *swapVoxel = matrix.VirtualGetAt(toSwapPos);
-
-    if (!swapVoxel || swapVoxel->id == "Empty") return;
+	RGBA color = properties->pColor;
 
-	//transfer heat between the two voxels
-	float heatDifference = this->temperature.GetCelsius() - swapVoxel->temperature.GetCelsius();
-	float maxHeatTransfer = 500;
-	float heatTransfer = std::clamp(
-		heatDifference * this->properties->heatConductivity * 5,
-		-maxHeatTransfer,
-		maxHeatTransfer
-	);
+	if(properties->TextureMap){
+		RGBA tint = (*properties->TextureMap)(position.x, position.y);
+		if(tint.a == 0) tint = RGBA(255, 255, 255, 255);
 
-	bool anyHeatCapacityZero = this->properties->heatCapacity == 0 || swapVoxel->properties->heatCapacity == 0;
-	
-	if(!anyHeatCapacityZero){
-		this->temperature.SetCelsius(this->temperature.GetCelsius() - heatTransfer / this->properties->heatCapacity);
-		swapVoxel->temperature.SetCelsius(swapVoxel->temperature.GetCelsius() + heatTransfer / swapVoxel->properties->heatCapacity);
+		int8_t alpha = color.a;
+		color = color * tint;
+		color.a = alpha;
 	}
-
-    // Get the position of the current voxel
-    Vec2i tempPos = this->position;
-
-    //flip positions
-    this->position = toSwapPos;
-    swapVoxel->position = tempPos;
-
-    // Swap the current voxel with the one at the swap position
-    matrix.VirtualSetAt_NoDelete(this);
-    matrix.VirtualSetAt_NoDelete(swapVoxel);
-}
-
-void VoxelElement::DieAndReplace(ChunkMatrix &matrix, std::string id)
-{
-	matrix.PlaceVoxelAt(this->position, id, this->temperature, false, this->amount, true);
+	if(properties->RandomColorTints){
+		// hash the position for a stable tint factor of 1 to 1.2
+		uint32_t hash = static_cast<uint32_t>(position.x) * 0x9E3779B1u ^ static_cast<uint32_t>(position.y) * 0x85EBCA77u;
+		hash ^= hash >> 15;
+		hash *= 0x2C1B3C6Du;
+		hash ^= hash >> 12;
+		float factor = 1.0f + static_cast<float>(hash & 0xFFFF) / 65536.0f * 0.2f;
+
+		color = RGBA(
+			std::clamp(static_cast<int>(color.r * factor), 0, 255),
+			std::clamp(static_cast<int>(color.g * factor), 0, 255),
+			std::clamp(static_cast<int>(color.b * factor), 0, 255),
+			std::clamp(static_cast<int>(color.a), 0, 255)
+		);
+	}
+	return color;
 }
 
-bool Volume::VoxelElement::IsMoveableSolid()
+void VoxelElement::Swap(Vec2i &toSwapPos, ChunkMatrix &matrix)
 {
-    if(this->GetState() != State::Solid) return false;
-
-	VoxelSolid *solid = dynamic_cast<VoxelSolid*>(this);
-	if (solid->isStatic) return false;
-
-	return true;
+	VoxelNeighborhood(&matrix, this).SwapWith(toSwapPos);
 }
 
-bool Volume::VoxelElement::IsUnmoveableSolid()
+void VoxelElement::DieAndReplace(ChunkMatrix &matrix, MaterialID id)
 {
-	if(this->GetState() != State::Solid) return false;
-
-	VoxelSolid *solid = dynamic_cast<VoxelSolid*>(this);
-	if (!solid->isStatic) return false;
-
-	return true;
+	matrix.PlaceVoxelAt(this->position, id, this->temperature, false, this->amount, true);
 }
 
 bool Volume::VoxelElement::IsStateBelowDensity(State state, float density) const
 {
-	if (this->GetState() == state && this->properties->Density < density)
+	if (this->GetState() == state && Registry::VoxelRegistry::GetMaterialTable().density[this->id] < density)
 	{
 		return true;
 	}
@@ -143,7 +121,7 @@ bool Volume::VoxelElement::IsStateBelowDensity(State state, float density) const
 
 bool Volume::VoxelElement::IsStateAboveDensity(State state, float density) const
 {
-	if (this->GetState() == state && this->properties->Density > density)
+	if (this->GetState() == state && Registry::VoxelRegistry::GetMaterialTable().density[this->id] > density)
 	{
 		return true;
 	}
@@ -152,77 +130,74 @@ bool Volume::VoxelElement::IsStateAboveDensity(State state, float density) const
 
 bool VoxelSolid::Step(ChunkMatrix *matrix)
 {
-	if(isStatic){
-		updatedThisFrame = true;
+	if(IsStatic()){
+		MarkUpdated();
 		return false;
 	}
 
     //lazy hack to make the chunk its in update in the next cycle
-    if (updatedThisFrame) {
+    if (IsUpdatedThisTick()) {
     	return true;
     }
-    updatedThisFrame = true;
+    MarkUpdated();
+
+	VoxelNeighborhood neighborhood(matrix, this);
 
     //Fall below and if not falling try to move to the sides
 
     //falling down + acceleration + setting isFalling to near voxel handling
-    if (StepAlongDirection(matrix, vector::DOWN, GetAcceleration())) { //if is able to fall down
-    	isFalling = true;
+    if (StepAlongDirection(neighborhood, vector::DOWN, GetAcceleration())) { //if is able to fall down
+    	SetFalling(true);
     	IncrementAcceleration(1);
 
     	//try to set isFalling to true on adjasent voxels - simulates inertia
-    	VoxelElement *left = matrix->VirtualGetAt(this->position + Vec2i(-1, 1));
-    	VoxelElement *right = matrix->VirtualGetAt(this->position + Vec2i(1, 1));
+    	// only moving solids get touched, the dense storage rules out everything else
+    	VoxelProbe leftProbe = neighborhood.Probe(-1, 1);
+    	VoxelProbe rightProbe = neighborhood.Probe(1, 1);
+    	VoxelElement *left = leftProbe.GetState() == State::Solid && !leftProbe.IsStatic() ? neighborhood.Get(-1, 1) : nullptr;
+    	VoxelElement *right = rightProbe.GetState() == State::Solid && !rightProbe.IsStatic() ? neighborhood.Get(1, 1) : nullptr;
     	if (left && left->IsMoveableSolid())
     	{
-    		VoxelSolid *leftMovable = dynamic_cast<VoxelSolid*>(left);
+    		VoxelSolid *leftMovable = left->AsSolid();
     		if ((1 - leftMovable->properties->SolidInertiaResistance) * 1000 > voxelRandomGenerator.GetInt(0, 1000)) {
-    			leftMovable->isFalling = true;
+    			leftMovable->SetFalling(true);
     			leftMovable->XVelocity = 1;
     		}
     	}
     	if (right && right->IsMoveableSolid())
     	{
-    		VoxelSolid *rightMovable = dynamic_cast<VoxelSolid*>(right);
+    		VoxelSolid *rightMovable = right->AsSolid();
     		if ((1 - rightMovable->properties->SolidInertiaResistance) * 1000 > voxelRandomGenerator.GetInt(0, 1000)) {
-    			rightMovable->isFalling = true;
+    			rightMovable->SetFalling(true);
     			rightMovable->XVelocity = 1;
     		}
     	}
 
     	return true;
     }
-    else if (isFalling) { //On the frame of the impact
+    else if (IsFalling()) { //On the frame of the impact
     	StopFalling();
     	//If the voxel below is a solid, try to move to the sides
 
-    	if (StepAlongDirection(matrix, Vec2i(-1, 1), 1)){
-			TryToMoveVoxelBelow(matrix);
+    	if (StepAlongDirection(neighborhood, Vec2i(-1, 1), 1)){
+			TryToMoveVoxelBelow(neighborhood);
 			return true;
 		}
-    	if (StepAlongDirection(matrix, Vec2i(1, 1), 1)){
-			TryToMoveVoxelBelow(matrix);
+    	if (StepAlongDirection(neighborhood, Vec2i(1, 1), 1)){
+			TryToMoveVoxelBelow(neighborhood);
 			return true;
 		}
-    	if (StepAlongDirection(matrix, vector::LEFT, XVelocity)){
-			TryToMoveVoxelBelow(matrix);
+    	if (StepAlongDirection(neighborhood, vector::LEFT, XVelocity)){
+			TryToMoveVoxelBelow(neighborhood);
 			return true;
 		}
-    	if (StepAlongDirection(matrix, vector::RIGHT, XVelocity)){
-			TryToMoveVoxelBelow(matrix);
+    	if (StepAlongDirection(neighborhood, vector::RIGHT, XVelocity)){
+			TryToMoveVoxelBelow(neighborhood);
 			return true;
 		}
 
 
-		VoxelElement *below = matrix->VirtualGetAt(this->position + vector::DOWN);
-    	if (below && below->IsMoveableSolid())
-    	{
-    		VoxelSolid *belowMovable = dynamic_cast<VoxelSolid*>(below);
-    		if ((1 - belowMovable->properties->SolidInertiaResistance) * 1000 > voxelRandomGenerator.GetInt(0, 1000)) {
-    			belowMovable->isFalling = true;
-    			belowMovable->XVelocity = 1;
-    		}
-    	}
+		TryToMoveVoxelBelow(neighborhood);
 
     	XVelocity = 0;
     }
@@ -231,38 +206,41 @@ bool VoxelSolid::Step(ChunkMatrix *matrix)
     return false;
 }
 
-bool VoxelSolid::StepAlongDirection(ChunkMatrix *matrix, Vec2i direction, short int length)
+bool VoxelSolid::StepAlongDirection(VoxelNeighborhood &neighborhood, Vec2i direction, short int length)
 {
-    VoxelElement* side = matrix->VirtualGetAt(this->position + direction);
-    if (side && Registry::VoxelRegistry::CanBeMovedBySolid(side->GetState()))
+    VoxelProbe side = neighborhood.Probe(direction.x, direction.y);
+    if (side.Exists() && Registry::VoxelRegistry::CanBeMovedBySolid(side.GetState()))
     {
-    	Vec2i sidePos = side->position;
+    	int distance = 1;
     	for (short int i = 0; i < length; ++i)
     	{
-    		sidePos += direction;
-    		side = matrix->VirtualGetAt(sidePos);
-    		if (!side || (side->GetState() != State::Gas))
+    		++distance;
+    		side = neighborhood.Probe(direction.x * distance, direction.y * distance);
+    		if (!side.Exists() || (side.GetState() != State::Gas))
     		{
-    			sidePos -= direction;
-    			this->Swap(sidePos, *matrix);
+    			--distance;
+    			neighborhood.Swap(direction.x * distance, direction.y * distance);
     			return true;
     		}
     	}
-    	this->Swap(sidePos, *matrix);
+    	neighborhood.Swap(direction.x * distance, direction.y * distance);
     	return true;
     }
     return false;
 }
 
-void VoxelSolid::TryToMoveVoxelBelow(ChunkMatrix *matrix)
+void VoxelSolid::TryToMoveVoxelBelow(VoxelNeighborhood &neighborhood)
 {
 	//try to set isFalling to true on voxel below - simulates inertia
-    VoxelElement* below = matrix->VirtualGetAt(this->position + vector::DOWN);
+    VoxelProbe belowProbe = neighborhood.Probe(0, 1);
+    if (belowProbe.GetState() != State::Solid || belowProbe.IsStatic()) return;
+
+    VoxelElement* below = neighborhood.Get(0, 1);
     if (below && below->IsMoveableSolid())
     {
-    	VoxelSolid* belowMovable = dynamic_cast<VoxelSolid*>(below);
+    	VoxelSolid* belowMovable = below->AsSolid();
     	if ((1 - belowMovable->properties->SolidInertiaResistance) * 1000 > voxelRandomGenerator.GetInt(0, 1000)) {
-    		belowMovable->isFalling = true;
+    		belowMovable->SetFalling(true);
     		belowMovable->XVelocity = 1;
     	}
     }
@@ -270,7 +248,7 @@ void VoxelSolid::TryToMoveVoxelBelow(ChunkMatrix *matrix)
 
 bool Volume::VoxelSolid::IsSolidCollider() const
 {
-	if (isFalling) return false;
+	if (IsFalling()) return false;
 	
 	return true;
 }
@@ -278,202 +256,200 @@ bool Volume::VoxelSolid::IsSolidCollider() const
 void VoxelSolid::StopFalling()
 {
     XVelocity = ((GetAcceleration() / 6) / voxelRandomGenerator.GetInt(1, 2)) + 1;
-    isFalling = false;
+    SetFalling(false);
     SetAcceleration(1);
 }
 
 bool VoxelLiquid::Step(ChunkMatrix *matrix)
 {
     //lazy hack to make the chunk its in update in the next cycle
-    if (updatedThisFrame) {
+    if (IsUpdatedThisTick()) {
     	return true;
     }
 
-    updatedThisFrame = true;
+    MarkUpdated();
+
+	VoxelNeighborhood neighborhood(matrix, this);
 
     //falling down + acceleration
-    if (StepAlongDirection(matrix, vector::DOWN, GetAcceleration())) {
-    	isFalling = true;
+    if (StepAlongDirection(neighborhood, vector::DOWN, GetAcceleration())) {
+    	SetFalling(true);
 		IncrementAcceleration(1);
     	return true;
     }
-    else if (isFalling) { //On the frame of the impact (stops falling)
-    	isFalling = false;
+    else if (IsFalling()) { //On the frame of the impact (stops falling)
+    	SetFalling(false);
 		SetAcceleration(1);
     }
 
-	VoxelElement* above = matrix->VirtualGetAt(this->position + vector::UP);
+	VoxelElement* above = neighborhood.Get(0, -1);
 	
 	// if the liquid is above its avalible density, expand
 	if(this->amount > VoxelLiquid::DesiredAmount){
 		if(above && above->GetState() == State::Gas){
 			matrix->PlaceVoxelAt(this->position+vector::UP, this->id, this->temperature, false, this->amount/2, false);
 
-			Chunk *chunk = matrix->GetChunkAtWorldPosition(this->position);
+			Chunk *chunk = neighborhood.GetChunk(0, 0);
 			chunk->SetPressureAt(this->position, this->amount/2);
 			return true;
 		}else if(above && above->properties == this->properties){
 			float missingAmount = std::max(VoxelLiquid::DesiredAmount - above->amount, 0.0f);
 			float transferAmount = std::min(missingAmount, this->amount);
 
-			Chunk *chunk = matrix->GetChunkAtWorldPosition(this->position);
-			Chunk *chunkUP = matrix->GetChunkAtWorldPosition(this->position + vector::UP);
+			Chunk *chunk = neighborhood.GetChunk(0, 0);
+			Chunk *chunkUP = neighborhood.GetChunk(0, -1);
 			
 			chunk->SetPressureAt(this->position, this->amount - transferAmount);
 			chunkUP->SetPressureAt(this->position + vector::UP, above->amount + transferAmount);
 
 			if(missingAmount > 0.0f){
 				Vec2i localPos = Vec2i(this->position.x % Chunk::CHUNK_SIZE, this->position.y % Chunk::CHUNK_SIZE);
-				matrix->GetChunkAtWorldPosition(this->position)->dirtyRect.Include(localPos);
+				chunk->dirtyTiles.Include(localPos);
 				return true;
 			}
 		}
 	}
 
-	VoxelElement* below = matrix->VirtualGetAt(this->position + Vec2i(0, 1));
+	VoxelElement* below = neighborhood.Get(0, 1);
 	if(below && below->GetState() == State::Liquid && below->properties == this->properties){
 		if(below->amount < VoxelLiquid::DesiredAmount){
 			float missingAmount = VoxelLiquid::DesiredAmount - below->amount;
 			float transferAmount = std::min(missingAmount, this->amount);
 
-			Chunk *chunk = matrix->GetChunkAtWorldPosition(this->position);
-			Chunk *chunkBelow = matrix->GetChunkAtWorldPosition(this->position + vector::DOWN);
+			Chunk *chunk = neighborhood.GetChunk(0, 0);
+			Chunk *chunkBelow = neighborhood.GetChunk(0, 1);
 
 			chunk->SetPressureAt(this->position, this->amount - transferAmount);
 			chunkBelow->SetPressureAt(this->position + vector::DOWN, below->amount + transferAmount);
 
 			if(this->amount <= 0){
-				if(above->GetState() == State::Gas){
+				if(above && above->GetState() == State::Gas){
 					DieAndReplace(*matrix, above->id);
 					return true;
 				}else{
-					DieAndReplace(*matrix, "Empty");
+					DieAndReplace(*matrix, Materials::Empty);
 					return true;
 				}
 			}
 			Vec2i localPos = Vec2i(this->position.x % Chunk::CHUNK_SIZE, this->position.y % Chunk::CHUNK_SIZE);
 			
-			matrix->GetChunkAtWorldPosition(this->position)->dirtyRect.Include(localPos);
+			chunk->dirtyTiles.Include(localPos);
 			return true;
 		}
 	}
 
     //If the voxel below is a solid, try to move to the bottom left and bottom right
-    VoxelElement* left = matrix->VirtualGetAt(this->position + Vec2i(-1, 1));
-    VoxelElement* right = matrix->VirtualGetAt(this->position + Vec2i(1, 1));
-    if (left && (Registry::VoxelRegistry::CanBeMovedByLiquid(left->GetState()) || left->IsStateBelowDensity(this->GetState(), this->properties->Density)))
+    VoxelProbe left = neighborhood.Probe(-1, 1);
+    VoxelProbe right = neighborhood.Probe(1, 1);
+    if (left.Exists() && (Registry::VoxelRegistry::CanBeMovedByLiquid(left.GetState()) || left.IsStateBelowDensity(this->GetState(), this->properties->Density)))
     {
-    	this->Swap(left->position, *matrix);
+    	neighborhood.Swap(-1, 1);
     	return true;
     }
-    else if (right && (Registry::VoxelRegistry::CanBeMovedByLiquid(right->GetState()) || right->IsStateBelowDensity(this->GetState(), this->properties->Density)))
+    else if (right.Exists() && (Registry::VoxelRegistry::CanBeMovedByLiquid(right.GetState()) || right.IsStateBelowDensity(this->GetState(), this->properties->Density)))
     {
-    	this->Swap(right->position, *matrix);
+    	neighborhood.Swap(1, 1);
     	return true;
     }
 
     //if there is the same liquid voxel above, skip
-    VoxelElement* moreAbove = matrix->VirtualGetAt(this->position + (vector::UP * 2));
-    if (above && above->properties == this->properties && moreAbove && moreAbove->properties == this->properties)
+    if (above && above->id == this->id && neighborhood.Probe(0, -2).material == this->id)
     	return false;
 
-    Vec2i MovePosition = GetValidSideSwapPosition(*matrix, this->properties->FluidDispursionRate);
+    Vec2i MovePosition = GetValidSideSwapPosition(neighborhood, this->properties->FluidDispursionRate);
     if (MovePosition != this->position) {
-    	this->Swap(MovePosition, *matrix);
+    	neighborhood.SwapWith(MovePosition);
     	return true;
     }
     //if pixel have not found a place to move to return false
     return false;
 }
 
-bool VoxelLiquid::StepAlongDirection(ChunkMatrix *matrix, Vec2i direction, short int length)
+bool VoxelLiquid::StepAlongDirection(VoxelNeighborhood &neighborhood, Vec2i direction, short int length)
 {
-    VoxelElement* next = matrix->VirtualGetAt(this->position + direction);
-    if (next && (Registry::VoxelRegistry::CanBeMovedByLiquid(next->GetState()) || next->IsStateBelowDensity(this->GetState(), this->properties->Density)))
+    VoxelProbe next = neighborhood.Probe(direction.x, direction.y);
+    if (next.Exists() && (Registry::VoxelRegistry::CanBeMovedByLiquid(next.GetState()) || next.IsStateBelowDensity(this->GetState(), this->properties->Density)))
     {
-    	Vec2i nextPos = next->position;
+    	int distance = 1;
     	for (short int i = 0; i < length; ++i)
     	{
-    		nextPos += direction;
-    		next = matrix->VirtualGetAt(nextPos);
+    		++distance;
+    		next = neighborhood.Probe(direction.x * distance, direction.y * distance);
 			//if the next voxel is a solid, stop
-    		if (!next || !(Registry::VoxelRegistry::CanBeMovedByLiquid(next->GetState()) || next->IsStateBelowDensity(this->GetState(), this->properties->Density)))
+    		if (!next.Exists() || !(Registry::VoxelRegistry::CanBeMovedByLiquid(next.GetState()) || next.IsStateBelowDensity(this->GetState(), this->properties->Density)))
     		{
-    			nextPos -= direction;
-    			this->Swap(nextPos, *matrix);
+    			--distance;
+    			neighborhood.Swap(direction.x * distance, direction.y * distance);
     			return true;
     		}
     	}
-    	this->Swap(nextPos, *matrix);
+    	neighborhood.Swap(direction.x * distance, direction.y * distance);
     	return true;
     }
     return false;
 }
 
-Vec2i VoxelLiquid::GetValidSideSwapPosition(ChunkMatrix &matrix, short int length)
+Vec2i VoxelLiquid::GetValidSideSwapPosition(VoxelNeighborhood &neighborhood, short int length)
 {
-    Vec2i LastValidPosition = this->position;
-    Vec2i StartPosition = this->position;
-    Vec2i CurrentPosition = this->position;
+    int lastValidOffset = 0;
 
     //try to move to the sides
-    for (short int i = 0; i < length; ++i)
+    for (short int i = 1; i <= length; ++i)
     {
-    	CurrentPosition += vector::LEFT;
-    	VoxelElement* side = matrix.VirtualGetAt(CurrentPosition);
-    	if (!side) break;
+    	VoxelProbe side = neighborhood.Probe(-i, 0);
+    	if (!side.Exists()) break;
 		
-		if (side->GetState() == State::Solid) break;
-    	if (Registry::VoxelRegistry::CanBeMovedByLiquid(side->GetState()) || side->IsStateBelowDensity(this->GetState(), this->properties->Density))
+		if (side.GetState() == State::Solid) break;
+    	if (Registry::VoxelRegistry::CanBeMovedByLiquid(side.GetState()) || side.IsStateBelowDensity(this->GetState(), this->properties->Density))
 		{
-			LastValidPosition = CurrentPosition;
+			lastValidOffset = -i;
 		}
     }
-    if (LastValidPosition != StartPosition) return LastValidPosition;
-    CurrentPosition = StartPosition;
-    for (short int i = 0; i < length; ++i)
+    if (lastValidOffset != 0) return this->position + Vec2i(lastValidOffset, 0);
+    for (short int i = 1; i <= length; ++i)
     {
-    	CurrentPosition += vector::RIGHT;
-    	VoxelElement* side = matrix.VirtualGetAt(CurrentPosition);
-    	if (!side) break;
+    	VoxelProbe side = neighborhood.Probe(i, 0);
+    	if (!side.Exists()) break;
 		
-    	if (side->GetState() == State::Solid) break;
-    	if (Registry::VoxelRegistry::CanBeMovedByLiquid(side->GetState()) || side->IsStateBelowDensity(this->GetState(), this->properties->Density))
+    	if (side.GetState() == State::Solid) break;
+    	if (Registry::VoxelRegistry::CanBeMovedByLiquid(side.GetState()) || side.IsStateBelowDensity(this->GetState(), this->properties->Density))
     	{
-    		LastValidPosition = CurrentPosition;
+    		lastValidOffset = i;
     	}
     }
-    return LastValidPosition;
+    return this->position + Vec2i(lastValidOffset, 0);
 }
 
-Volume::VoxelGas::VoxelGas(std::string id, Vec2i position, Temperature temp, float amount)
-: VoxelElement(id, position, temp, amount)
+Volume::VoxelGas::VoxelGas(MaterialID id, Vec2i position, Temperature temp, float amount)
+: VoxelElement(id, position, temp, amount, State::Gas)
 {
 }
 
 bool VoxelGas::Step(ChunkMatrix *matrix)
 {
     //lazy hack to make the chunk its in update in the next cycle
-    if (updatedThisFrame) {
+    if (IsUpdatedThisTick()) {
     	return true;
     }
-    updatedThisFrame = true;
+    MarkUpdated();
 
 	// Create vacuum in low enough amounts
 	if(this->amount < VoxelGas::MinimumGasAmount){
-		this->DieAndReplace(*matrix, "Empty");
+		this->DieAndReplace(*matrix, Materials::Empty);
 		return true;
 	}
 
+	VoxelNeighborhood neighborhood(matrix, this);
+
 	//look around and try to spread based on pressure
 	for(Vec2i dir : vector::AROUND4){
-		VoxelElement* next = matrix->VirtualGetAt(this->position + dir);
-		if(next && next->GetState() == State::Gas && this->properties != next->properties){
-			float nextAmount = next->amount;
+		VoxelProbe probe = neighborhood.Probe(dir.x, dir.y);
+		if(probe.GetState() == State::Gas && probe.Exists() && probe.material != this->id){
+			float nextAmount = neighborhood.Get(dir.x, dir.y)->amount;
 			if(this->amount - nextAmount > 0.3f){
 				// small amount of gas deletion happens.. no idea why
 				if(matrix->TryToDisplaceGas(this->position + dir, this->id, this->temperature, this->amount - nextAmount, false)){
-					Chunk *chunk = matrix->GetChunkAtWorldPosition(this->position);
+					Chunk *chunk = neighborhood.GetChunk(0, 0);
 					chunk->SetPressureAt(this->position, nextAmount);
 					break;
 				}
@@ -482,71 +458,71 @@ bool VoxelGas::Step(ChunkMatrix *matrix)
 	}
 
 	//try to move up
-	if (MoveInDirection(matrix, vector::UP))
+	if (MoveInDirection(neighborhood, vector::UP))
 		return true;
 	//try to fall down
-	if (MoveInDirection(matrix, vector::DOWN))
+	if (MoveInDirection(neighborhood, vector::DOWN))
 		return true;
 
 	//try to randomly move to the sides
 	Vec2i direction = voxelRandomGenerator.GetBool() ? vector::RIGHT : vector::LEFT;
-	if(MoveInDirection(matrix, direction))
+	if(MoveInDirection(neighborhood, direction))
 		return true;
 
     return false;
 }
 
-bool Volume::VoxelGas::MoveInDirection(ChunkMatrix *matrix, Vec2i direction)
+bool Volume::VoxelGas::MoveInDirection(VoxelNeighborhood &neighborhood, Vec2i direction)
 {
-    VoxelElement* next = matrix->VirtualGetAt_NoLoad(this->position + direction); // gasses cannot load new chunks
+    VoxelProbe next = neighborhood.Probe_NoLoad(direction.x, direction.y); // gasses cannot load new chunks
 
-	if(next == nullptr) return false; // if the next voxel is null, stop
+	if(!next.Exists()) return false; // if the next voxel is null, stop
 
-	if(next->properties == this->properties) return false; // if the next voxel is the same, stop
+	if(next.material == this->id) return false; // if the next voxel is the same, stop
 	
-	if(next->GetState() != State::Gas) return false; // if the next voxel is not gas, stop
+	if(next.GetState() != State::Gas) return false; // if the next voxel is not gas, stop
 	
 	if(direction.y > 0){
 		// down
-		if(next->IsStateBelowDensity(this->GetState(), this->properties->Density) && !next->updatedThisFrame){
-			this->Swap(next->position, *matrix);
+		if(next.IsStateBelowDensity(this->GetState(), this->properties->Density) && !neighborhood.Get_NoLoad(direction.x, direction.y)->IsUpdatedThisTick()){
+			neighborhood.Swap(direction.x, direction.y);
 			return true;
 		}
 	}else if(direction.y < 0){
 		// up
-		if(next->IsStateAboveDensity(this->GetState(), this->properties->Density)){
-			this->Swap(next->position, *matrix);
+		if(next.IsStateAboveDensity(this->GetState(), this->properties->Density)){
+			neighborhood.Swap(direction.x, direction.y);
 			return true;
 		}
 	}else{
 		// sides
-		this->StepAlongSide(matrix, direction.x > 0, this->properties->FluidDispursionRate);
+		this->StepAlongSide(neighborhood, direction.x > 0, this->properties->FluidDispursionRate);
 		return true;
 	}
     
     return false;
 }
 
-bool Volume::VoxelGas::StepAlongSide(ChunkMatrix *matrix, bool positiveX, short int length)
+bool Volume::VoxelGas::StepAlongSide(VoxelNeighborhood &neighborhood, bool positiveX, short int length)
 {
-	Vec2i direction = positiveX ? vector::RIGHT : vector::LEFT;
-    VoxelElement* next = matrix->VirtualGetAt(this->position + direction);
-    if (next && next->GetState() == State::Gas && next->properties != this->properties)
+	const int direction = positiveX ? 1 : -1;
+    VoxelProbe next = neighborhood.Probe(direction, 0);
+    if (next.Exists() && next.GetState() == State::Gas && next.material != this->id)
     {
-    	Vec2i nextPos = next->position;
+    	int distance = 1;
     	for (short int i = 0; i < length; ++i)
     	{
-    		nextPos += direction;
-    		next = matrix->VirtualGetAt(nextPos);
+    		++distance;
+    		next = neighborhood.Probe(direction * distance, 0);
 			//if the next voxel is a solid, stop
-    		if (next && (next->GetState() != State::Gas || next->properties == this->properties))
+    		if (next.Exists() && (next.GetState() != State::Gas || next.material == this->id))
     		{
-    			nextPos -= direction;
-    			this->Swap(nextPos, *matrix);
+    			--distance;
+    			neighborhood.Swap(direction * distance, 0);
     			return true;
     		}
     	}
-    	this->Swap(nextPos, *matrix);
+    	neighborhood.Swap(direction * distance, 0);
     	return true;
     }
     return false;
@@ -3,16 +3,22 @@
 #include <map>
 #include <vector>
 #include <memory>
+#include <utility>
+#include <atomic>
 #include <GL/glew.h>
 #include "Math/Vector.h"
 #include "Registry/VoxelRegistry.h"
 #include "Math/Random.h"
+#include "World/VoxelAllocator.h"
 
 // Forward declaration of ChunkMatrix
 class ChunkMatrix;
 
 namespace Volume {
-	extern Random voxelRandomGenerator;
+	class VoxelNeighborhood;
+
+	/// @brief Random stream of the calling thread, the simulation reseeds it per chunk (`ChunkMatrix::SeedVoxelRandom`)
+	extern thread_local constinit Random voxelRandomGenerator;
 
 	struct VoxelHeatData{
 		float temperature;
@@ -26,6 +32,18 @@ namespace Volume {
 
 	static constexpr float VOXEL_SIZE_METERS = 0.125f;
 
+	/// @brief Bits of the per-voxel flags byte (`VoxelElement::GetFlags` and `ChunkVoxelStorage::flags`).
+	/// The lowest two bits hold the `Volume::State`
+	namespace VoxelFlags {
+		static constexpr uint8_t STATE_MASK		= 0b11;
+		static constexpr uint8_t STATIC			= 1 << 2;
+		static constexpr uint8_t PART_OF_OBJECT	= 1 << 3;
+		static constexpr uint8_t SOLID_COLLIDER	= 1 << 4; // only set in ChunkVoxelStorage
+		static constexpr uint8_t FALLING		= 1 << 5;
+		// the voxel derives from the built-in class matching the state bits (VoxelSolid, VoxelLiquid or VoxelGas)
+		static constexpr uint8_t BUILTIN_CLASS	= 1 << 6;
+	}
+
 	//Interfaces
 	class IGravity {
 	public:
@@ -33,46 +51,75 @@ namespace Volume {
 		short int GetAcceleration() const { return Acceleration; };
 		void SetAcceleration(short int acceleration);
 		void IncrementAcceleration(short int amount);
-		bool isFalling = false;
 	private:
 		short int Acceleration = 1;
 		static constexpr short int MAX_ACCELERATION = 10;
 	};
 
+	class VoxelSolid;
+
 	//Base class for all voxel elements
 	class VoxelElement
 	{
 	public:
 		VoxelElement();
-		VoxelElement(std::string id, Vec2i position, Temperature temperature, float amount);
+		VoxelElement(MaterialID id, Vec2i position, Temperature temperature, float amount);
 		virtual ~VoxelElement();
 
-		const std::string id;
+		// All voxels (including custom factory ones) live in the pooled VoxelAllocator,
+		// plain `new` uses the size class pools, `NewVoxel` the pool of the voxel type
+		static void* operator new(size_t size) { return VoxelAllocator::Allocate(size); }
+		static void* operator new(size_t size, VoxelAllocator::PoolID pool) { return VoxelAllocator::Allocate(size, pool); }
+		static void operator delete(void *ptr, size_t size) { VoxelAllocator::Free(ptr, size); }
+		// only called if a constructor throws inside `new (pool) T(...)`, the block goes back to its pool
+		static void operator delete(void *ptr, VoxelAllocator::PoolID pool) { VoxelAllocator::FreeToPool(ptr, pool); }
+
+		const MaterialID id;
 		const VoxelProperty* properties = nullptr;
 		// world space position
 		Vec2i position;
 		RGBA color;
 		Temperature temperature;
-		bool updatedThisFrame = false;
-
-		bool partOfObject = false;
 
 		float amount;
 
+		/// @brief Returns the flags byte, see `Volume::VoxelFlags`
+		uint8_t GetFlags() const { return flags; }
+
+		bool IsPartOfObject() const { return flags & VoxelFlags::PART_OF_OBJECT; }
+		void SetPartOfObject(bool value) { SetFlag(VoxelFlags::PART_OF_OBJECT, value); }
+		bool IsFalling() const { return flags & VoxelFlags::FALLING; }
+		void SetFalling(bool value) { SetFlag(VoxelFlags::FALLING, value); }
+
+		/// @brief True once the voxel was stepped in the current simulation tick
+		bool IsUpdatedThisTick() const { return updatedTick == currentUpdateTick.load(std::memory_order_relaxed); }
+		void MarkUpdated() { updatedTick = currentUpdateTick.load(std::memory_order_relaxed); }
+		/// @brief Starts a new simulation tick, every voxel counts as not updated afterwards
+		/// @note Called by the engine before the chunks are updated, no voxel has to be touched
+		static void AdvanceUpdateTick() { currentUpdateTick.fetch_add(1, std::memory_order_relaxed); }
+
 		// Functions
 		/// @brief return the state of the element
 		virtual State GetState() const { return State::Gas; };
 		/// @brief Should return true if the voxel moved or needs to be updated next frame 
-		virtual bool Step(ChunkMatrix* matrix) { updatedThisFrame = true; return false; };
-		/// @brief return the id of the voxel that this voxel should transition to, empty string if no transition
-		std::string ShouldTransitionToID();
+		virtual bool Step(ChunkMatrix* matrix) { MarkUpdated(); return false; };
+		/// @brief return the id of the voxel that this voxel should transition to, INVALID_MATERIAL_ID if no transition
+		MaterialID ShouldTransitionToID() const;
+		static MaterialID GetTransitionID(const VoxelProperty *properties, Temperature temperature);
+
+		static RGBA GetDefaultColor(const VoxelProperty *properties, Vec2i position);
 
 		// Swap the voxel with another voxel
 		void Swap(Vec2i& toSwapPos,ChunkMatrix& matrix);
-		void DieAndReplace(ChunkMatrix &matrix, std::string id);
+		void DieAndReplace(ChunkMatrix &matrix, MaterialID id);
+
+		/// @brief Returns this voxel as a VoxelSolid or nullptr if it does not derive from it
+		/// @note Checks the flags byte and uses static_cast, so it is cheap enough for the simulation hot path
+		VoxelSolid* AsSolid();
+		const VoxelSolid* AsSolid() const;
 
-		bool IsMoveableSolid();
-		bool IsUnmoveableSolid();
+		bool IsMoveableSolid() const { return IsBuiltinSolid() && !(flags & VoxelFlags::STATIC); }
+		bool IsUnmoveableSolid() const { return IsBuiltinSolid() && (flags & VoxelFlags::STATIC); }
 
 		/// @brief Returns true if the voxels should trigger dirty colliders when moving
 		virtual bool ShouldTriggerDirtyColliders() const { return false; };
@@ -80,22 +127,38 @@ namespace Volume {
 
 		bool IsStateBelowDensity(State state, float density) const;
 		bool IsStateAboveDensity(State state, float density) const;
+	protected:
+		/// @brief Used by the built-in voxel classes to tag themselves in the flags byte
+		VoxelElement(MaterialID id, Vec2i position, Temperature temperature, float amount, State builtinState);
+
+		void SetFlag(uint8_t flag, bool value) { flags = value ? (flags | flag) : (flags & ~flag); }
+	private:
+		static constexpr uint8_t BUILTIN_SOLID = VoxelFlags::BUILTIN_CLASS | static_cast<uint8_t>(State::Solid);
+		bool IsBuiltinSolid() const { return (flags & (VoxelFlags::BUILTIN_CLASS | VoxelFlags::STATE_MASK)) == BUILTIN_SOLID; }
+
+		uint8_t flags = 0;
+		uint32_t updatedTick = 0;	// value of currentUpdateTick when last stepped
+
+		static std::atomic<uint32_t> currentUpdateTick;
 	};
 
 	//Solid Voxels -> inherit from base voxel class
 	class VoxelSolid : public VoxelElement, public IGravity {
 	public:
-		VoxelSolid() : VoxelElement("Dirt" , vector::ZERO, Temperature(21), 1) {};
-		VoxelSolid(std::string id, Vec2i position, Temperature temp, bool isStatic, float amount) : VoxelElement(id, position, temp, amount), isStatic(isStatic) {};
+		VoxelSolid(MaterialID id, Vec2i position, Temperature temp, bool isStatic, float amount) 
+			: VoxelElement(id, position, temp, amount, State::Solid) { SetStatic(isStatic); };
 		~VoxelSolid() {};
 		
-		bool isStatic;
+		/// @brief Static solids don't move (like the ground), moving ones fall like sand
+		bool IsStatic() const { return GetFlags() & VoxelFlags::STATIC; }
+		void SetStatic(bool value) { SetFlag(VoxelFlags::STATIC, value); }
+
 		short unsigned int XVelocity = 0;     // 0 - short unsigned int max
 
 		State GetState() const override { return State::Solid; };
 		bool Step(ChunkMatrix* matrix) override;
-		bool StepAlongDirection(ChunkMatrix* matrix, Vec2i direction, short int length);
-		void TryToMoveVoxelBelow(ChunkMatrix* matrix);
+		bool StepAlongDirection(VoxelNeighborhood &neighborhood, Vec2i direction, short int length);
+		void TryToMoveVoxelBelow(VoxelNeighborhood &neighborhood);
 
 		bool ShouldTriggerDirtyColliders() const override { return true; };
 		bool IsSolidCollider() const override;
@@ -106,14 +169,13 @@ namespace Volume {
 	//liquid voxels -> inherit from base voxel class
 	class VoxelLiquid : public VoxelElement, public IGravity {
 	public:
-		VoxelLiquid() : VoxelElement("Water", vector::ZERO, Temperature(21), 1) {};
-		VoxelLiquid(std::string id, Vec2i position, Temperature temp, float amount) : VoxelElement(id, position, temp, amount) {};
+		VoxelLiquid(MaterialID id, Vec2i position, Temperature temp, float amount) : VoxelElement(id, position, temp, amount, State::Liquid) {};
 		~VoxelLiquid() {};
 
 		State GetState() const override { return State::Liquid; };
 		bool Step(ChunkMatrix* matrix) override;
-		bool StepAlongDirection(ChunkMatrix* matrix, Vec2i direction, short int length);
-		Vec2i GetValidSideSwapPosition(ChunkMatrix& matrix, short int length);
+		bool StepAlongDirection(VoxelNeighborhood &neighborhood, Vec2i direction, short int length);
+		Vec2i GetValidSideSwapPosition(VoxelNeighborhood &neighborhood, short int length);
 	private:
 		static constexpr uint16_t DesiredAmount = 20;
 	};
@@ -123,15 +185,30 @@ namespace Volume {
 	public:
 		static constexpr double MinimumGasAmount = 1e-7f;
 
-		VoxelGas() : VoxelElement("Oxygen", vector::ZERO, Temperature(21), 1) {};
-		VoxelGas(std::string id, Vec2i position, Temperature temp, float amount);
+		VoxelGas(MaterialID id, Vec2i position, Temperature temp, float amount);
 		~VoxelGas() {};
 
 		State GetState() const override { return State::Gas; };
 		bool Step(ChunkMatrix* matrix) override;
-		bool StepAlongSide(ChunkMatrix *matrix, bool positiveX, short int length);
-		bool MoveInDirection(ChunkMatrix* matrix, Vec2i direction);
+		bool StepAlongSide(VoxelNeighborhood &neighborhood, bool positiveX, short int length);
+		bool MoveInDirection(VoxelNeighborhood &neighborhood, Vec2i direction);
 	};
 
+	inline VoxelSolid* VoxelElement::AsSolid()
+	{
+		return IsBuiltinSolid() ? static_cast<VoxelSolid*>(this) : nullptr;
+	}
+	inline const VoxelSolid* VoxelElement::AsSolid() const
+	{
+		return IsBuiltinSolid() ? static_cast<const VoxelSolid*>(this) : nullptr;
+	}
+
+	/// @brief Allocates a voxel from the pool of its type, use it in voxel factories
+	template<typename T, typename... Args>
+	T* NewVoxel(Args&&... args)
+	{
+		return new (VoxelAllocator::PoolOf<T>()) T(std::forward<Args>(args)...);
+	}
+
 	int GetLiquidVoxelPercentile(std::vector<VoxelElement *> voxels);
 }
@@ -0,0 +1,369 @@
+#include "World/VoxelAllocator.h"
+
+#include <atomic>
+#include <mutex>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Debug/Logger.h"
+
+using namespace Volume;
+
+namespace {
+    // blocks moved between a thread cache and the shared pool at once
+    constexpr size_t TRANSFER_BATCH = 256;
+    // a thread cache returns a batch to the shared pool once it holds more than this
+    constexpr size_t THREAD_CACHE_LIMIT = TRANSFER_BATCH * 4;
+    // the first bytes of every slab hold the `SlabHeader`, blocks start after it
+    constexpr size_t SLAB_HEADER_SIZE = VoxelAllocator::BLOCK_ALIGNMENT;
+
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    struct SlabHeader {
+        VoxelAllocator::PoolID pool;
+    };
+    static_assert(sizeof(SlabHeader) <= SLAB_HEADER_SIZE);
+
+    struct Pool {
+        std::mutex mutex;
+        FreeBlock *freeList = nullptr;
+        std::vector<void*> slabs;
+        size_t blockSize = 0;
+    };
+
+    struct ThreadCache;
+
+    struct AllocatorState {
+        Pool pools[VoxelAllocator::MAX_POOLS];
+
+        std::mutex registerMutex;
+        size_t typedPoolCount = 0;
+
+        std::mutex cacheMutex;
+        std::vector<ThreadCache*> threadCaches;
+        uint64_t retiredAllocations = 0;
+        uint64_t retiredFrees = 0;
+
+        std::atomic<uint64_t> systemAllocations = 0;
+        std::atomic<uint64_t> slabCount = 0;
+
+        // blocks over MAX_POOLED_SIZE have no slab header, their sizes are kept here for BlockSizeOf
+        std::mutex systemMutex;
+        std::unordered_map<void*, size_t> systemBlocks;
+
+        AllocatorState()
+        {
+            for(size_t i = 0; i < VoxelAllocator::SIZE_CLASS_COUNT; ++i)
+                pools[i].blockSize = (i + 1) * VoxelAllocator::BLOCK_ALIGNMENT;
+        }
+    };
+
+    AllocatorState &State()
+    {
+        // never destroyed, voxels may still be freed while statics are torn down
+        static AllocatorState *state = new AllocatorState();
+        return *state;
+    }
+
+    VoxelAllocator::PoolID SizeClassOf(size_t size)
+    {
+        return static_cast<VoxelAllocator::PoolID>((size + VoxelAllocator::BLOCK_ALIGNMENT - 1) / VoxelAllocator::BLOCK_ALIGNMENT - 1);
+    }
+
+    /// @brief Pool of a block, read from the header of the slab it lives in
+    VoxelAllocator::PoolID PoolOfBlock(const void *ptr)
+    {
+        uintptr_t slab = reinterpret_cast<uintptr_t>(ptr) & ~(static_cast<uintptr_t>(VoxelAllocator::SLAB_SIZE) - 1);
+        return reinterpret_cast<const SlabHeader*>(slab)->pool;
+    }
+
+    void *AllocateSystem(size_t size)
+    {
+        AllocatorState &state = State();
+        void *ptr = ::operator new(size);
+        state.systemAllocations.fetch_add(1, std::memory_order_relaxed);
+
+        std::lock_guard<std::mutex> lock(state.systemMutex);
+        state.systemBlocks.emplace(ptr, size);
+        return ptr;
+    }
+
+    void FreeSystem(void *ptr)
+    {
+        AllocatorState &state = State();
+        {
+            std::lock_guard<std::mutex> lock(state.systemMutex);
+            state.systemBlocks.erase(ptr);
+        }
+        ::operator delete(ptr);
+    }
+
+    /// @brief Carves a new slab into blocks and returns them as a linked list
+    /// @warning do not call without locking the pool mutex
+    FreeBlock *AllocateSlab(VoxelAllocator::PoolID poolID)
+    {
+        Pool &pool = State().pools[poolID];
+        const size_t blockCount = (VoxelAllocator::SLAB_SIZE - SLAB_HEADER_SIZE) / pool.blockSize;
+
+        char *slab = static_cast<char*>(::operator new(VoxelAllocator::SLAB_SIZE, std::align_val_t(VoxelAllocator::SLAB_SIZE)));
+        new (slab) SlabHeader{ poolID };
+        pool.slabs.push_back(slab);
+        State().systemAllocations.fetch_add(1, std::memory_order_relaxed);
+        State().slabCount.fetch_add(1, std::memory_order_relaxed);
+
+        FreeBlock *head = nullptr;
+        for(size_t i = blockCount; i-- > 0;){
+            FreeBlock *block = reinterpret_cast<FreeBlock*>(slab + SLAB_HEADER_SIZE + i * pool.blockSize);
+            block->next = head;
+            head = block;
+        }
+        return head;
+    }
+
+    /// @brief Allocation straight from the shared pool, for threads whose cache is already destroyed
+    void *AllocateShared(VoxelAllocator::PoolID poolID)
+    {
+        AllocatorState &state = State();
+        Pool &pool = state.pools[poolID];
+
+        FreeBlock *block;
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            if(!pool.freeList)
+                pool.freeList = AllocateSlab(poolID);
+
+            block = pool.freeList;
+            pool.freeList = block->next;
+        }
+
+        std::lock_guard<std::mutex> lock(state.cacheMutex);
+        state.retiredAllocations++;
+        return block;
+    }
+
+    void FreeShared(void *ptr, VoxelAllocator::PoolID poolID)
+    {
+        AllocatorState &state = State();
+        Pool &pool = state.pools[poolID];
+        {
+            std::lock_guard<std::mutex> lock(pool.mutex);
+            FreeBlock *block = static_cast<FreeBlock*>(ptr);
+            block->next = pool.freeList;
+            pool.freeList = block;
+        }
+
+        std::lock_guard<std::mutex> lock(state.cacheMutex);
+        state.retiredFrees++;
+    }
+
+    struct ThreadCache {
+        FreeBlock *heads[VoxelAllocator::MAX_POOLS] = {};
+        size_t counts[VoxelAllocator::MAX_POOLS] = {};
+
+        // only written by the owning thread, read by GetStats
+        std::atomic<uint64_t> allocations = 0;
+        std::atomic<uint64_t> frees = 0;
+
+        ThreadCache()
+        {
+            AllocatorState &state = State();
+            std::lock_guard<std::mutex> lock(state.cacheMutex);
+            state.threadCaches.push_back(this);
+        }
+
+        ~ThreadCache();
+
+        void Refill(VoxelAllocator::PoolID poolID)
+        {
+            Pool &pool = State().pools[poolID];
+            std::lock_guard<std::mutex> lock(pool.mutex);
+
+            if(!pool.freeList)
+                pool.freeList = AllocateSlab(poolID);
+
+            for(size_t i = 0; i < TRANSFER_BATCH && pool.freeList; ++i){
+                FreeBlock *block = pool.freeList;
+                pool.freeList = block->next;
+
+                block->next = heads[poolID];
+                heads[poolID] = block;
+                counts[poolID]++;
+            }
+        }
+
+        void ReturnToPool(VoxelAllocator::PoolID poolID, size_t count)
+        {
+            Pool &pool = State().pools[poolID];
+            std::lock_guard<std::mutex> lock(pool.mutex);
+
+            for(size_t i = 0; i < count && heads[poolID]; ++i){
+                FreeBlock *block = heads[poolID];
+                heads[poolID] = block->next;
+                counts[poolID]--;
+
+                block->next = pool.freeList;
+                pool.freeList = block;
+            }
+        }
+    };
+
+    thread_local ThreadCache threadCache;
+    // trivially destructible, still readable after `threadCache` is gone. Voxels can be freed after that,
+    // e.g. by thread_local or static destructors running later on the same thread
+    thread_local bool threadCacheDestroyed = false;
+
+    ThreadCache::~ThreadCache()
+    {
+        AllocatorState &state = State();
+        for(size_t i = 0; i < VoxelAllocator::MAX_POOLS; ++i){
+            if(counts[i] > 0) ReturnToPool(static_cast<VoxelAllocator::PoolID>(i), counts[i]);
+        }
+
+        std::lock_guard<std::mutex> lock(state.cacheMutex);
+        state.retiredAllocations += allocations.load(std::memory_order_relaxed);
+        state.retiredFrees += frees.load(std::memory_order_relaxed);
+        std::erase(state.threadCaches, this);
+
+        threadCacheDestroyed = true;
+    }
+}
+
+void *VoxelAllocator::Allocate(size_t size)
+{
+    if(size > MAX_POOLED_SIZE)
+        return AllocateSystem(size);
+    return Allocate(size, SizeClassOf(size));
+}
+
+void *VoxelAllocator::Allocate(size_t size, PoolID poolID)
+{
+    if(size > MAX_POOLED_SIZE)
+        return AllocateSystem(size);
+
+    if(threadCacheDestroyed)
+        return AllocateShared(poolID);
+
+    ThreadCache &cache = threadCache;
+
+    if(!cache.heads[poolID])
+        cache.Refill(poolID);
+
+    FreeBlock *block = cache.heads[poolID];
+    cache.heads[poolID] = block->next;
+    cache.counts[poolID]--;
+
+    cache.allocations.store(cache.allocations.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    return block;
+}
+
+void VoxelAllocator::Free(void *ptr, size_t size)
+{
+    if(!ptr) return;
+
+    if(size > MAX_POOLED_SIZE){
+        FreeSystem(ptr);
+        return;
+    }
+
+    FreeToPool(ptr, PoolOfBlock(ptr));
+}
+
+void VoxelAllocator::FreeToPool(void *ptr, PoolID poolID)
+{
+    if(!ptr) return;
+
+    if(poolID == SYSTEM_POOL){
+        FreeSystem(ptr);
+        return;
+    }
+
+    if(threadCacheDestroyed){
+        FreeShared(ptr, poolID);
+        return;
+    }
+
+    ThreadCache &cache = threadCache;
+
+    FreeBlock *block = static_cast<FreeBlock*>(ptr);
+    block->next = cache.heads[poolID];
+    cache.heads[poolID] = block;
+    cache.counts[poolID]++;
+
+    cache.frees.store(cache.frees.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+    if(cache.counts[poolID] > THREAD_CACHE_LIMIT)
+        cache.ReturnToPool(poolID, TRANSFER_BATCH);
+}
+
+size_t VoxelAllocator::BlockSizeOf(const void *ptr)
+{
+    AllocatorState &state = State();
+    {
+        std::lock_guard<std::mutex> lock(state.systemMutex);
+        auto it = state.systemBlocks.find(const_cast<void*>(ptr));
+        if(it != state.systemBlocks.end()) return it->second;
+    }
+    return state.pools[PoolOfBlock(ptr)].blockSize;
+}
+
+VoxelAllocator::PoolID VoxelAllocator::RegisterPool(size_t blockSize, const char *name)
+{
+    // never pooled, `Allocate` hands these to the system allocator
+    if(blockSize > MAX_POOLED_SIZE) return SYSTEM_POOL;
+
+    AllocatorState &state = State();
+    std::lock_guard<std::mutex> lock(state.registerMutex);
+
+    if(state.typedPoolCount >= MAX_TYPED_POOLS){
+        Debug::LogWarn("Voxel allocator is out of typed pools, " + std::string(name) + " shares its size class pool");
+        return SizeClassOf(blockSize);
+    }
+
+    PoolID poolID = static_cast<PoolID>(SIZE_CLASS_COUNT + state.typedPoolCount++);
+    // keep the blocks aligned like the size class pools do
+    state.pools[poolID].blockSize = (blockSize + BLOCK_ALIGNMENT - 1) / BLOCK_ALIGNMENT * BLOCK_ALIGNMENT;
+    return poolID;
+}
+
+void VoxelAllocator::Reserve(PoolID poolID, size_t count)
+{
+    if(poolID >= MAX_POOLS || count == 0) return;
+
+    Pool &pool = State().pools[poolID];
+    if(pool.blockSize == 0) return;
+
+    const size_t blocksPerSlab = (SLAB_SIZE - SLAB_HEADER_SIZE) / pool.blockSize;
+
+    std::lock_guard<std::mutex> lock(pool.mutex);
+    for(size_t reserved = 0; reserved < count; reserved += blocksPerSlab){
+        FreeBlock *head = AllocateSlab(poolID);
+
+        FreeBlock *tail = head;
+        while(tail->next) tail = tail->next;
+
+        tail->next = pool.freeList;
+        pool.freeList = head;
+    }
+}
+
+VoxelAllocatorStats VoxelAllocator::GetStats()
+{
+    AllocatorState &state = State();
+    VoxelAllocatorStats stats;
+
+    std::lock_guard<std::mutex> lock(state.cacheMutex);
+    stats.allocations = state.retiredAllocations;
+    stats.frees = state.retiredFrees;
+    for(ThreadCache *cache : state.threadCaches){
+        stats.allocations += cache->allocations.load(std::memory_order_relaxed);
+        stats.frees += cache->frees.load(std::memory_order_relaxed);
+    }
+    stats.systemAllocations = state.systemAllocations.load(std::memory_order_relaxed);
+    stats.slabCount = state.slabCount.load(std::memory_order_relaxed);
+
+    return stats;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <typeinfo>
+
+namespace Volume
+{
+	struct VoxelAllocatorStats {
+		uint64_t allocations = 0;		// voxels handed out by the allocator
+		uint64_t frees = 0;				// voxels returned to the allocator
+		uint64_t systemAllocations = 0;	// calls into the system allocator (new slabs and oversized voxels)
+		uint64_t slabCount = 0;			// slabs owned by all pools
+
+		uint64_t Alive() const { return allocations - frees; }
+	};
+
+	/// @brief Slab pool allocator used by every `VoxelElement` (and everything inheriting from it)
+	/// @note Every voxel type created through the registry (`CreateVoxelElement` and voxel factories using
+	/// `Volume::NewVoxel`) gets a pool of its own. Voxels created with plain `new` share pools keyed by
+	/// size class (the size rounded up to `BLOCK_ALIGNMENT`). Freed blocks go to a thread-local free list
+	/// first and only touch the shared pool in batches
+	class VoxelAllocator {
+	public:
+		using PoolID = uint16_t;
+
+		/// @brief Allocates from the size class pool of `size`
+		static void* Allocate(size_t size);
+		/// @brief Allocates from a pool returned by `PoolOf` or `RegisterPool`
+		static void* Allocate(size_t size, PoolID pool);
+		/// @brief Returns the block to the pool it was allocated from
+		static void Free(void *ptr, size_t size);
+		/// @brief Same as `Free` for blocks from `Allocate(size, pool)` when the size is not known
+		static void FreeToPool(void *ptr, PoolID pool);
+
+		/// @brief Bytes taken by a live block, the block size of its pool or the size of an oversized voxel
+		static size_t BlockSizeOf(const void *ptr);
+
+		/// @brief Pool of the voxel type `T`, registered on first use
+		template<typename T>
+		static PoolID PoolOf()
+		{
+			static const PoolID pool = RegisterPool(sizeof(T), typeid(T).name());
+			return pool;
+		}
+		/// @brief Creates a pool for blocks of `blockSize`
+		/// @return the size class pool of `blockSize` once all `MAX_TYPED_POOLS` are taken,
+		/// `SYSTEM_POOL` if `blockSize` is over `MAX_POOLED_SIZE`
+		static PoolID RegisterPool(size_t blockSize, const char *name);
+
+		/// @brief Pre-allocates blocks in the pool so the simulation does not have to
+		static void Reserve(PoolID pool, size_t count);
+
+		static VoxelAllocatorStats GetStats();
+
+		static constexpr size_t BLOCK_ALIGNMENT = 16;
+		static constexpr size_t MAX_POOLED_SIZE = 512; // bigger voxels fall back to the system allocator
+		static constexpr size_t SLAB_SIZE = 64 * 1024; // slabs are aligned to their size, the header names the pool
+		static constexpr size_t SIZE_CLASS_COUNT = MAX_POOLED_SIZE / BLOCK_ALIGNMENT;
+		static constexpr size_t MAX_TYPED_POOLS = 64;
+		static constexpr size_t MAX_POOLS = SIZE_CLASS_COUNT + MAX_TYPED_POOLS;
+		static constexpr PoolID SYSTEM_POOL = MAX_POOLS; // not a real pool, blocks come from the system allocator
+	};
+}
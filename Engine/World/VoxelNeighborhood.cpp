@@ -0,0 +1,133 @@
+#include "World/VoxelNeighborhood.h"
+
+#include <algorithm>
+#include <cassert>
+
+#include "World/ChunkMatrix.h"
+
+using namespace Volume;
+
+VoxelNeighborhood::VoxelNeighborhood(ChunkMatrix *matrix, VoxelElement *voxel)
+    : matrix(matrix), voxel(voxel)
+{
+    Chunk *center = matrix->GetChunkAtWorldPosition(voxel->position);
+    if(!center) return; // everything goes through the matrix
+
+    Vec2i chunkPos = center->GetPos();
+    this->originX = chunkPos.x * Chunk::CHUNK_SIZE;
+    this->originY = chunkPos.y * Chunk::CHUNK_SIZE;
+
+    this->chunks[4] = center;
+    this->chunks[1] = center->GetNeighbor(ChunkNeighbor::Up);
+    this->chunks[7] = center->GetNeighbor(ChunkNeighbor::Down);
+    this->chunks[3] = center->GetNeighbor(ChunkNeighbor::Left);
+    this->chunks[5] = center->GetNeighbor(ChunkNeighbor::Right);
+    this->chunks[0] = center->GetNeighbor(ChunkNeighbor::UpLeft);
+    this->chunks[2] = center->GetNeighbor(ChunkNeighbor::UpRight);
+    this->chunks[6] = center->GetNeighbor(ChunkNeighbor::DownLeft);
+    this->chunks[8] = center->GetNeighbor(ChunkNeighbor::DownRight);
+
+    // compressed chunks have no voxels to hand out, the matrix expands them on first access
+    for(Chunk *&chunk : this->chunks)
+        if(chunk && chunk->IsCompressed()) chunk = nullptr;
+}
+
+Chunk *VoxelNeighborhood::GetChunk(int dx, int dy) const
+{
+    Chunk *chunk;
+    int localX, localY;
+    if(Resolve(voxel->position.x + dx, voxel->position.y + dy, chunk, localX, localY))
+        return chunk;
+
+    return matrix->GetChunkAtWorldPosition(Vec2i(voxel->position.x + dx, voxel->position.y + dy));
+}
+
+VoxelElement *VoxelNeighborhood::GetAtFallback(int worldX, int worldY, bool load) const
+{
+    if(load)
+        return matrix->VirtualGetAt(Vec2i(worldX, worldY));
+    
+    return matrix->VirtualGetAt_NoLoad(Vec2i(worldX, worldY));
+}
+
+void VoxelNeighborhood::SwapWith(int worldX, int worldY)
+{
+    VoxelElement *swapVoxel = this->GetAt(worldX, worldY, true);
+
+    if (!swapVoxel || swapVoxel->id == Materials::Empty) return;
+
+	const Registry::MaterialTable &materials = Registry::VoxelRegistry::GetMaterialTable();
+	const float heatCapacity = materials.heatCapacity[voxel->id];
+	const float swapHeatCapacity = materials.heatCapacity[swapVoxel->id];
+
+	//transfer heat between the two voxels
+	float heatDifference = voxel->temperature.GetCelsius() - swapVoxel->temperature.GetCelsius();
+	float maxHeatTransfer = 500;
+	float heatTransfer = std::clamp(
+		heatDifference * materials.heatConductivity[voxel->id] * 5,
+		-maxHeatTransfer,
+		maxHeatTransfer
+	);
+
+	bool anyHeatCapacityZero = heatCapacity == 0 || swapHeatCapacity == 0;
+
+	// kept to undo the swap if one of the writes below is dropped
+	const Vec2i position = voxel->position;
+	const Temperature temperature = voxel->temperature;
+	const Temperature swapTemperature = swapVoxel->temperature;
+	
+	if(!anyHeatCapacityZero){
+		voxel->temperature.SetCelsius(voxel->temperature.GetCelsius() - heatTransfer / heatCapacity);
+		swapVoxel->temperature.SetCelsius(swapVoxel->temperature.GetCelsius() + heatTransfer / swapHeatCapacity);
+	}
+
+    //flip positions
+    swapVoxel->position = voxel->position;
+    voxel->position = Vec2i(worldX, worldY);
+
+    // both positions were just read from loaded chunks, so the writes should never be dropped.
+    // If one is anyway, put both voxels back where they were instead of losing one from the grid
+    if(!this->SetAt_NoDelete(voxel)){
+        voxel->position = position;
+        swapVoxel->position = Vec2i(worldX, worldY);
+        voxel->temperature = temperature;
+        swapVoxel->temperature = swapTemperature;
+        assert(false && "swap target could not be written");
+        return;
+    }
+    if(!this->SetAt_NoDelete(swapVoxel)){
+        voxel->position = position;
+        swapVoxel->position = Vec2i(worldX, worldY);
+        voxel->temperature = temperature;
+        swapVoxel->temperature = swapTemperature;
+
+        // the old slot still holds `voxel`, only the target has to be restored
+        [[maybe_unused]] bool restored = this->SetAt_NoDelete(swapVoxel);
+        assert(restored && "swap could not be undone");
+        assert(false && "swap source could not be written");
+    }
+}
+
+/// @brief Same as `ChunkMatrix::VirtualSetAt_NoDelete` without voxel objects
+/// @return false if the voxel was not placed, the caller still owns it
+bool VoxelNeighborhood::SetAt_NoDelete(VoxelElement *element)
+{
+    Chunk *chunk;
+    int localX, localY;
+    if(!Resolve(element->position.x, element->position.y, chunk, localX, localY))
+        return matrix->VirtualSetAt_NoDelete(element);
+
+    VoxelElement *&slot = chunk->voxels[localY][localX];
+
+    // update physics if changing a solid voxel
+    if(element->ShouldTriggerDirtyColliders() || slot->ShouldTriggerDirtyColliders())
+        chunk->dirtyColliders = true;
+
+    element->SetPartOfObject(false);
+    slot = element;
+
+    Vec2i localPos = Vec2i(localX, localY);
+    chunk->dirtyTiles.Include(localPos);
+    chunk->UpdatedVoxelAt(localPos);
+    return true;
+}
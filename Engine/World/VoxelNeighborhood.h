@@ -0,0 +1,121 @@
+#pragma once
+
+#include "World/Chunk.h"
+
+class ChunkMatrix;
+
+namespace Volume
+{
+	/// @brief Material and flags of a voxel read from the dense chunk storage, without touching the voxel
+	struct VoxelProbe {
+		MaterialID material = INVALID_MATERIAL_ID; // INVALID_MATERIAL_ID if there is no voxel
+		uint8_t flags = 0; // see `Volume::VoxelFlags`
+
+		bool Exists() const { return material != INVALID_MATERIAL_ID; }
+		State GetState() const { return static_cast<State>(flags & VoxelFlags::STATE_MASK); }
+		bool IsStatic() const { return flags & VoxelFlags::STATIC; }
+
+		/// @brief Same as `VoxelElement::IsStateBelowDensity`
+		bool IsStateBelowDensity(State state, float density) const
+		{
+			return GetState() == state && Registry::VoxelRegistry::GetMaterialTable().density[material] < density;
+		}
+		/// @brief Same as `VoxelElement::IsStateAboveDensity`
+		bool IsStateAboveDensity(State state, float density) const
+		{
+			return GetState() == state && Registry::VoxelRegistry::GetMaterialTable().density[material] > density;
+		}
+	};
+
+	/// @brief Cursor over the chunk of a voxel and its 8 neighbours, meant to be created at the start of `Step`
+	/// @note Offsets are relative to the voxel's current position, so the cursor keeps working after the
+	/// voxel swaps itself. Only positions outside of the cached 3x3 chunks fall back to the `ChunkMatrix`
+	class VoxelNeighborhood {
+	public:
+		VoxelNeighborhood(ChunkMatrix *matrix, VoxelElement *voxel);
+
+		/// @brief Same as `ChunkMatrix::VirtualGetAt` (may load chunks) relative to the voxel
+		VoxelElement* Get(int dx, int dy) const { return GetAt(voxel->position.x + dx, voxel->position.y + dy, true); }
+		/// @brief Same as `ChunkMatrix::VirtualGetAt_NoLoad` relative to the voxel
+		VoxelElement* Get_NoLoad(int dx, int dy) const { return GetAt(voxel->position.x + dx, voxel->position.y + dy, false); }
+		VoxelElement* GetAt(const Vec2i &worldPos) const { return GetAt(worldPos.x, worldPos.y, true); }
+
+		/// @brief Material and state of the voxel at the offset, the dense storage holds them for every loaded voxel
+		/// @note Use it for checks and only `Get` the voxels that get read or changed further
+		VoxelProbe Probe(int dx, int dy) const { return ProbeAt(voxel->position.x + dx, voxel->position.y + dy, true); }
+		VoxelProbe Probe_NoLoad(int dx, int dy) const { return ProbeAt(voxel->position.x + dx, voxel->position.y + dy, false); }
+
+		/// @brief Returns the chunk holding the position at the offset
+		Chunk* GetChunk(int dx, int dy) const;
+
+		/// @brief Swaps the voxel with the one at the offset, exchanging heat like `VoxelElement::Swap`
+		void Swap(int dx, int dy) { SwapWith(voxel->position.x + dx, voxel->position.y + dy); }
+		void SwapWith(const Vec2i &worldPos) { SwapWith(worldPos.x, worldPos.y); }
+
+		ChunkMatrix* GetMatrix() const { return matrix; }
+	private:
+		/// @brief Finds the cached chunk and local position for a world position
+		/// @return false if the position is outside of the cached chunks
+		bool Resolve(int worldX, int worldY, Chunk *&chunk, int &localX, int &localY) const
+		{
+			const int relativeX = worldX - originX + Chunk::CHUNK_SIZE;
+			const int relativeY = worldY - originY + Chunk::CHUNK_SIZE;
+			if(static_cast<unsigned>(relativeX) >= 3 * Chunk::CHUNK_SIZE ||
+			   static_cast<unsigned>(relativeY) >= 3 * Chunk::CHUNK_SIZE) return false;
+
+			chunk = chunks[(relativeY / Chunk::CHUNK_SIZE) * 3 + relativeX / Chunk::CHUNK_SIZE];
+			if(!chunk) return false;
+
+			localX = relativeX % Chunk::CHUNK_SIZE;
+			localY = relativeY % Chunk::CHUNK_SIZE;
+			return true;
+		}
+
+		VoxelElement* GetAt(int worldX, int worldY, bool load) const;
+		VoxelElement* GetAtFallback(int worldX, int worldY, bool load) const;
+		VoxelProbe ProbeAt(int worldX, int worldY, bool load) const;
+		void SwapWith(int worldX, int worldY);
+		bool SetAt_NoDelete(VoxelElement *element);
+
+		ChunkMatrix *matrix;
+		VoxelElement *voxel;
+
+		// world position of the top left voxel of the centre chunk
+		int originX = 0;
+		int originY = 0;
+		// 3x3 chunks around the voxel, row major with the voxel's chunk in the middle
+		Chunk *chunks[9] = {};
+	};
+
+	inline VoxelElement* VoxelNeighborhood::GetAt(int worldX, int worldY, bool load) const
+	{
+		Chunk *chunk;
+		int localX, localY;
+		if(!Resolve(worldX, worldY, chunk, localX, localY))
+			return GetAtFallback(worldX, worldY, load);
+
+		VoxelElement *element = chunk->voxels[localY][localX];
+		if(!element) return nullptr;
+
+		chunk->lastCheckedCountDown = 20;
+		return element;
+	}
+
+	inline VoxelProbe VoxelNeighborhood::ProbeAt(int worldX, int worldY, bool load) const
+	{
+		Chunk *chunk;
+		int localX, localY;
+		if(!Resolve(worldX, worldY, chunk, localX, localY)){
+			VoxelElement *element = GetAtFallback(worldX, worldY, load);
+			if(!element) return VoxelProbe();
+			return VoxelProbe{ element->id, ChunkVoxelStorage::FlagsOf(element) };
+		}
+
+		// cached chunks are never compressed, their storage is always there
+		const ChunkVoxelStorage &storage = chunk->GetVoxelStorage();
+		const uint16_t index = ChunkVoxelStorage::Index(localX, localY);
+
+		chunk->lastCheckedCountDown = 20;
+		return VoxelProbe{ storage.materialId[index], storage.flags[index] };
+	}
+}
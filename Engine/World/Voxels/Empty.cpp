@@ -1,18 +1,24 @@
 #include "World/Voxels/Empty.h"
 #include "World/ChunkMatrix.h"
+#include "World/VoxelNeighborhood.h"
 
 #include <iostream>
 
 using namespace Volume;
 
 EmptyVoxel::EmptyVoxel(Vec2i position)
-    : VoxelElement("Empty", position, Temperature(0), 0) {  };
+    : VoxelElement(Materials::Empty, position, Temperature(0), 0) {  };
 
 bool EmptyVoxel::Step(ChunkMatrix* matrix){
+    VoxelNeighborhood neighborhood(matrix, this);
+
     // Search for nearby voxels to fill the empty space
     for(Vec2i dir : vector::AROUND8){
-        VoxelElement* next = matrix->VirtualGetAt_NoLoad(this->position + dir);
-        if(next && next->GetState() == State::Gas && next->properties != this->properties && next->amount > VoxelGas::MinimumGasAmount){
+        VoxelProbe probe = neighborhood.Probe_NoLoad(dir.x, dir.y);
+        if(!probe.Exists() || probe.GetState() != State::Gas || probe.material == this->id) continue;
+
+        VoxelElement* next = neighborhood.Get_NoLoad(dir.x, dir.y);
+        if(next->amount > VoxelGas::MinimumGasAmount){
             // Fill the empty space with the found voxel)
             float movedAmount = next->amount / 4.0f;
             matrix->PlaceVoxelAt(this->position, next->id, next->temperature, false, movedAmount, true);